@@ -10,6 +10,11 @@
 #include "LoadSpriteDef.h"
 #include "MoveSpriteDef.h"
 #include "AseCommands.h"
+#include "AseDmaWriter.h"
+
+#if defined(ASE_EMULATOR)
+#include "AseEmulatorBus.h"
+#endif
 
 
 /**
@@ -39,11 +44,17 @@ class AseAccessMode {
     uint32_t _busOutputRegister;
     GpioPinRef _busyPin;
     GpioPinRef _fpgaResetPin;
+    AseDmaWriter *_dmaWriter;
+
+  protected:
+    void waitDma() const;
+    void writeSpriteRecord(const LoadSpriteDef& sd) const;
     
   public:
     AseAccessMode();
     void reset();
     void resetFpga() const;
+    void setDmaWriter(AseDmaWriter *writer);
 
     void writeCommand(uint16_t command) const;
     void writeCommand(uint16_t command,uint16_t parameter) const;
@@ -53,16 +64,22 @@ class AseAccessMode {
     uint16_t readData() const;
 
     void writeFpgaCommand(uint16_t value) const;
+    void writeEncoded(const uint16_t *encoded,uint32_t numWords) const;
 
     void rawTransfer(const void *buffer,uint32_t numWords) const;
 
     void loadSprite(const LoadSpriteDef& sd) const;
+    void loadSprites(const LoadSpriteDef *sd,uint16_t count) const;
     void moveSprite(const MoveSpriteDef& md) const;
     void hideSprite(uint16_t spriteNumber) const;
-    void showSprite(uint16_t spriteNumber) const;
+    void showSprite(uint16_t spriteNumber,bool persistent=false) const;
+    void setViewportOffset(uint16_t x,uint16_t y) const;
+    void setLastSprite(uint16_t spriteNumber) const;
+    void loadPalette(const uint16_t *colours,uint16_t first,uint16_t count) const;
     void spriteMode() const;
     void waitBusyEnd() const;
     void waitBusyStart() const;
+    bool isBusy() const;
 };
 
 
@@ -70,7 +87,8 @@ class AseAccessMode {
  * Constructor
  */
 
-inline AseAccessMode::AseAccessMode() {
+inline AseAccessMode::AseAccessMode()
+  : _dmaWriter(nullptr) {
 
   // initialise and remember the busy pin
 
@@ -99,6 +117,27 @@ inline AseAccessMode::AseAccessMode() {
 }
 
 
+/**
+ * Send passthrough pixel transfers through a DMA writer. rawTransfer() and writeMultiData() use it
+ * for MIN_PIXELS or more and everything else that writes to the panel waits for it to finish first.
+ * @param writer The writer, or nullptr to go back to writing with the CPU
+ */
+
+inline void AseAccessMode::setDmaWriter(AseDmaWriter *writer) {
+  _dmaWriter=writer;
+}
+
+
+/**
+ * Wait for a DMA transfer to finish before anything else goes on the bus
+ */
+
+inline void AseAccessMode::waitDma() const {
+  if(_dmaWriter)
+    _dmaWriter->wait();
+}
+
+
 /**
  * Hard-reset the panel
  */
@@ -130,6 +169,14 @@ inline void AseAccessMode::reset() {
 
 inline void AseAccessMode::writeFpgaCommand(uint16_t value) const {
 
+#if defined(ASE_EMULATOR)
+
+  // host build: the word goes to the emulated FPGA
+
+  AseEmulatorBus::write(value);
+
+#else
+
   // 20ns low, 20ns high = 25MHz max toggle rate
 
   __asm volatile(
@@ -150,6 +197,60 @@ inline void AseAccessMode::writeFpgaCommand(uint16_t value) const {
        [value_high] "l" (value | 0x400),        // input value (WR = 1)
        [data]       "l" (_busOutputRegister)    // the bus
   );
+
+#endif
+}
+
+
+/**
+ * Write a burst of pre-encoded bus words to the FPGA. Each word is a pair of halfwords that
+ * are the port E values with WR low and WR high. The timing of each word is the same as
+ * writeFpgaCommand() but there's no per-word call or encoding overhead. See AseCommandBuffer.
+ * @param encoded The halfword pairs
+ * @param numWords The number of pairs
+ */
+
+inline void AseAccessMode::writeEncoded(const uint16_t *encoded,uint32_t numWords) const {
+
+#if defined(ASE_EMULATOR)
+
+  // host build: the burst goes to the emulated FPGA
+
+  AseEmulatorBus::writeEncoded(encoded,numWords);
+
+#else
+
+  const uint16_t *end=encoded+numWords*2;
+
+  __asm volatile(
+    " cmp   %[ptr], %[end]            \n\t"     // nothing to do?
+    " beq   2f                        \n\t"
+    "1:                               \n\t"
+    " ldrh  r4, [%[ptr]], #2          \n\t"     // r4 = value (WR = 0)
+    " ldrh  r5, [%[ptr]], #2          \n\t"     // r5 = value (WR = 1)
+    " str   r4,  [%[data]]            \n\t"     // port <= value (WR = 0)
+    " dsb                             \n\t"     // synchronise data
+    " str   r4,  [%[data]]            \n\t"     // port <= value (WR = 0)
+    " dsb                             \n\t"     // synchronise data
+    " str   r4,  [%[data]]            \n\t"     // port <= value (WR = 0)
+    " dsb                             \n\t"     // synchronise data
+    " str   r5,  [%[data]]            \n\t"     // port <= value (WR = 1)
+    " dsb                             \n\t"     // synchronise data
+    " str   r5,  [%[data]]            \n\t"     // port <= value (WR = 1)
+    " dsb                             \n\t"     // synchronise data
+    " str   r5,  [%[data]]            \n\t"     // port <= value (WR = 1)
+    " dsb                             \n\t"     // synchronise data
+    " cmp   %[ptr], %[end]            \n\t"     // more to do?
+    " bne   1b                        \n\t"
+    "2:                               \n\t"
+
+    : [ptr]  "+l" (encoded)                     // the encoded words
+    : [end]  "l"  (end),                        // one past the last word
+      [data] "l"  (_busOutputRegister)          // the bus
+    : "r4","r5","cc","memory"
+  );
+
+#endif
 }
 
 
@@ -160,6 +261,7 @@ inline void AseAccessMode::writeFpgaCommand(uint16_t value) const {
 
 inline void AseAccessMode::writeCommand(uint16_t value) const {
 
+  waitDma();
   writeFpgaCommand(value & 0xff);
   writeFpgaCommand(value >> 8);
 }
@@ -172,6 +274,7 @@ inline void AseAccessMode::writeCommand(uint16_t value) const {
 
 inline void AseAccessMode::writeData(uint16_t value) const {
 
+  waitDma();
   writeFpgaCommand(value & 0xff);
   writeFpgaCommand((value >> 8) | 0x200);     // RS = 1
 }
@@ -190,13 +293,18 @@ inline void AseAccessMode::writeCommand(uint16_t command,uint16_t parameter) con
 
 
 /**
- * Write multiple data. A possible optimisation point that we can't take advantage of
- * in this access mode
+ * Write multiple data. With a DMA writer this returns as soon as the transfer has started.
  * @param howMuch How many pixels
  * @param value The pixel
  */
 
 inline void AseAccessMode::writeMultiData(uint32_t howMuch,uint16_t value) const {
+
+  if(_dmaWriter && howMuch>=AseDmaWriter::MIN_PIXELS) {
+    _dmaWriter->fill(value,howMuch);
+    return;
+  }
+
   while(howMuch--)
     writeData(value);
 }
@@ -232,6 +340,13 @@ inline void AseAccessMode::rawTransfer(const void *buffer,uint32_t numWords) con
 
   const uint16_t *ptr=static_cast<const uint16_t *>(buffer);
 
+  // the DMA writer returns when the buffer has been read
+
+  if(_dmaWriter && numWords>=AseDmaWriter::MIN_PIXELS) {
+    _dmaWriter->rawTransfer(ptr,numWords);
+    return;
+  }
+
   // shift all the pixels
 
   while(numWords--)
@@ -248,6 +363,53 @@ inline void AseAccessMode::loadSprite(const LoadSpriteDef& sd) const {
 
   writeFpgaCommand(AseCommands::CMD_LOAD);
   writeFpgaCommand(sd.SpriteNumber);                // sprite number
+  writeSpriteRecord(sd);
+}
+
+
+/**
+ * Load a table of sprite definitions into the FPGA. Each run of consecutive sprite numbers is
+ * sent as one CMD_LOAD_BLOCK, which saves the command and sprite number words of every record
+ * after the first. A sprite on its own is sent as a CMD_LOAD.
+ * @param sd The sprite definitions
+ * @param count The number of definitions
+ */
+
+inline void AseAccessMode::loadSprites(const LoadSpriteDef *sd,uint16_t count) const {
+
+  uint16_t run,i;
+
+  while(count) {
+
+    // find the run of consecutive sprite numbers, at most the 512 that the count can hold
+
+    for(run=1;run<count && run<512 && sd[run].SpriteNumber==sd[run-1].SpriteNumber+1;run++);
+
+    if(run==1)
+      loadSprite(*sd);
+    else {
+
+      writeFpgaCommand(AseCommands::CMD_LOAD_BLOCK);
+      writeFpgaCommand(sd->SpriteNumber);           // first sprite number
+      writeFpgaCommand(run-1);                      // count less one
+
+      for(i=0;i<run;i++)
+        writeSpriteRecord(sd[i]);
+    }
+
+    sd+=run;
+    count-=run;
+  }
+}
+
+
+/**
+ * Write the parameters of a CMD_LOAD that follow the sprite number
+ * @param sd The sprite definition structure
+ */
+
+inline void AseAccessMode::writeSpriteRecord(const LoadSpriteDef& sd) const {
+
   writeFpgaCommand(sd.SramAddress & 0x3ff);         // addr-low
   writeFpgaCommand(sd.SramAddress >> 10);           // addr-high
   writeFpgaCommand(sd.PixelWidth);                  // pixel width
@@ -258,7 +420,7 @@ inline void AseAccessMode::loadSprite(const LoadSpriteDef& sd) const {
   writeFpgaCommand(sd.FlashAddress >> 16);          // flash high
   writeFpgaCommand(sd.RepeatX);                     // repeat x
   writeFpgaCommand(sd.RepeatY);                     // repeat y
-  writeFpgaCommand(sd.Visible);                     // visible
+  writeFpgaCommand(sd.Visible | (sd.Persistent << 1) | (sd.Mirror << 2) | (sd.Indexed << 3) | (sd.Spans << 4));    // flags
   writeFpgaCommand(sd.FirstX);                      // first X column
   writeFpgaCommand(sd.LastX);                       // last X column
   writeFpgaCommand(sd.FirstY);                      // first Y row
@@ -271,6 +433,7 @@ inline void AseAccessMode::loadSprite(const LoadSpriteDef& sd) const {
  */
 
 inline void AseAccessMode::spriteMode() const {
+  waitDma();
   writeFpgaCommand(AseCommands::CMD_SPRITE);
 }
 
@@ -293,6 +456,16 @@ inline void AseAccessMode::waitBusyStart() const {
 }
 
 
+/**
+ * Check if the FPGA is drawing. BRAM writes are lost while it is.
+ * @return The state of the BUSY pin
+ */
+
+inline bool AseAccessMode::isBusy() const {
+  return _busyPin.read();
+}
+
+
 /**
  * Reset the FPGA
  */
@@ -343,9 +516,60 @@ inline void AseAccessMode::hideSprite(uint16_t spriteNumber) const {
 /**
  * Show a sprite
  * @param spriteNumber The sprite to show
+ * @param persistent true to set the persistent flag, false to clear it
  */
 
-inline void AseAccessMode::showSprite(uint16_t spriteNumber) const {
-  writeFpgaCommand(AseCommands::CMD_SHOW);
+inline void AseAccessMode::showSprite(uint16_t spriteNumber,bool persistent) const {
+  writeFpgaCommand(persistent ? AseCommands::CMD_SHOW_PERSISTENT : AseCommands::CMD_SHOW);
   writeFpgaCommand(spriteNumber);             // sprite number
 }
+
+
+/**
+ * Set the viewport offset that's subtracted from every sprite's SRAM position
+ * @param x The world X coordinate that will appear at the left of the screen
+ * @param y The world Y coordinate that will appear at the top of the screen
+ */
+
+inline void AseAccessMode::setViewportOffset(uint16_t x,uint16_t y) const {
+
+  uint32_t offset;
+
+  offset=(static_cast<uint32_t>(y)*360+x) & 0x3ffff;
+
+  writeFpgaCommand(AseCommands::CMD_OFFSET);
+  writeFpgaCommand(offset & 0x3ff);           // offset (lo 10)
+  writeFpgaCommand(offset >> 10);             // offset (hi 8)
+}
+
+
+/**
+ * Set the last sprite record that the sprite writer reads in each pass
+ * @param spriteNumber The highest visible sprite
+ */
+
+inline void AseAccessMode::setLastSprite(uint16_t spriteNumber) const {
+  writeFpgaCommand(AseCommands::CMD_LAST_SPRITE);
+  writeFpgaCommand(spriteNumber);             // sprite number
+}
+
+
+/**
+ * Load entries into the palette used by indexed sprites. The FPGA drops palette writes made while
+ * it's busy so call this when BUSY is low, for example straight after entering sprite mode.
+ * @param colours The 16-bit colours
+ * @param first The first palette index to write
+ * @param count The number of colours (1..256), first+count must not be more than 256
+ */
+
+inline void AseAccessMode::loadPalette(const uint16_t *colours,uint16_t first,uint16_t count) const {
+
+  writeFpgaCommand(AseCommands::CMD_PALETTE);
+  writeFpgaCommand(first);                    // first index
+  writeFpgaCommand(count-1);                  // count less one
+
+  while(count--) {
+    writeFpgaCommand(*colours & 0xff);        // colour low
+    writeFpgaCommand(*colours++ >> 8);        // colour high
+  }
+}
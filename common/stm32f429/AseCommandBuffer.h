@@ -0,0 +1,151 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+#include "AseCommandEncoder.h"
+
+
+/**
+ * A display list of sprite commands that have already been encoded as port E values. Each
+ * 10-bit bus word is stored as a pair of halfwords: the value with WR low and the same value
+ * with WR high (bit 10). The game builds the list with no bus access at all and then the whole
+ * thing is sent to the FPGA in one tight burst by AseAccessMode::writeEncoded() right after
+ * BUSY falls.
+ *
+ * Commands are added through AseCommandEncoder and are never split. If there isn't room for all
+ * of a command then none of it is added and the overflow flag is set.
+ *
+ * @tparam TMaxWords The capacity in bus words.
+ */
+
+template<uint16_t TMaxWords>
+class AseCommandBuffer : public AseCommandEncoder<AseCommandBuffer<TMaxWords>> {
+
+  protected:
+    uint16_t _encoded[TMaxWords*2];
+    uint16_t *_next;
+    bool _overflow;
+
+  protected:
+    bool reserve(uint16_t numWords);
+    void encode(uint16_t value);
+
+    friend class AseCommandEncoder<AseCommandBuffer<TMaxWords>>;
+
+  public:
+    AseCommandBuffer();
+
+    void clear();
+
+    void flush(const AseAccessMode& accessMode);
+
+    const uint16_t *getEncoded() const;
+    uint16_t getWordCount() const;
+    bool isOverflowed() const;
+};
+
+
+/**
+ * Constructor
+ */
+
+template<uint16_t TMaxWords>
+inline AseCommandBuffer<TMaxWords>::AseCommandBuffer() {
+  clear();
+}
+
+
+/**
+ * Empty the buffer and reset the overflow flag
+ */
+
+template<uint16_t TMaxWords>
+inline void AseCommandBuffer<TMaxWords>::clear() {
+  _next=_encoded;
+  _overflow=false;
+}
+
+
+/**
+ * Check that there's space for a command
+ * @param numWords The number of bus words in the command
+ * @return true if there's space
+ */
+
+template<uint16_t TMaxWords>
+inline bool AseCommandBuffer<TMaxWords>::reserve(uint16_t numWords) {
+
+  if(_next+numWords*2>_encoded+TMaxWords*2) {
+    _overflow=true;
+    return false;
+  }
+
+  return true;
+}
+
+
+/**
+ * Encode a 10-bit bus word as the WR low, WR high pair
+ * @param value The bus word
+ */
+
+template<uint16_t TMaxWords>
+inline void AseCommandBuffer<TMaxWords>::encode(uint16_t value) {
+
+  value&=0x3ff;
+
+  *_next++=value;             // WR = 0
+  *_next++=value | 0x400;     // WR = 1
+}
+
+
+/**
+ * Send the buffer to the FPGA and empty it. The overflow flag is left alone so that
+ * the caller can check it afterwards.
+ * @param accessMode The access mode to write with
+ */
+
+template<uint16_t TMaxWords>
+inline void AseCommandBuffer<TMaxWords>::flush(const AseAccessMode& accessMode) {
+
+  accessMode.writeEncoded(_encoded,getWordCount());
+  _next=_encoded;
+}
+
+
+/**
+ * Get the encoded halfword pairs
+ * @return A pointer to the first pair
+ */
+
+template<uint16_t TMaxWords>
+inline const uint16_t *AseCommandBuffer<TMaxWords>::getEncoded() const {
+  return _encoded;
+}
+
+
+/**
+ * Get the number of bus words in the buffer
+ * @return The word count. There are twice as many halfwords.
+ */
+
+template<uint16_t TMaxWords>
+inline uint16_t AseCommandBuffer<TMaxWords>::getWordCount() const {
+  return (_next-_encoded)/2;
+}
+
+
+/**
+ * Check if a command was dropped because the buffer was full
+ * @return true if it was
+ */
+
+template<uint16_t TMaxWords>
+inline bool AseCommandBuffer<TMaxWords>::isOverflowed() const {
+  return _overflow;
+}
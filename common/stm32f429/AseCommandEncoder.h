@@ -0,0 +1,223 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/**
+ * The sprite commands as sequences of 10-bit bus words. The same words are written by
+ * AseAccessMode. The class that derives from this stores them and must provide:
+ *
+ *   bool reserve(uint16_t numWords): make room for a whole command or return false
+ *   void encode(uint16_t value):     add a bus word to the room that was made
+ *
+ * Commands are never split. If reserve() fails then none of the command is added.
+ *
+ * @tparam TStorage The derived class
+ */
+
+template<class TStorage>
+class AseCommandEncoder {
+
+  protected:
+    TStorage& storage();
+
+  public:
+    bool loadSprite(const LoadSpriteDef& sd);
+    bool moveSprite(uint16_t spriteNumber,uint32_t sramAddress);
+    bool moveSprite(const MoveSpriteDef& md);
+    bool showSprite(uint16_t spriteNumber,bool persistent=false);
+    bool hideSprite(uint16_t spriteNumber);
+    bool setViewportOffset(uint16_t x,uint16_t y);
+    bool setLastSprite(uint16_t spriteNumber);
+};
+
+
+/**
+ * Get the derived class that stores the words
+ */
+
+template<class TStorage>
+inline TStorage& AseCommandEncoder<TStorage>::storage() {
+  return static_cast<TStorage&>(*this);
+}
+
+
+/**
+ * Add a CMD_LOAD. The parameters are the same as AseAccessMode::loadSprite().
+ * @param sd The sprite definition structure
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::loadSprite(const LoadSpriteDef& sd) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(17))
+    return false;
+
+  s.encode(AseCommands::CMD_LOAD);
+  s.encode(sd.SpriteNumber);
+  s.encode(sd.SramAddress & 0x3ff);
+  s.encode(sd.SramAddress >> 10);
+  s.encode(sd.PixelWidth);
+  s.encode(sd.NumPixels & 0x3ff);
+  s.encode(sd.NumPixels >> 10);
+  s.encode(sd.FlashAddress & 0xff);
+  s.encode((sd.FlashAddress >> 8) & 0xff);
+  s.encode(sd.FlashAddress >> 16);
+  s.encode(sd.RepeatX);
+  s.encode(sd.RepeatY);
+  s.encode(sd.Visible | (sd.Persistent << 1) | (sd.Mirror << 2) | (sd.Indexed << 3) | (sd.Spans << 4));
+  s.encode(sd.FirstX);
+  s.encode(sd.LastX);
+  s.encode(sd.FirstY);
+  s.encode(sd.LastY);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_MOVE. The clipping rectangle is not changed.
+ * @param spriteNumber The sprite to move
+ * @param sramAddress The new pixel address
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::moveSprite(uint16_t spriteNumber,uint32_t sramAddress) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(4))
+    return false;
+
+  s.encode(AseCommands::CMD_MOVE);
+  s.encode(spriteNumber);
+  s.encode(sramAddress & 0x3ff);
+  s.encode(sramAddress >> 10);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_MOVE_PARTIAL
+ * @param md The move definition
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::moveSprite(const MoveSpriteDef& md) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(8))
+    return false;
+
+  s.encode(AseCommands::CMD_MOVE_PARTIAL);
+  s.encode(md.SpriteNumber);
+  s.encode(md.SramAddress & 0x3ff);
+  s.encode(md.SramAddress >> 10);
+  s.encode(md.FirstX);
+  s.encode(md.LastX);
+  s.encode(md.FirstY);
+  s.encode(md.LastY);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_SHOW or CMD_SHOW_PERSISTENT
+ * @param spriteNumber The sprite to show
+ * @param persistent true to set the persistent flag, false to clear it
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::showSprite(uint16_t spriteNumber,bool persistent) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(2))
+    return false;
+
+  s.encode(persistent ? AseCommands::CMD_SHOW_PERSISTENT : AseCommands::CMD_SHOW);
+  s.encode(spriteNumber);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_HIDE
+ * @param spriteNumber The sprite to hide
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::hideSprite(uint16_t spriteNumber) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(2))
+    return false;
+
+  s.encode(AseCommands::CMD_HIDE);
+  s.encode(spriteNumber);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_OFFSET. The parameters are the same as AseAccessMode::setViewportOffset().
+ * @param x The world X coordinate at the left of the screen
+ * @param y The world Y coordinate at the top of the screen
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::setViewportOffset(uint16_t x,uint16_t y) {
+
+  TStorage& s(storage());
+  uint32_t offset;
+
+  if(!s.reserve(3))
+    return false;
+
+  offset=(static_cast<uint32_t>(y)*360+x) & 0x3ffff;
+
+  s.encode(AseCommands::CMD_OFFSET);
+  s.encode(offset & 0x3ff);
+  s.encode(offset >> 10);
+
+  return true;
+}
+
+
+/**
+ * Add a CMD_LAST_SPRITE
+ * @param spriteNumber The last sprite record that the sprite writer should read
+ * @return false if there's no room
+ */
+
+template<class TStorage>
+inline bool AseCommandEncoder<TStorage>::setLastSprite(uint16_t spriteNumber) {
+
+  TStorage& s(storage());
+
+  if(!s.reserve(2))
+    return false;
+
+  s.encode(AseCommands::CMD_LAST_SPRITE);
+  s.encode(spriteNumber);
+
+  return true;
+}
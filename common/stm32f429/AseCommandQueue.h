@@ -0,0 +1,308 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+#include "AseCommandEncoder.h"
+
+
+/**
+ * A lock-free single producer, single consumer ring of pre-encoded sprite commands. The game
+ * adds commands in thread mode and the BUSY falling edge interrupt sends them to the FPGA
+ * with AseAccessMode::writeEncoded(). Each bus word is stored as the same WR low, WR high pair
+ * of halfwords as AseCommandBuffer.
+ *
+ * The producer's commands are invisible to the consumer until endFrame() publishes a frame
+ * marker, and the consumer only ever sends whole frames, so a frame that's still being built
+ * can't leak out into a busy period. drain() checks BUSY before each frame.
+ *
+ * The producer owns _tail and the open frame. The consumer owns _head and _taken. _published,
+ * _head and _taken are shared and are read and written with acquire/release atomics so the
+ * markers and the words behind them are visible before the counts that publish them. The queue
+ * never locks anything or disables interrupts.
+ *
+ * A command is never split across the end of the ring. If it won't fit in the words that are
+ * left before the end then they're skipped and the frame's marker records where it broke off,
+ * so each of the one or two bursts that send a frame hold whole commands. If there isn't room
+ * for a command at all then it's dropped and the overflow flag is set, as AseCommandBuffer does.
+ *
+ * @tparam TMaxWords The capacity in bus words, a power of 2
+ * @tparam TMaxFrames The number of frames that can be waiting, a power of 2
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames=4>
+class AseCommandQueue : public AseCommandEncoder<AseCommandQueue<TMaxWords,TMaxFrames>> {
+
+  protected:
+
+    /*
+     * Where a published frame ends. If it wraps then Break is the ring index where its words
+     * stop before carrying on from zero. It's TMaxWords if no words were skipped.
+     */
+
+    struct Marker {
+      uint32_t End;
+      uint16_t Break;
+    };
+
+    uint16_t _encoded[TMaxWords*2];
+    Marker _markers[TMaxFrames];
+
+    // shared, free running counts
+
+    uint32_t _published;            // frames published by the producer
+    uint32_t _taken;                // frames sent by the consumer
+    uint32_t _head;                 // words sent by the consumer, including skipped ones
+
+    // the producer's open frame
+
+    uint32_t _tail;                 // words added, including skipped ones
+    uint32_t _frameStart;
+    uint16_t _frameWords;
+    uint16_t _break;
+    uint16_t *_next;
+    bool _overflow;
+
+  protected:
+    bool reserve(uint16_t numWords);
+    void encode(uint16_t value);
+
+    static uint32_t load(const uint32_t& value);
+    static void store(uint32_t& location,uint32_t value);
+
+    friend class AseCommandEncoder<AseCommandQueue<TMaxWords,TMaxFrames>>;
+
+  public:
+    AseCommandQueue();
+
+    // producer
+
+    bool endFrame();
+    uint16_t getWordCount() const;
+    uint16_t getFreeWords() const;
+    bool isOverflowed() const;
+
+    // consumer
+
+    uint8_t drain(const AseAccessMode& accessMode);
+    bool isEmpty() const;
+};
+
+
+/**
+ * Constructor
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline AseCommandQueue<TMaxWords,TMaxFrames>::AseCommandQueue()
+  : _published(0),
+    _taken(0),
+    _head(0),
+    _tail(0),
+    _frameStart(0),
+    _frameWords(0),
+    _break(TMaxWords),
+    _next(_encoded),
+    _overflow(false) {
+
+  static_assert((TMaxWords & (TMaxWords-1))==0,"TMaxWords must be a power of 2");
+  static_assert((TMaxFrames & (TMaxFrames-1))==0,"TMaxFrames must be a power of 2");
+}
+
+
+/**
+ * Read a shared count. Nothing after this is moved before it.
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline uint32_t AseCommandQueue<TMaxWords,TMaxFrames>::load(const uint32_t& value) {
+  return __atomic_load_n(&value,__ATOMIC_ACQUIRE);
+}
+
+
+/**
+ * Write a shared count. Nothing before this is moved after it.
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline void AseCommandQueue<TMaxWords,TMaxFrames>::store(uint32_t& location,uint32_t value) {
+  __atomic_store_n(&location,value,__ATOMIC_RELEASE);
+}
+
+
+/**
+ * Make room for a command in the open frame. The words left before the end of the ring are
+ * skipped if it won't fit in them.
+ * @param numWords The number of bus words in the command
+ * @return true if there's room
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline bool AseCommandQueue<TMaxWords,TMaxFrames>::reserve(uint16_t numWords) {
+
+  uint32_t index,skip;
+
+  index=_tail & (TMaxWords-1);
+  skip=index+numWords>TMaxWords ? TMaxWords-index : 0;
+
+  if(_tail-load(_head)+skip+numWords>TMaxWords) {
+    _overflow=true;
+    return false;
+  }
+
+  if(skip) {
+    _break=index;
+    _tail+=skip;
+    index=0;
+  }
+
+  _next=&_encoded[index*2];
+  _tail+=numWords;
+  _frameWords+=numWords;
+
+  return true;
+}
+
+
+/**
+ * Encode a 10-bit bus word as the WR low, WR high pair
+ * @param value The bus word
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline void AseCommandQueue<TMaxWords,TMaxFrames>::encode(uint16_t value) {
+
+  value&=0x3ff;
+
+  *_next++=value;             // WR = 0
+  *_next++=value | 0x400;     // WR = 1
+}
+
+
+/**
+ * Producer: publish the open frame so that the consumer can send it. If all the markers are
+ * waiting to be sent then the frame is left open and what's added next joins it. The overflow
+ * flag is reset when the frame is published.
+ * @return false if the frame couldn't be published
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline bool AseCommandQueue<TMaxWords,TMaxFrames>::endFrame() {
+
+  if(_tail!=_frameStart) {
+
+    if(_published-load(_taken)==TMaxFrames)
+      return false;
+
+    Marker& marker(_markers[_published & (TMaxFrames-1)]);
+
+    marker.End=_tail;
+    marker.Break=_break;
+
+    store(_published,_published+1);
+  }
+
+  _frameStart=_tail;
+  _frameWords=0;
+  _break=TMaxWords;
+  _overflow=false;
+
+  return true;
+}
+
+
+/**
+ * Producer: get the number of bus words in the open frame
+ * @return The word count
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline uint16_t AseCommandQueue<TMaxWords,TMaxFrames>::getWordCount() const {
+  return _frameWords;
+}
+
+
+/**
+ * Producer: get the number of words that can be added before the consumer sends some. A
+ * command may need more than its own size if it has to skip to the start of the ring.
+ * @return The free words
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline uint16_t AseCommandQueue<TMaxWords,TMaxFrames>::getFreeWords() const {
+  return TMaxWords-(_tail-load(_head));
+}
+
+
+/**
+ * Producer: check if a command in the open frame was dropped because the ring was full
+ * @return true if it was
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline bool AseCommandQueue<TMaxWords,TMaxFrames>::isOverflowed() const {
+  return _overflow;
+}
+
+
+/**
+ * Consumer: send the published frames in order, each in one or two bursts. Stops early if
+ * the FPGA is busy, in which case the rest wait for the next call. Call it from the BUSY
+ * falling edge interrupt, or from thread mode with that interrupt disabled.
+ * @param accessMode The access mode to write with
+ * @return The number of frames sent
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline uint8_t AseCommandQueue<TMaxWords,TMaxFrames>::drain(const AseAccessMode& accessMode) {
+
+  uint32_t published,index,length,first;
+  uint8_t sent;
+
+  published=load(_published);
+
+  for(sent=0;_taken!=published;sent++) {
+
+    if(accessMode.isBusy())
+      break;
+
+    const Marker& marker(_markers[_taken & (TMaxFrames-1)]);
+
+    index=_head & (TMaxWords-1);
+    length=marker.End-_head;
+
+    if(index+length<=TMaxWords)
+      accessMode.writeEncoded(&_encoded[index*2],length);
+    else {
+
+      // up to the break, then from the start of the ring
+
+      first=marker.Break-index;
+
+      if(first)
+        accessMode.writeEncoded(&_encoded[index*2],first);
+
+      accessMode.writeEncoded(_encoded,length-(TMaxWords-index));
+    }
+
+    store(_head,marker.End);
+    store(_taken,_taken+1);
+  }
+
+  return sent;
+}
+
+
+/**
+ * Consumer: check if there's nothing waiting to be sent
+ * @return true if all the published frames have been sent
+ */
+
+template<uint16_t TMaxWords,uint8_t TMaxFrames>
+inline bool AseCommandQueue<TMaxWords,TMaxFrames>::isEmpty() const {
+  return _taken==load(_published);
+}
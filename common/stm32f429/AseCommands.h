@@ -32,13 +32,20 @@ namespace AseCommands {
     CMD_SPRITE = 0x200,
 
     /**
-     * Show a sprite. Must be followed by a 9-bit sprite index
+     * Show a sprite and clear its persistent flag. Must be followed by a 9-bit sprite index
      */
 
     CMD_SHOW = 0x0A3,
 
     /**
-     * Hide a sprite. Must be followed by a 9-bit sprite index
+     * Show a sprite and set its persistent flag. This is CMD_SHOW with bit 9 set. Must be followed
+     * by a 9-bit sprite index
+     */
+
+    CMD_SHOW_PERSISTENT = CMD_SHOW | 0x200,
+
+    /**
+     * Hide a sprite and clear its persistent flag. Must be followed by a 9-bit sprite index
      */
 
     CMD_HIDE = 0x0A4,
@@ -56,7 +63,7 @@ namespace AseCommands {
      *  8-bit   flash address (high) [23..16]
      *  9-bit   repeat-x (number of times to auto-repeat in x direction. min = 1)
      *  10-bit  repeat-y (number of times to auto-repeat in y direction. min = 1)
-     *  1-bit   visible flag [0..0]
+     *  5-bit   flags: visible [0], persistent [1], mirror [2], indexed [3], spans [4]
      *  9-bit   first visible x column (zero based)
      *  9-bit   last visible x column
      *  10-bit  first visible y row (zero based)
@@ -65,6 +72,24 @@ namespace AseCommands {
 
     CMD_LOAD = 0x0A5,
 
+    /*
+     * A persistent sprite is skipped by the sprite writer once it has been drawn in full because
+     * its pixels are still in SRAM. It's drawn again after any command for it or a change of the
+     * viewport offset. Only sprites with nothing changing on top of or underneath them should be
+     * persistent.
+     *
+     * A mirrored sprite is drawn bottom row first, each row above the last. Its SRAM position is
+     * the start of the bottom row and its y clipping rows are counted in drawing order.
+     *
+     * An indexed sprite has one byte per pixel in flash that's looked up in the palette loaded
+     * with CMD_PALETTE. Its flash address and pixel size are the same as for a 16-bit sprite.
+     *
+     * A span sprite stores only its opaque pixels. Each row is one or more runs and each run
+     * follows a 16-bit header word: bit 15 is set on the last run in the row, bits 14..8 are
+     * the transparent pixels to skip before it and bits 7..0 are its length. Pixel size is the
+     * number of words including the headers. A sprite can't be both indexed and spans.
+     */
+
     /**
      * Move a sprite to a new position. Must be followed by:
      *  9-bit   sprite index
@@ -76,7 +101,8 @@ namespace AseCommands {
 
 
     /**
-     * Move a sprite to a new position where it's partially on the screen. Must be followed by:
+     * Move a sprite to a new position where it's partially on the screen. This is CMD_MOVE with
+     * bit 9 set as the flag that the partial parameters follow. Must be followed by:
      *  9-bit   sprite index
      *  10-bit  SRAM position (low) [9..0]
      *  8-bit   SRAM position (high) [7..0]
@@ -86,6 +112,51 @@ namespace AseCommands {
      *  10-bit  last visible y row
      */
 
-    CMD_MOVE_PARTIAL = 0x004 | 0x200
+    CMD_MOVE_PARTIAL = CMD_MOVE | 0x200,
+
+    /**
+     * Set the viewport offset. The sprite writer subtracts this from every sprite's SRAM position,
+     * modulo 2^18, so sprites can be loaded at (world y * 360) + world x and the whole scene scrolled
+     * by changing the offset to (top y * 360) + left x. The new value is used from the start of the
+     * next busy period. Must be followed by:
+     *  10-bit  offset (low) [9..0]
+     *  8-bit   offset (high) [17..10]
+     */
+
+    CMD_OFFSET = 0x0A7,
+
+    /**
+     * Set the last sprite record that the sprite writer reads. Each pass stops after this record
+     * so the records above it cost nothing. It should be the highest visible sprite. The FPGA
+     * comes out of reset with 511, i.e. all of them. The new value is used from the start of the
+     * next busy period. Must be followed by:
+     *  9-bit   sprite index
+     */
+
+    CMD_LAST_SPRITE = 0x0A8,
+
+    /**
+     * Write consecutive entries of the 256 colour palette used by indexed sprites. The palette
+     * shares the sprite writer's busy period with the sprite records and a colour written while
+     * BUSY is high is lost. Must be followed by:
+     *  8-bit   first palette index
+     *  8-bit   number of colours less one
+     *  then for each colour:
+     *    8-bit   colour (low) [7..0]
+     *    8-bit   colour (high) [15..8]
+     */
+
+    CMD_PALETTE = 0x0A9,
+
+    /**
+     * Load consecutive sprite records into the FPGA. Each record is a CMD_LOAD without the command
+     * and the sprite index, and the index moves on by one after each record, wrapping at 511. Must
+     * be followed by:
+     *  9-bit   first sprite index
+     *  9-bit   number of records less one
+     *  then for each record the 15 parameters of CMD_LOAD from the SRAM position (low) onwards
+     */
+
+    CMD_LOAD_BLOCK = 0x0AA
   };
 }
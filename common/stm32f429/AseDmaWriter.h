@@ -0,0 +1,397 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+#if defined(ASE_EMULATOR)
+#include "AseEmulatorBus.h"
+#endif
+
+
+/**
+ * Timer paced DMA of passthrough pixels to the FPGA. Each pixel is expanded into the four port E
+ * halfwords that writeData() would store: the low byte with WR low then high, and the high byte
+ * with RS set and WR low then high. TIM8 makes a channel 1 compare DMA request every PACING_TICKS
+ * clocks and DMA2 stream 2 (channel 7) writes one halfword to GPIOE->ODR for each. DMA2 is the
+ * controller that can reach the AHB1 GPIO ports. If the DMA can't keep up then a request is
+ * missed and WR is just held for longer.
+ *
+ * The stream runs in double buffer mode over two halves of a staging buffer. The transfer complete
+ * interrupt refills the half that has just gone out while the other one is being sent, so the
+ * CPU only expands pixels. A fill expands its colour into both halves once and sends them over and
+ * over. The tail of the last half is padded with IDLE halfwords, which keep WR high so they don't
+ * write anything, and the stream is stopped after the last half with real pixels in it.
+ *
+ * rawTransfer() returns when the last of the source pixels are in the staging buffer and fill()
+ * returns straight away. Call wait() before anything else goes on the bus. AseAccessMode does that
+ * when it's given a writer with setDmaWriter().
+ *
+ * The application must forward the interrupt:
+ *
+ *   extern "C" void DMA2_Stream2_IRQHandler() {
+ *     AseDmaWriter::onInterrupt();
+ *   }
+ *
+ * On the host build each half is played out on to the emulated bus in turn and the interrupt is
+ * called after it, so rawTransfer() and fill() return when everything has been written.
+ */
+
+class AseDmaWriter {
+
+  public:
+    enum {
+      CHUNK_PIXELS = 128,                               // pixels in each half of the staging buffer
+      HALFWORDS_PER_PIXEL = 4,
+      CHUNK_HALFWORDS = CHUNK_PIXELS*HALFWORDS_PER_PIXEL,
+      MIN_PIXELS = 64,                                  // not worth starting the DMA for fewer
+      PACING_TICKS = 6,                                 // TIM8 clocks (180MHz) per halfword = 33ns
+      WR = 0x400,
+      RS = 0x200,
+      IDLE = WR                                         // WR high, nothing is written
+    };
+
+  protected:
+    uint16_t _staging[2][CHUNK_HALFWORDS];
+    const uint16_t * volatile _source;                  // rawTransfer() pixels, nullptr for a fill
+    volatile uint32_t _remaining;                       // pixels that aren't in the staging buffer yet
+    volatile bool _draining;                            // the half being sent is the last one
+    volatile bool _busy;
+
+#if defined(ASE_EMULATOR)
+    uint8_t _current;                                   // the half being sent
+    uint16_t _odr;                                      // the last halfword on port E
+#endif
+
+  protected:
+    static AseDmaWriter*& instance();
+    static void expand(uint16_t *dest,uint16_t pixel);
+
+    void start(uint32_t count);
+    void prepare(uint16_t *half);
+    void stop();
+
+#if defined(ASE_EMULATOR)
+    void send(const uint16_t *half);
+#endif
+
+  public:
+    AseDmaWriter();
+
+    void rawTransfer(const uint16_t *pixels,uint32_t count);
+    void fill(uint16_t value,uint32_t count);
+
+    bool isBusy() const;
+    void wait() const;
+
+    static void onInterrupt();
+};
+
+
+/**
+ * Storage for the writer that the interrupt services
+ */
+
+inline AseDmaWriter*& AseDmaWriter::instance() {
+  static AseDmaWriter *writer=nullptr;
+  return writer;
+}
+
+
+/**
+ * Constructor. Set up TIM8 and the DMA stream but leave them stopped.
+ */
+
+inline AseDmaWriter::AseDmaWriter()
+  : _source(nullptr),
+    _remaining(0),
+    _draining(false),
+    _busy(false) {
+
+  instance()=this;
+
+#if defined(ASE_EMULATOR)
+  _current=0;
+  _odr=IDLE;
+#endif
+
+#if !defined(ASE_EMULATOR)
+
+  TIM_TimeBaseInitTypeDef timeBase;
+  TIM_OCInitTypeDef oc;
+  DMA_InitTypeDef dma;
+  NVIC_InitTypeDef nvic;
+
+  RCC_APB2PeriphClockCmd(RCC_APB2Periph_TIM8,ENABLE);
+  RCC_AHB1PeriphClockCmd(RCC_AHB1Periph_DMA2,ENABLE);
+
+  // TIM8 counts PACING_TICKS and the channel 1 compare makes a DMA request once per period
+
+  TIM_TimeBaseStructInit(&timeBase);
+  timeBase.TIM_Period=PACING_TICKS-1;
+  timeBase.TIM_Prescaler=0;
+  timeBase.TIM_ClockDivision=TIM_CKD_DIV1;
+  timeBase.TIM_CounterMode=TIM_CounterMode_Up;
+  TIM_TimeBaseInit(TIM8,&timeBase);
+
+  TIM_OCStructInit(&oc);
+  oc.TIM_OCMode=TIM_OCMode_Timing;
+  oc.TIM_Pulse=0;
+  TIM_OC1Init(TIM8,&oc);
+
+  TIM_DMACmd(TIM8,TIM_DMA_CC1,ENABLE);
+
+  // DMA2 stream 2 channel 7 is TIM8_CH1. Halfwords from the two staging halves go to port E.
+
+  DMA_DeInit(DMA2_Stream2);
+  DMA_StructInit(&dma);
+
+  dma.DMA_Channel=DMA_Channel_7;
+  dma.DMA_PeripheralBaseAddr=reinterpret_cast<uint32_t>(&GPIOE->ODR);
+  dma.DMA_Memory0BaseAddr=reinterpret_cast<uint32_t>(_staging[0]);
+  dma.DMA_DIR=DMA_DIR_MemoryToPeripheral;
+  dma.DMA_BufferSize=CHUNK_HALFWORDS;
+  dma.DMA_PeripheralInc=DMA_PeripheralInc_Disable;
+  dma.DMA_MemoryInc=DMA_MemoryInc_Enable;
+  dma.DMA_PeripheralDataSize=DMA_PeripheralDataSize_HalfWord;
+  dma.DMA_MemoryDataSize=DMA_MemoryDataSize_HalfWord;
+  dma.DMA_Mode=DMA_Mode_Circular;                         // required by double buffer mode
+  dma.DMA_Priority=DMA_Priority_VeryHigh;
+  dma.DMA_FIFOMode=DMA_FIFOMode_Disable;
+  DMA_Init(DMA2_Stream2,&dma);
+
+  DMA_DoubleBufferModeConfig(DMA2_Stream2,reinterpret_cast<uint32_t>(_staging[1]),DMA_Memory_0);
+  DMA_DoubleBufferModeCmd(DMA2_Stream2,ENABLE);
+  DMA_ITConfig(DMA2_Stream2,DMA_IT_TC,ENABLE);
+
+  nvic.NVIC_IRQChannel=DMA2_Stream2_IRQn;
+  nvic.NVIC_IRQChannelPreemptionPriority=0;
+  nvic.NVIC_IRQChannelSubPriority=0;
+  nvic.NVIC_IRQChannelCmd=ENABLE;
+  NVIC_Init(&nvic);
+
+#endif
+}
+
+
+/**
+ * Send pixels to the panel
+ * @param pixels The pixels. They must stay put until this returns.
+ * @param count The number of pixels
+ */
+
+inline void AseDmaWriter::rawTransfer(const uint16_t *pixels,uint32_t count) {
+
+  wait();
+
+  _source=pixels;
+  start(count);
+
+  // the source is free once the last of it is in the staging buffer
+
+  while(_remaining!=0);
+}
+
+
+/**
+ * Send the same pixel to the panel many times
+ * @param value The pixel
+ * @param count The number of times
+ */
+
+inline void AseDmaWriter::fill(uint16_t value,uint32_t count) {
+
+  uint16_t i;
+
+  wait();
+
+  for(i=0;i<CHUNK_PIXELS;i++) {
+    expand(&_staging[0][i*HALFWORDS_PER_PIXEL],value);
+    expand(&_staging[1][i*HALFWORDS_PER_PIXEL],value);
+  }
+
+  _source=nullptr;
+  start(count);
+}
+
+
+/**
+ * Check if a transfer is still going out
+ */
+
+inline bool AseDmaWriter::isBusy() const {
+  return _busy;
+}
+
+
+/**
+ * Wait for the last transfer to finish
+ */
+
+inline void AseDmaWriter::wait() const {
+  while(_busy);
+}
+
+
+/**
+ * Expand a pixel into the four halfwords that writeData() would store
+ */
+
+inline void AseDmaWriter::expand(uint16_t *dest,uint16_t pixel) {
+
+  dest[0]=pixel & 0xff;                     // low byte, WR = 0
+  dest[1]=(pixel & 0xff) | WR;              // low byte, WR = 1
+  dest[2]=(pixel >> 8) | RS;                // high byte, RS = 1, WR = 0
+  dest[3]=(pixel >> 8) | RS | WR;           // high byte, RS = 1, WR = 1
+}
+
+
+/**
+ * Put the next pixels into a half of the staging buffer and pad the rest with IDLE. A fill's
+ * pixels are already there.
+ * @param half The half to prepare
+ */
+
+inline void AseDmaWriter::prepare(uint16_t *half) {
+
+  uint32_t i,n;
+
+  n=_remaining;
+  if(n>CHUNK_PIXELS)
+    n=CHUNK_PIXELS;
+
+  if(_source) {
+
+    const uint16_t *ptr=_source;
+
+    for(i=0;i<n;i++)
+      expand(&half[i*HALFWORDS_PER_PIXEL],*ptr++);
+
+    _source=n==_remaining ? nullptr : ptr;
+  }
+
+  for(i=n*HALFWORDS_PER_PIXEL;i<CHUNK_HALFWORDS;i++)
+    half[i]=IDLE;
+
+  _remaining-=n;
+}
+
+
+/**
+ * Start sending. The first two halves are prepared before the stream is enabled.
+ * @param count The number of pixels
+ */
+
+inline void AseDmaWriter::start(uint32_t count) {
+
+  _remaining=count;
+  _busy=true;
+
+  prepare(_staging[0]);
+  _draining=_remaining==0;
+  prepare(_staging[1]);
+
+#if defined(ASE_EMULATOR)
+
+  // host build: each half goes out in turn and then the interrupt is taken
+
+  _current=0;
+
+  while(_busy) {
+    send(_staging[_current]);
+    _current^=1;
+    onInterrupt();
+  }
+
+#else
+
+  // the stream starts on memory 0 with a full count. Both must be written while it's disabled.
+
+  while(DMA_GetCmdStatus(DMA2_Stream2)!=DISABLE);
+
+  DMA_ClearFlag(DMA2_Stream2,DMA_FLAG_TCIF2 | DMA_FLAG_HTIF2 | DMA_FLAG_TEIF2 | DMA_FLAG_DMEIF2 | DMA_FLAG_FEIF2);
+  DMA_DoubleBufferModeConfig(DMA2_Stream2,reinterpret_cast<uint32_t>(_staging[1]),DMA_Memory_0);
+  DMA_SetCurrDataCounter(DMA2_Stream2,CHUNK_HALFWORDS);
+  DMA_Cmd(DMA2_Stream2,ENABLE);
+
+  TIM_SetCounter(TIM8,0);
+  TIM_Cmd(TIM8,ENABLE);
+
+#endif
+}
+
+
+/**
+ * Stop the timer and the stream. The half that's going out now has nothing but IDLE in it.
+ */
+
+inline void AseDmaWriter::stop() {
+
+#if !defined(ASE_EMULATOR)
+  TIM_Cmd(TIM8,DISABLE);
+  DMA_Cmd(DMA2_Stream2,DISABLE);
+#endif
+
+  _busy=false;
+}
+
+
+/**
+ * Transfer complete interrupt. A half has gone out and the stream has moved on to the other one.
+ * Either that was the last half with pixels in it or the free half is refilled.
+ */
+
+inline void AseDmaWriter::onInterrupt() {
+
+  AseDmaWriter& writer(*instance());
+  uint16_t *half;
+
+#if defined(ASE_EMULATOR)
+  half=writer._staging[writer._current ^ 1];
+#else
+
+  if(DMA_GetITStatus(DMA2_Stream2,DMA_IT_TCIF2)==RESET)
+    return;
+
+  DMA_ClearITPendingBit(DMA2_Stream2,DMA_IT_TCIF2);
+
+  // the current target is the half being sent now, the other one is free
+
+  half=writer._staging[DMA_GetCurrentMemoryTarget(DMA2_Stream2)==0 ? 1 : 0];
+
+#endif
+
+  if(writer._draining)
+    writer.stop();
+  else {
+    writer._draining=writer._remaining==0;
+    writer.prepare(half);
+  }
+}
+
+
+#if defined(ASE_EMULATOR)
+
+/**
+ * Host build: play a half out on to the emulated port E. The FPGA takes the word on the bus when
+ * WR goes from low to high.
+ * @param half The half to send
+ */
+
+inline void AseDmaWriter::send(const uint16_t *half) {
+
+  uint32_t i;
+
+  for(i=0;i<CHUNK_HALFWORDS;i++) {
+
+    if(!(_odr & WR) && (half[i] & WR))
+      AseEmulatorBus::write(_odr & 0x3ff);
+
+    _odr=half[i];
+  }
+}
+
+#endif
@@ -0,0 +1,284 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+#include "AseIndexes.h"
+
+
+template<uint16_t TWords>
+class AseEncodedCommand;
+
+
+/**
+ * Compile time encoding of sprite commands whose definitions are constant. A constexpr
+ * LoadSpriteDef, MoveSpriteDef or table of consecutive LoadSpriteDefs is turned into the same
+ * WR low, WR high halfword pairs that AseCommandEncoder builds at runtime. Declare the result
+ * constexpr and it's built by the compiler and lives in flash:
+ *
+ *   static constexpr LoadSpriteDef defs[2]={ ... };
+ *   static constexpr auto block=AseEncodedCommands::loadBlock(defs);
+ *
+ *   block.flush(accessMode);
+ *
+ * The fields that the FPGA would truncate are checked while compiling. A sprite number over
+ * 9 bits, an SRAM address or pixel count over 18 bits, a flash address over 24 bits or a block
+ * whose sprite numbers don't follow on from each other is a compile error that names one of
+ * the out of range functions. They're never defined so a non-constexpr use won't link.
+ */
+
+class AseEncodedCommands {
+
+  public:
+    enum {
+      LOAD_WORDS = 17,
+      MOVE_WORDS = 8,
+      BLOCK_HEADER_WORDS = 3,
+      BLOCK_RECORD_WORDS = 15
+    };
+
+  protected:
+    static uint16_t spriteNumberOutOfRange();
+    static uint16_t sramAddressOutOfRange();
+    static uint16_t pixelCountOutOfRange();
+    static uint16_t flashAddressOutOfRange();
+    static uint16_t blockNotConsecutive();
+
+    static constexpr uint32_t checkSpriteNumber(uint32_t spriteNumber);
+    static constexpr uint32_t checkSramAddress(uint32_t sramAddress);
+    static constexpr uint32_t checkPixelCount(uint32_t numPixels);
+    static constexpr uint32_t checkFlashAddress(uint32_t flashAddress);
+
+    static constexpr uint16_t loadParam(const LoadSpriteDef& sd,uint16_t param);
+
+  public:
+    static constexpr uint16_t word(const LoadSpriteDef& sd,uint16_t index);
+    static constexpr uint16_t word(const MoveSpriteDef& md,uint16_t index);
+
+    template<uint16_t TCount>
+    static constexpr uint16_t word(const LoadSpriteDef (&defs)[TCount],uint16_t index);
+
+    static constexpr AseEncodedCommand<LOAD_WORDS> load(const LoadSpriteDef& sd);
+    static constexpr AseEncodedCommand<MOVE_WORDS> move(const MoveSpriteDef& md);
+
+    template<uint16_t TCount>
+    static constexpr auto loadBlock(const LoadSpriteDef (&defs)[TCount])
+      -> AseEncodedCommand<BLOCK_HEADER_WORDS+BLOCK_RECORD_WORDS*TCount>;
+};
+
+
+/**
+ * A sprite command encoded by the compiler. It's sent as it is with AseAccessMode::writeEncoded().
+ * @tparam TWords The number of bus words in the command
+ */
+
+template<uint16_t TWords>
+class AseEncodedCommand {
+
+  protected:
+    uint16_t _encoded[TWords*2];
+
+  public:
+    template<class TDefinition,uint16_t... I>
+    constexpr AseEncodedCommand(const TDefinition& def,AseIndexes<I...>);
+
+    void flush(const AseAccessMode& accessMode) const;
+
+    constexpr const uint16_t *getEncoded() const;
+    constexpr uint16_t getWordCount() const;
+};
+
+
+/**
+ * Constructor. Halfword I is bus word I/2 with WR set on the odd ones.
+ * @param def The definition that the words come from
+ */
+
+template<uint16_t TWords>
+template<class TDefinition,uint16_t... I>
+inline constexpr AseEncodedCommand<TWords>::AseEncodedCommand(const TDefinition& def,AseIndexes<I...>)
+  : _encoded { static_cast<uint16_t>((AseEncodedCommands::word(def,I/2) & 0x3ff) | ((I & 1) << 10))... } {
+}
+
+
+/**
+ * Send the command to the FPGA
+ * @param accessMode The access mode to write with
+ */
+
+template<uint16_t TWords>
+inline void AseEncodedCommand<TWords>::flush(const AseAccessMode& accessMode) const {
+  accessMode.writeEncoded(_encoded,TWords);
+}
+
+
+/**
+ * Get the encoded halfword pairs
+ * @return A pointer to the first pair
+ */
+
+template<uint16_t TWords>
+inline constexpr const uint16_t *AseEncodedCommand<TWords>::getEncoded() const {
+  return _encoded;
+}
+
+
+/**
+ * Get the number of bus words
+ * @return The word count
+ */
+
+template<uint16_t TWords>
+inline constexpr uint16_t AseEncodedCommand<TWords>::getWordCount() const {
+  return TWords;
+}
+
+
+/*
+ * Range checks. Each returns its value or calls a function that isn't constexpr, which the
+ * compiler reports when it's building a constant.
+ */
+
+inline constexpr uint32_t AseEncodedCommands::checkSpriteNumber(uint32_t spriteNumber) {
+  return spriteNumber<=0x1ff ? spriteNumber : spriteNumberOutOfRange();
+}
+
+inline constexpr uint32_t AseEncodedCommands::checkSramAddress(uint32_t sramAddress) {
+  return sramAddress<=0x3ffff ? sramAddress : sramAddressOutOfRange();
+}
+
+inline constexpr uint32_t AseEncodedCommands::checkPixelCount(uint32_t numPixels) {
+  return numPixels<=0x3ffff ? numPixels : pixelCountOutOfRange();
+}
+
+inline constexpr uint32_t AseEncodedCommands::checkFlashAddress(uint32_t flashAddress) {
+  return flashAddress<=0xffffff ? flashAddress : flashAddressOutOfRange();
+}
+
+
+/**
+ * Get a CMD_LOAD parameter in the order that AseAccessMode::loadSprite() writes them
+ * @param sd The sprite definition
+ * @param param The parameter, 0 is the sprite number and 15 is the last Y row
+ * @return The bus word
+ */
+
+inline constexpr uint16_t AseEncodedCommands::loadParam(const LoadSpriteDef& sd,uint16_t param) {
+
+  return param==0 ? checkSpriteNumber(sd.SpriteNumber) :
+         param==1 ? checkSramAddress(sd.SramAddress) & 0x3ff :
+         param==2 ? checkSramAddress(sd.SramAddress) >> 10 :
+         param==3 ? sd.PixelWidth :
+         param==4 ? checkPixelCount(sd.NumPixels) & 0x3ff :
+         param==5 ? checkPixelCount(sd.NumPixels) >> 10 :
+         param==6 ? checkFlashAddress(sd.FlashAddress) & 0xff :
+         param==7 ? (checkFlashAddress(sd.FlashAddress) >> 8) & 0xff :
+         param==8 ? checkFlashAddress(sd.FlashAddress) >> 16 :
+         param==9 ? sd.RepeatX :
+         param==10 ? sd.RepeatY :
+         param==11 ? sd.Visible | (sd.Persistent << 1) | (sd.Mirror << 2) | (sd.Indexed << 3) | (sd.Spans << 4) :
+         param==12 ? sd.FirstX :
+         param==13 ? sd.LastX :
+         param==14 ? sd.FirstY :
+         sd.LastY;
+}
+
+
+/**
+ * Get a bus word of a CMD_LOAD
+ * @param sd The sprite definition
+ * @param index The word, 0 is the command
+ * @return The bus word
+ */
+
+inline constexpr uint16_t AseEncodedCommands::word(const LoadSpriteDef& sd,uint16_t index) {
+  return index==0 ? static_cast<uint16_t>(AseCommands::CMD_LOAD) : loadParam(sd,index-1);
+}
+
+
+/**
+ * Get a bus word of a CMD_MOVE_PARTIAL
+ * @param md The move definition
+ * @param index The word, 0 is the command
+ * @return The bus word
+ */
+
+inline constexpr uint16_t AseEncodedCommands::word(const MoveSpriteDef& md,uint16_t index) {
+
+  return index==0 ? static_cast<uint16_t>(AseCommands::CMD_MOVE_PARTIAL) :
+         index==1 ? checkSpriteNumber(md.SpriteNumber) :
+         index==2 ? checkSramAddress(md.SramAddress) & 0x3ff :
+         index==3 ? checkSramAddress(md.SramAddress) >> 10 :
+         index==4 ? md.FirstX :
+         index==5 ? md.LastX :
+         index==6 ? md.FirstY :
+         md.LastY;
+}
+
+
+/**
+ * Get a bus word of a CMD_LOAD_BLOCK. Each record must be the sprite after the one before it.
+ * @param defs The sprite definitions
+ * @param index The word, 0 is the command
+ * @return The bus word
+ */
+
+template<uint16_t TCount>
+inline constexpr uint16_t AseEncodedCommands::word(const LoadSpriteDef (&defs)[TCount],uint16_t index) {
+
+  return index==0 ? static_cast<uint16_t>(AseCommands::CMD_LOAD_BLOCK) :
+         index==1 ? checkSpriteNumber(defs[0].SpriteNumber) :
+         index==2 ? TCount-1 :
+
+         // the first word of each record checks its sprite number
+
+         (index-BLOCK_HEADER_WORDS) % BLOCK_RECORD_WORDS==0 &&
+             checkSpriteNumber(defs[(index-BLOCK_HEADER_WORDS)/BLOCK_RECORD_WORDS].SpriteNumber)!=
+             static_cast<uint32_t>((defs[0].SpriteNumber+(index-BLOCK_HEADER_WORDS)/BLOCK_RECORD_WORDS) & 0x1ff) ? blockNotConsecutive() :
+
+         loadParam(defs[(index-BLOCK_HEADER_WORDS)/BLOCK_RECORD_WORDS],(index-BLOCK_HEADER_WORDS) % BLOCK_RECORD_WORDS+1);
+}
+
+
+/**
+ * Encode a CMD_LOAD
+ * @param sd The sprite definition
+ * @return The encoded command
+ */
+
+inline constexpr AseEncodedCommand<AseEncodedCommands::LOAD_WORDS> AseEncodedCommands::load(const LoadSpriteDef& sd) {
+  return AseEncodedCommand<LOAD_WORDS>(sd,AseMakeIndexes<LOAD_WORDS*2>::Type());
+}
+
+
+/**
+ * Encode a CMD_MOVE_PARTIAL
+ * @param md The move definition
+ * @return The encoded command
+ */
+
+inline constexpr AseEncodedCommand<AseEncodedCommands::MOVE_WORDS> AseEncodedCommands::move(const MoveSpriteDef& md) {
+  return AseEncodedCommand<MOVE_WORDS>(md,AseMakeIndexes<MOVE_WORDS*2>::Type());
+}
+
+
+/**
+ * Encode a CMD_LOAD_BLOCK of 1 to 512 sprites numbered consecutively from the first
+ * @param defs The sprite definitions
+ * @return The encoded command
+ */
+
+template<uint16_t TCount>
+inline constexpr auto AseEncodedCommands::loadBlock(const LoadSpriteDef (&defs)[TCount])
+  -> AseEncodedCommand<BLOCK_HEADER_WORDS+BLOCK_RECORD_WORDS*TCount> {
+
+  static_assert(TCount>=1 && TCount<=512,"A block holds 1 to 512 records");
+
+  return AseEncodedCommand<BLOCK_HEADER_WORDS+BLOCK_RECORD_WORDS*TCount>(
+      defs,
+      typename AseMakeIndexes<(BLOCK_HEADER_WORDS+BLOCK_RECORD_WORDS*TCount)*2>::Type());
+}
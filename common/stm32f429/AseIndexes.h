@@ -0,0 +1,41 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * A list of indexes 0..N-1 for expanding a table initialiser that the compiler generates.
+ * AseMakeIndexes splits N in half at each step so the template depth is log2(N) and long
+ * tables, such as a block of all 512 sprite records or a 600 frame easing curve, are fine.
+ */
+
+template<uint16_t... I>
+struct AseIndexes {
+};
+
+template<class TFirst,class TSecond>
+struct AseJoinIndexes;
+
+template<uint16_t... A,uint16_t... B>
+struct AseJoinIndexes<AseIndexes<A...>,AseIndexes<B...>> {
+  typedef AseIndexes<A...,(sizeof...(A)+B)...> Type;
+};
+
+template<uint16_t N>
+struct AseMakeIndexes {
+  typedef typename AseJoinIndexes<typename AseMakeIndexes<N/2>::Type,typename AseMakeIndexes<N-N/2>::Type>::Type Type;
+};
+
+template<>
+struct AseMakeIndexes<0> {
+  typedef AseIndexes<> Type;
+};
+
+template<>
+struct AseMakeIndexes<1> {
+  typedef AseIndexes<0> Type;
+};
@@ -0,0 +1,183 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/**
+ * Admission control for the sprite writer's busy period. At the start of each frame the cost
+ * of everything that must be drawn (e.g. the background) is committed and then the optional
+ * sprites ask for their AseSpriteCost in priority order, highest first. A sprite that doesn't
+ * fit in what's left can offer a cheaper fallback, such as the image that the FPGA already
+ * has. If that doesn't fit either then it's deferred and the caller hides it for this frame.
+ *
+ * The default budget is one TE period less a small margin. The cost model is exact so the
+ * margin only covers the time between TE and the start of the pass.
+ */
+
+class AseSpriteBudget {
+
+  public:
+
+    enum {
+      MARGIN_CYCLES = 16384,
+      DEFAULT_BUDGET_CYCLES = AseSpriteCost::FRAME_FLIP_CYCLES-MARGIN_CYCLES
+    };
+
+    /**
+     * The outcome of a request
+     */
+
+    enum Admission {
+      ADMITTED,         // the requested cost fits
+      FALLBACK,         // only the fallback cost fits
+      DEFERRED          // nothing fits
+    };
+
+    /**
+     * Counters for the current frame
+     */
+
+    struct Statistics {
+      uint32_t FixedCycles;
+      uint32_t PredictedCycles;
+      uint16_t Admitted;
+      uint16_t Fallbacks;
+      uint16_t Deferred;
+    };
+
+  protected:
+    uint32_t _budgetCycles;
+    Statistics _statistics;
+
+  protected:
+    bool take(uint32_t cycles);
+
+  public:
+    AseSpriteBudget();
+
+    void setBudget(uint32_t cycles);
+    uint32_t getBudget() const;
+
+    void beginFrame(uint32_t fixedCycles);
+    Admission admit(uint32_t cycles);
+    Admission admit(uint32_t cycles,uint32_t fallbackCycles);
+
+    const Statistics& getStatistics() const;
+};
+
+
+/**
+ * Constructor
+ */
+
+inline AseSpriteBudget::AseSpriteBudget()
+  : _budgetCycles(DEFAULT_BUDGET_CYCLES) {
+
+  memset(&_statistics,0,sizeof(_statistics));
+}
+
+
+/**
+ * Set the budget
+ * @param cycles The longest pass allowed, in 100MHz FPGA clocks
+ */
+
+inline void AseSpriteBudget::setBudget(uint32_t cycles) {
+  _budgetCycles=cycles;
+}
+
+
+/**
+ * Get the budget
+ * @return The longest pass allowed
+ */
+
+inline uint32_t AseSpriteBudget::getBudget() const {
+  return _budgetCycles;
+}
+
+
+/**
+ * Start a frame. The fixed cost is committed whether or not it fits.
+ * @param fixedCycles The cost of the sprites that aren't subject to admission
+ */
+
+inline void AseSpriteBudget::beginFrame(uint32_t fixedCycles) {
+
+  memset(&_statistics,0,sizeof(_statistics));
+
+  _statistics.FixedCycles=fixedCycles;
+  _statistics.PredictedCycles=fixedCycles;
+}
+
+
+/**
+ * Commit some cycles if they fit
+ * @param cycles The cost
+ * @return true if they fit
+ */
+
+inline bool AseSpriteBudget::take(uint32_t cycles) {
+
+  if(cycles!=0 && (_statistics.PredictedCycles>_budgetCycles || cycles>_budgetCycles-_statistics.PredictedCycles))
+    return false;
+
+  _statistics.PredictedCycles+=cycles;
+  return true;
+}
+
+
+/**
+ * Ask for time with no fallback
+ * @param cycles The cost of the sprite
+ * @return ADMITTED or DEFERRED
+ */
+
+inline AseSpriteBudget::Admission AseSpriteBudget::admit(uint32_t cycles) {
+
+  if(take(cycles)) {
+    _statistics.Admitted++;
+    return ADMITTED;
+  }
+
+  _statistics.Deferred++;
+  return DEFERRED;
+}
+
+
+/**
+ * Ask for time with a fallback
+ * @param cycles The cost of the sprite
+ * @param fallbackCycles The cost of the cheaper version
+ * @return ADMITTED, FALLBACK or DEFERRED
+ */
+
+inline AseSpriteBudget::Admission AseSpriteBudget::admit(uint32_t cycles,uint32_t fallbackCycles) {
+
+  if(take(cycles)) {
+    _statistics.Admitted++;
+    return ADMITTED;
+  }
+
+  if(fallbackCycles<cycles && take(fallbackCycles)) {
+    _statistics.Fallbacks++;
+    return FALLBACK;
+  }
+
+  _statistics.Deferred++;
+  return DEFERRED;
+}
+
+
+/**
+ * Get the counters for the frame so far
+ * @return The counters
+ */
+
+inline const AseSpriteBudget::Statistics& AseSpriteBudget::getStatistics() const {
+  return _statistics;
+}
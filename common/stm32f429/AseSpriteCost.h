@@ -0,0 +1,88 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/**
+ * Model of the time that sprite_writer takes to draw the BRAM sprite list, in 100MHz FPGA
+ * clocks. The state machine has no data dependent timing so the count follows from the
+ * records alone:
+ *
+ *   every record:         4 (3 BRAM read + next sprite) up to the CMD_LAST_SPRITE record
+ *   each visible record:  1 (outer setup)
+ *     each column:        1 (next column)
+ *       each copy:        29 + 4 x NumPixels (flash command, address, dummy, first pixel,
+ *                         4 clocks per pixel, last pixel write and done)
+ *
+ * A span sprite's NumPixels counts its header words as well as its opaque pixels and each of
+ * them takes the 4 clocks of a pixel, so the same sum holds and the skipped pixels are free.
+ *
+ * Clipping doesn't help. Every pixel is read from flash whether or not it's written. Fields
+ * are taken at their FPGA widths and a zero count wraps around exactly as the hardware does.
+ */
+
+class AseSpriteCost {
+
+  public:
+    enum {
+      NUM_SPRITES = 512,
+      RECORD_CYCLES = 4,
+      VISIBLE_CYCLES = 1,
+      COLUMN_CYCLES = 1,
+      COPY_CYCLES = 29,
+      PIXEL_CYCLES = 4,
+
+      PASS_CYCLES = NUM_SPRITES*RECORD_CYCLES,    // the empty list read to the end
+      FRAME_FLIP_CYCLES = 1639344                 // the pass is abandoned after one TE period
+    };
+
+    static uint32_t cycles(const LoadSpriteDef& sd);
+    static uint32_t cycles(uint32_t numPixels,uint16_t repeatX,uint16_t repeatY);
+    static uint32_t scanCycles(uint16_t lastSprite);
+};
+
+
+/**
+ * Get the cost of a sprite record
+ * @param sd The sprite definition
+ * @return The cycles it adds to the pass, zero if it's not visible
+ */
+
+inline uint32_t AseSpriteCost::cycles(const LoadSpriteDef& sd) {
+  return (sd.Visible & 1) ? cycles(sd.NumPixels,sd.RepeatX,sd.RepeatY) : 0;
+}
+
+
+/**
+ * Get the cost of a visible sprite record
+ * @param numPixels The pixels in one copy (18 bits)
+ * @param repeatX The number of columns (9 bits)
+ * @param repeatY The number of copies in a column (10 bits)
+ * @return The cycles it adds to the pass
+ */
+
+inline uint32_t AseSpriteCost::cycles(uint32_t numPixels,uint16_t repeatX,uint16_t repeatY) {
+
+  uint32_t pixels,columns,rows;
+
+  pixels=((numPixels-1) & 0x3ffff)+1;
+  columns=((repeatX-1) & 0x1ff)+1;
+  rows=((repeatY-1) & 0x3ff)+1;
+
+  return VISIBLE_CYCLES+columns*(COLUMN_CYCLES+rows*(COPY_CYCLES+PIXEL_CYCLES*pixels));
+}
+
+
+/**
+ * Get the cost of reading the records whether or not they're visible
+ * @param lastSprite The last record that's read (9 bits)
+ * @return The cycles it adds to the pass
+ */
+
+inline uint32_t AseSpriteCost::scanCycles(uint16_t lastSprite) {
+  return ((lastSprite & (NUM_SPRITES-1))+1)*RECORD_CYCLES;
+}
@@ -0,0 +1,659 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/**
+ * A shadow copy of the 512 sprite records in the FPGA BRAM. Each requested sprite definition
+ * is compared with what we last sent and the cheapest command that gets the FPGA to the new
+ * state is added to the command buffer:
+ *
+ *   nothing changed                           => nothing (0 words)
+ *   only the visible flag changed             => CMD_SHOW / CMD_HIDE (2 words)
+ *   only the persistent flag changed          => CMD_SHOW / CMD_SHOW_PERSISTENT (2 words)
+ *   visible and only the SRAM address changed => CMD_MOVE (4 words)
+ *   visible and only the position/clip changed => CMD_MOVE_PARTIAL (8 words)
+ *   anything else                             => CMD_LOAD (17 words)
+ *
+ * A hidden sprite only needs its visible flag cleared so the rest of its record is left as it is.
+ * A visible sprite that we know nothing about is sent in full.
+ * Values are compared after truncation to the widths that the FPGA stores. The viewport offset
+ * is tracked in the same way.
+ *
+ * If the command buffer is full then the shadow entry is forgotten so that the next request for
+ * that sprite sends a full load.
+ *
+ * The AseSpriteCost of each record that the FPGA holds is kept as well, so the time that the
+ * sprite writer will take to draw the next frame is known before it starts. A command that was
+ * lost to a full buffer doesn't change the prediction because the FPGA still has the old record.
+ *
+ * The sprite writer reads every record up to the one set by CMD_LAST_SPRITE whether or not it's
+ * visible. updateLastSprite() sets that to the highest record that the FPGA holds as visible and
+ * should be called once the frame's requests are in the buffer. Keeping the visible sprites
+ * packed at the bottom of the list keeps this short.
+ *
+ * A persistent sprite costs nothing once the sprite writer has drawn it, until the next command
+ * for it or the next change of viewport offset. endFrame() notes the persistent sprites that the
+ * coming pass will draw so that they aren't counted in the pass after it.
+ *
+ * @tparam TCommandBuffer The AseCommandBuffer type that receives the commands
+ */
+
+template<class TCommandBuffer>
+class AseSpriteShadow {
+
+  public:
+
+    /**
+     * Per-frame counters. WordsRequested is what the requests would have cost if sent as-is.
+     */
+
+    struct Statistics {
+      uint16_t Requests;
+      uint16_t Skipped;
+      uint16_t Loads;
+      uint16_t Moves;
+      uint16_t MovePartials;
+      uint16_t Shows;
+      uint16_t Hides;
+      uint16_t Offsets;
+      uint16_t LastSprites;
+      uint16_t WordsRequested;
+      uint16_t WordsSent;
+      uint32_t PredictedCycles;   // for the pass that draws this frame's commands
+
+      uint16_t getWordsSaved() const {
+        return WordsRequested-WordsSent;
+      }
+    };
+
+  protected:
+
+    enum {
+      NUM_SPRITES = 512,
+
+      LOAD_WORDS = 17,
+      MOVE_PARTIAL_WORDS = 8,
+      MOVE_WORDS = 4,
+      OFFSET_WORDS = 3,
+      LAST_SPRITE_WORDS = 2,
+      SHOWHIDE_WORDS = 2
+    };
+
+    /*
+     * What we know about each record
+     */
+
+    enum EntryState {
+      UNKNOWN,        // nothing, e.g. after reset
+      HIDDEN,         // only that it's hidden
+      KNOWN           // the whole record
+    };
+
+    TCommandBuffer& _commandBuffer;
+    LoadSpriteDef _records[NUM_SPRITES];
+    uint8_t _states[NUM_SPRITES];
+    uint32_t _cycles[NUM_SPRITES];
+    uint32_t _visible[NUM_SPRITES/32];
+    uint32_t _drawn[NUM_SPRITES/32];      // persistent records that the sprite writer will skip
+    uint32_t _predictedCycles;            // the visible records that aren't drawn, not the scan
+    uint32_t _drawnCycles;                // the drawn records, redrawn if the offset changes
+    bool _offsetSent;
+    uint16_t _lastSprite;
+    bool _lastSpriteKnown;
+    uint16_t _viewportX;
+    uint16_t _viewportY;
+    bool _viewportKnown;
+    Statistics _current;
+    Statistics _last;
+
+  protected:
+    static void truncate(LoadSpriteDef& sd);
+    static bool sameImage(const LoadSpriteDef& a,const LoadSpriteDef& b);
+    static bool sameClip(const LoadSpriteDef& a,const LoadSpriteDef& b);
+    void sent(uint16_t spriteNumber,bool ok,uint16_t& counter,uint16_t words);
+    bool hide(uint16_t spriteNumber);
+    bool persist(uint16_t spriteNumber,bool persistent);
+
+  public:
+    AseSpriteShadow(TCommandBuffer& commandBuffer);
+
+    bool loadSprite(const LoadSpriteDef& sd);
+    bool hideSprite(uint16_t spriteNumber);
+    bool copySprite(uint16_t from,uint16_t to);
+    bool setPersistent(uint16_t spriteNumber,bool persistent);
+    bool setViewportOffset(uint16_t x,uint16_t y);
+    bool updateLastSprite();
+
+    void invalidate(uint16_t spriteNumber);
+    void invalidateAll();
+
+    uint32_t getCycles(uint16_t spriteNumber) const;
+    uint32_t getPredictedCycles() const;
+    uint32_t getWorstCaseCycles() const;
+    uint16_t getHighestVisible() const;
+
+    void endFrame();
+    const Statistics& getLastFrameStatistics() const;
+};
+
+
+/**
+ * Constructor
+ * @param commandBuffer Where the commands go
+ */
+
+template<class TCommandBuffer>
+inline AseSpriteShadow<TCommandBuffer>::AseSpriteShadow(TCommandBuffer& commandBuffer)
+  : _commandBuffer(commandBuffer) {
+
+  invalidateAll();
+
+  memset(&_current,0,sizeof(_current));
+  memset(&_last,0,sizeof(_last));
+
+  _last.PredictedCycles=getPredictedCycles();
+}
+
+
+/**
+ * Forget what we know about a sprite. The next request for it will be sent in full.
+ * @param spriteNumber The sprite to forget
+ */
+
+template<class TCommandBuffer>
+inline void AseSpriteShadow<TCommandBuffer>::invalidate(uint16_t spriteNumber) {
+  _states[spriteNumber & (NUM_SPRITES-1)]=UNKNOWN;
+}
+
+
+/**
+ * Forget everything, e.g. after the FPGA has been reset. The FPGA comes out of reset with all
+ * sprites hidden so that's what the cost prediction assumes.
+ */
+
+template<class TCommandBuffer>
+inline void AseSpriteShadow<TCommandBuffer>::invalidateAll() {
+  memset(_states,UNKNOWN,sizeof(_states));
+  memset(_cycles,0,sizeof(_cycles));
+  memset(_visible,0,sizeof(_visible));
+  memset(_drawn,0,sizeof(_drawn));
+  _predictedCycles=0;
+  _drawnCycles=0;
+  _offsetSent=false;
+  _viewportKnown=false;
+  _lastSpriteKnown=false;
+}
+
+
+/**
+ * Get the predicted cost of the record that the FPGA holds for a sprite
+ * @param spriteNumber The sprite
+ * @return The sprite writer cycles when it's drawn, zero if hidden
+ */
+
+template<class TCommandBuffer>
+inline uint32_t AseSpriteShadow<TCommandBuffer>::getCycles(uint16_t spriteNumber) const {
+  return _cycles[spriteNumber & (NUM_SPRITES-1)];
+}
+
+
+/**
+ * Get the predicted length of the next sprite writer pass if the commands sent so far reach
+ * the FPGA and updateLastSprite() is called before they're flushed. If we don't know the last
+ * sprite that the FPGA has, e.g. after a reset, then the whole list is assumed.
+ * @return The sprite writer cycles, including the cost of reading the records
+ */
+
+template<class TCommandBuffer>
+inline uint32_t AseSpriteShadow<TCommandBuffer>::getPredictedCycles() const {
+
+  return _predictedCycles+
+         (_offsetSent ? _drawnCycles : 0)+
+         AseSpriteCost::scanCycles(_lastSpriteKnown ? getHighestVisible() : NUM_SPRITES-1);
+}
+
+
+/**
+ * Get the predicted length of the next sprite writer pass if every persistent sprite has to be
+ * drawn again
+ * @return The sprite writer cycles, including the cost of reading the records
+ */
+
+template<class TCommandBuffer>
+inline uint32_t AseSpriteShadow<TCommandBuffer>::getWorstCaseCycles() const {
+
+  return _predictedCycles+
+         _drawnCycles+
+         AseSpriteCost::scanCycles(_lastSpriteKnown ? getHighestVisible() : NUM_SPRITES-1);
+}
+
+
+/**
+ * Get the highest sprite that the FPGA holds as visible
+ * @return The sprite number, zero if none are visible
+ */
+
+template<class TCommandBuffer>
+inline uint16_t AseSpriteShadow<TCommandBuffer>::getHighestVisible() const {
+
+  int16_t i;
+
+  for(i=NUM_SPRITES/32-1;i>=0;i--)
+    if(_visible[i])
+      return i*32+31-__builtin_clz(_visible[i]);
+
+  return 0;
+}
+
+
+/**
+ * Truncate the fields to the widths held in the FPGA
+ * @param sd The definition to truncate
+ */
+
+template<class TCommandBuffer>
+inline void AseSpriteShadow<TCommandBuffer>::truncate(LoadSpriteDef& sd) {
+
+  sd.SpriteNumber&=0x1ff;
+  sd.SramAddress&=0x3ffff;
+  sd.FlashAddress&=0xffffff;
+  sd.PixelWidth&=0x1ff;
+  sd.NumPixels&=0x3ffff;
+  sd.RepeatX&=0x1ff;
+  sd.RepeatY&=0x3ff;
+  sd.Visible&=1;
+  sd.Persistent&=1;
+  sd.Mirror&=1;
+  sd.Indexed&=1;
+  sd.Spans&=1;
+  sd.FirstX&=0x1ff;
+  sd.LastX&=0x1ff;
+  sd.FirstY&=0x3ff;
+  sd.LastY&=0x3ff;
+}
+
+
+/**
+ * Compare the parts of the record that only CMD_LOAD can change
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::sameImage(const LoadSpriteDef& a,const LoadSpriteDef& b) {
+
+  return a.FlashAddress==b.FlashAddress &&
+         a.PixelWidth==b.PixelWidth &&
+         a.NumPixels==b.NumPixels &&
+         a.RepeatX==b.RepeatX &&
+         a.RepeatY==b.RepeatY &&
+         a.Mirror==b.Mirror &&
+         a.Indexed==b.Indexed &&
+         a.Spans==b.Spans;
+}
+
+
+/**
+ * Compare the clipping rectangles
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::sameClip(const LoadSpriteDef& a,const LoadSpriteDef& b) {
+
+  return a.FirstX==b.FirstX &&
+         a.LastX==b.LastX &&
+         a.FirstY==b.FirstY &&
+         a.LastY==b.LastY;
+}
+
+
+/**
+ * Account for a command that was added to the buffer and update the cost prediction
+ */
+
+template<class TCommandBuffer>
+inline void AseSpriteShadow<TCommandBuffer>::sent(uint16_t spriteNumber,bool ok,uint16_t& counter,uint16_t words) {
+
+  uint16_t index;
+  uint32_t cycles,bit;
+
+  if(ok) {
+    counter++;
+    _current.WordsSent+=words;
+
+    // the FPGA now has the shadow record. Any command means that it's drawn again.
+
+    index=spriteNumber & (NUM_SPRITES-1);
+    bit=1UL << (index & 31);
+    cycles=_states[index]==KNOWN && _records[index].Visible ? AseSpriteCost::cycles(_records[index]) : 0;
+
+    if(_drawn[index/32] & bit) {
+      _drawn[index/32]&=~bit;
+      _drawnCycles-=_cycles[index];
+    }
+    else
+      _predictedCycles-=_cycles[index];
+
+    _predictedCycles+=cycles;
+    _cycles[index]=cycles;
+
+    if(cycles)
+      _visible[index/32]|=bit;
+    else
+      _visible[index/32]&=~bit;
+  }
+  else
+    invalidate(spriteNumber);
+}
+
+
+/**
+ * Clear the visible flag if it's not already clear
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::hide(uint16_t spriteNumber) {
+
+  LoadSpriteDef& shadow(_records[spriteNumber & (NUM_SPRITES-1)]);
+  uint8_t& state(_states[spriteNumber & (NUM_SPRITES-1)]);
+  bool ok;
+
+  if(state==HIDDEN || (state==KNOWN && !shadow.Visible)) {
+    _current.Skipped++;
+    return true;
+  }
+
+  ok=_commandBuffer.hideSprite(spriteNumber);
+
+  if(state==KNOWN) {
+    shadow.Visible=0;
+    shadow.Persistent=0;
+  }
+  else
+    state=HIDDEN;
+
+  sent(spriteNumber,ok,_current.Hides,SHOWHIDE_WORDS);
+  return ok;
+}
+
+
+/**
+ * Request that the FPGA holds the given sprite definition
+ * @param sd The sprite definition
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::loadSprite(const LoadSpriteDef& request) {
+
+  LoadSpriteDef sd(request);
+  LoadSpriteDef& shadow(_records[request.SpriteNumber & (NUM_SPRITES-1)]);
+  uint8_t& state(_states[request.SpriteNumber & (NUM_SPRITES-1)]);
+  bool ok;
+
+  truncate(sd);
+
+  _current.Requests++;
+  _current.WordsRequested+=LOAD_WORDS;
+
+  // a hidden sprite only needs to be hidden
+
+  if(!sd.Visible)
+    return hide(sd.SpriteNumber);
+
+  if(state!=KNOWN || !sameImage(sd,shadow)) {
+
+    // full load required
+
+    ok=_commandBuffer.loadSprite(sd);
+    shadow=sd;
+    state=KNOWN;
+    sent(sd.SpriteNumber,ok,_current.Loads,LOAD_WORDS);
+    return ok;
+  }
+
+  if(sd.SramAddress==shadow.SramAddress && sameClip(sd,shadow)) {
+
+    // same position, maybe a change of visibility (it must be becoming visible here) or
+    // persistence. CMD_SHOW sets both.
+
+    if(shadow.Visible && shadow.Persistent==sd.Persistent) {
+      _current.Skipped++;
+      return true;
+    }
+
+    ok=_commandBuffer.showSprite(sd.SpriteNumber,sd.Persistent);
+    shadow.Visible=1;
+    shadow.Persistent=sd.Persistent;
+    sent(sd.SpriteNumber,ok,_current.Shows,SHOWHIDE_WORDS);
+    return ok;
+  }
+
+  if(sameClip(sd,shadow)) {
+
+    // just a new position. CMD_MOVE also makes it visible but leaves the persistent flag alone
+
+    ok=_commandBuffer.moveSprite(sd.SpriteNumber,sd.SramAddress);
+    sd.Persistent=shadow.Persistent;
+    shadow=sd;
+    sent(sd.SpriteNumber,ok,_current.Moves,MOVE_WORDS);
+
+    return ok && persist(request.SpriteNumber,request.Persistent);
+  }
+
+  // new position and clipping rectangle
+
+  MoveSpriteDef md;
+
+  md.SpriteNumber=sd.SpriteNumber;
+  md.SramAddress=sd.SramAddress;
+  md.FirstX=sd.FirstX;
+  md.LastX=sd.LastX;
+  md.FirstY=sd.FirstY;
+  md.LastY=sd.LastY;
+
+  ok=_commandBuffer.moveSprite(md);
+  sd.Persistent=shadow.Persistent;
+  shadow=sd;
+  sent(sd.SpriteNumber,ok,_current.MovePartials,MOVE_PARTIAL_WORDS);
+
+  return ok && persist(request.SpriteNumber,request.Persistent);
+}
+
+
+/**
+ * Set the persistent flag of a visible sprite if it's not already set that way
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::persist(uint16_t spriteNumber,bool persistent) {
+
+  LoadSpriteDef& shadow(_records[spriteNumber & (NUM_SPRITES-1)]);
+  bool ok;
+
+  if(_states[spriteNumber & (NUM_SPRITES-1)]!=KNOWN || !shadow.Visible || (shadow.Persistent!=0)==persistent) {
+    _current.Skipped++;
+    return true;
+  }
+
+  ok=_commandBuffer.showSprite(spriteNumber,persistent);
+  shadow.Persistent=persistent;
+  sent(spriteNumber,ok,_current.Shows,SHOWHIDE_WORDS);
+  return ok;
+}
+
+
+/**
+ * Request that a sprite is hidden
+ * @param spriteNumber The sprite to hide
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::hideSprite(uint16_t spriteNumber) {
+
+  _current.Requests++;
+  _current.WordsRequested+=SHOWHIDE_WORDS;
+
+  return hide(spriteNumber);
+}
+
+
+/**
+ * Request that a sprite is drawn from another slot. The record that the FPGA holds for the
+ * source is sent to the destination, or the destination is hidden if the source isn't known to
+ * be visible. The source is left alone because the caller is about to reuse it. Used to
+ * renumber sprites when one has to be fitted in between them in the drawing order.
+ * @param from The slot that has the record
+ * @param to The slot that should have it
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::copySprite(uint16_t from,uint16_t to) {
+
+  LoadSpriteDef sd;
+
+  if(_states[from & (NUM_SPRITES-1)]!=KNOWN || !_records[from & (NUM_SPRITES-1)].Visible)
+    return hideSprite(to);
+
+  sd=_records[from & (NUM_SPRITES-1)];
+  sd.SpriteNumber=to;
+
+  return loadSprite(sd);
+}
+
+
+/**
+ * Request that a visible sprite is persistent or not. Nothing is sent for a sprite that isn't
+ * known to be visible.
+ * @param spriteNumber The sprite
+ * @param persistent true if nothing on top of or underneath it changes
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::setPersistent(uint16_t spriteNumber,bool persistent) {
+
+  _current.Requests++;
+  _current.WordsRequested+=SHOWHIDE_WORDS;
+
+  return persist(spriteNumber,persistent);
+}
+
+
+/**
+ * Request a new viewport offset. It's only sent if it has changed.
+ * @param x The world X coordinate at the left of the screen
+ * @param y The world Y coordinate at the top of the screen
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::setViewportOffset(uint16_t x,uint16_t y) {
+
+  _current.Requests++;
+  _current.WordsRequested+=OFFSET_WORDS;
+
+  if(_viewportKnown && x==_viewportX && y==_viewportY) {
+    _current.Skipped++;
+    return true;
+  }
+
+  if(!_commandBuffer.setViewportOffset(x,y)) {
+    _viewportKnown=false;
+    return false;
+  }
+
+  _viewportX=x;
+  _viewportY=y;
+  _viewportKnown=true;
+  _offsetSent=true;
+
+  _current.Offsets++;
+  _current.WordsSent+=OFFSET_WORDS;
+  return true;
+}
+
+
+/**
+ * Set the last record that the sprite writer reads to the highest visible sprite. It's only
+ * sent if it has changed.
+ * @return false if the command buffer was full
+ */
+
+template<class TCommandBuffer>
+inline bool AseSpriteShadow<TCommandBuffer>::updateLastSprite() {
+
+  uint16_t last;
+
+  _current.Requests++;
+  _current.WordsRequested+=LAST_SPRITE_WORDS;
+
+  last=getHighestVisible();
+
+  if(_lastSpriteKnown && last==_lastSprite) {
+    _current.Skipped++;
+    return true;
+  }
+
+  if(!_commandBuffer.setLastSprite(last)) {
+    _lastSpriteKnown=false;
+    return false;
+  }
+
+  _lastSprite=last;
+  _lastSpriteKnown=true;
+
+  _current.LastSprites++;
+  _current.WordsSent+=LAST_SPRITE_WORDS;
+  return true;
+}
+
+
+/**
+ * Call at the end of each frame, after the flush, to latch and reset the counters. The pass
+ * that's about to start draws the persistent sprites that aren't already drawn, so the one
+ * after it won't.
+ */
+
+template<class TCommandBuffer>
+inline void AseSpriteShadow<TCommandBuffer>::endFrame() {
+
+  uint32_t pending;
+  uint16_t i,index;
+
+  _current.PredictedCycles=getPredictedCycles();
+  _last=_current;
+  memset(&_current,0,sizeof(_current));
+
+  for(i=0;i<NUM_SPRITES/32;i++) {
+
+    for(pending=_visible[i] & ~_drawn[i];pending;pending&=pending-1) {
+
+      index=i*32+__builtin_ctz(pending);
+
+      if(_states[index]==KNOWN && _records[index].Persistent) {
+        _drawn[i]|=1UL << (index & 31);
+        _predictedCycles-=_cycles[index];
+        _drawnCycles+=_cycles[index];
+      }
+    }
+  }
+
+  _offsetSent=false;
+}
+
+
+/**
+ * Get the counters for the last completed frame
+ * @return The counters
+ */
+
+template<class TCommandBuffer>
+inline const typename AseSpriteShadow<TCommandBuffer>::Statistics& AseSpriteShadow<TCommandBuffer>::getLastFrameStatistics() const {
+  return _last;
+}
@@ -96,7 +96,7 @@ inline void FpgaProgrammer::program() {
 
   doneFlag=false;
   count=0;
-  bitSize=reinterpret_cast<uint32_t>(&BitFileSize);
+  bitSize=static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&BitFileSize));
   toggle=true;
 
   for(ptr=reinterpret_cast<uint8_t *>(&BitFileStart);;ptr++) {
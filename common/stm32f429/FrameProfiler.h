@@ -0,0 +1,465 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+#if defined(ASE_EMULATOR)
+#include <chrono>
+#endif
+
+
+/**
+ * The time source for the profiler. On the board it's the DWT cycle counter so the resolution
+ * is one core clock. On the host it's std::chrono::steady_clock in nanoseconds. Either way the
+ * ticks are a free running 32-bit count that's only ever used for differences.
+ */
+
+class ProfileClock {
+
+  public:
+    static void initialise();
+    static uint32_t now();
+    static uint32_t ticksPerMicrosecond();
+};
+
+
+/**
+ * Start the counter
+ */
+
+inline void ProfileClock::initialise() {
+
+#if !defined(ASE_EMULATOR)
+
+  CoreDebug->DEMCR|=CoreDebug_DEMCR_TRCENA_Msk;
+  DWT->CYCCNT=0;
+  DWT->CTRL|=DWT_CTRL_CYCCNTENA_Msk;
+
+#endif
+}
+
+
+/**
+ * Get the current tick count
+ * @return The ticks
+ */
+
+inline uint32_t ProfileClock::now() {
+
+#if defined(ASE_EMULATOR)
+
+  return static_cast<uint32_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(
+          std::chrono::steady_clock::now().time_since_epoch()
+        ).count()
+    );
+
+#else
+
+  return DWT->CYCCNT;
+
+#endif
+}
+
+
+/**
+ * Get the tick rate
+ * @return Ticks per microsecond
+ */
+
+inline uint32_t ProfileClock::ticksPerMicrosecond() {
+
+#if defined(ASE_EMULATOR)
+  return 1000;
+#else
+  return SystemCoreClock/1000000;
+#endif
+}
+
+
+/**
+ * A log2 histogram of a per-frame measurement. Bucket 0 counts zeros and bucket N counts values
+ * in [2^(N-1),2^N). The top bucket takes everything from 2^30 upwards.
+ */
+
+struct ProfileHistogram {
+
+  enum {
+    NUM_BUCKETS = 32
+  };
+
+  uint16_t Buckets[NUM_BUCKETS];
+  uint16_t Count;
+  uint32_t Min;
+  uint32_t Max;
+  uint64_t Total;
+
+  void clear() {
+    memset(Buckets,0,sizeof(Buckets));
+    Count=0;
+    Min=UINT32_MAX;
+    Max=0;
+    Total=0;
+  }
+
+  void add(uint32_t value) {
+
+    uint8_t bucket;
+
+    bucket=value==0 ? 0 : 32-__builtin_clz(value);
+    if(bucket>=NUM_BUCKETS)
+      bucket=NUM_BUCKETS-1;
+
+    Buckets[bucket]++;
+    Count++;
+    Total+=value;
+
+    if(value<Min)
+      Min=value;
+    if(value>Max)
+      Max=value;
+  }
+};
+
+
+/**
+ * Per-phase frame profiler. Each frame the phases are timed with ProfileClock and the results
+ * are added to the histograms of the current block. When a block has seen TFramesPerBlock
+ * frames the next one in the ring is cleared and used, so the ring always holds the recent
+ * history in blocks that can be compared with each other.
+ *
+ * A phase that isn't both started and stopped in a frame isn't recorded for that frame.
+ *
+ * @tparam TBlocks The number of blocks in the ring
+ * @tparam TFramesPerBlock The number of frames in a block
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+class FrameProfiler {
+
+  public:
+
+    /**
+     * The measurements. The time metrics are in ProfileClock ticks.
+     */
+
+    enum Metric {
+      BUSY,             // BUSY_START to BUSY_END
+      BACKGROUND,       // Background::update()
+      ACTORS,           // the actor updates
+      FLUSH,            // sending the commands
+      WORDS,            // bus words sent
+      NUM_METRICS
+    };
+
+    /**
+     * One block of history
+     */
+
+    struct Block {
+      uint32_t FirstFrame;
+      uint16_t Frames;
+      ProfileHistogram Histograms[NUM_METRICS];
+    };
+
+  protected:
+    Block _blocks[TBlocks];
+    uint8_t _current;
+    uint8_t _used;
+    uint32_t _frameNumber;
+    uint32_t _starts[NUM_METRICS];
+    uint32_t _values[NUM_METRICS];
+    uint8_t _started;
+    uint8_t _recorded;
+
+  protected:
+    void newBlock();
+
+    template<class TOutput>
+    static void writeTime(TOutput& output,uint64_t ticks);
+
+  public:
+    FrameProfiler();
+
+    void start(Metric metric);
+    void stop(Metric metric);
+    void record(Metric metric,uint32_t value);
+    void endFrame();
+
+    uint8_t getBlockCount() const;
+    const Block& getBlock(uint8_t age) const;
+
+    template<class TOutput>
+    void dump(TOutput& output) const;
+};
+
+
+/**
+ * Constructor
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline FrameProfiler<TBlocks,TFramesPerBlock>::FrameProfiler()
+  : _current(TBlocks-1),
+    _used(0),
+    _frameNumber(0),
+    _started(0),
+    _recorded(0) {
+
+  static_assert(NUM_METRICS<=8,"The metric masks are 8 bits");
+
+  ProfileClock::initialise();
+  newBlock();
+}
+
+
+/**
+ * Move to the next block in the ring and clear it
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::newBlock() {
+
+  uint8_t i;
+
+  _current=(_current+1) % TBlocks;
+  if(_used<TBlocks)
+    _used++;
+
+  Block& block(_blocks[_current]);
+
+  block.FirstFrame=_frameNumber;
+  block.Frames=0;
+
+  for(i=0;i<NUM_METRICS;i++)
+    block.Histograms[i].clear();
+}
+
+
+/**
+ * Start timing a phase
+ * @param metric The phase
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::start(Metric metric) {
+  _starts[metric]=ProfileClock::now();
+  _started|=1 << metric;
+}
+
+
+/**
+ * Stop timing a phase. Ignored if it wasn't started.
+ * @param metric The phase
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::stop(Metric metric) {
+
+  if(_started & (1 << metric)) {
+    record(metric,ProfileClock::now()-_starts[metric]);
+    _started&=~(1 << metric);
+  }
+}
+
+
+/**
+ * Record a value for this frame. A second value for the same metric replaces the first.
+ * @param metric The metric
+ * @param value The value
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::record(Metric metric,uint32_t value) {
+  _values[metric]=value;
+  _recorded|=1 << metric;
+}
+
+
+/**
+ * Add this frame's values to the current block
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::endFrame() {
+
+  uint8_t i;
+
+  if(_blocks[_current].Frames==TFramesPerBlock)
+    newBlock();
+
+  Block& block(_blocks[_current]);
+
+  for(i=0;i<NUM_METRICS;i++)
+    if(_recorded & (1 << i))
+      block.Histograms[i].add(_values[i]);
+
+  block.Frames++;
+  _frameNumber++;
+  _recorded=0;
+}
+
+
+/**
+ * Get the number of blocks that hold data
+ * @return The count, at most TBlocks
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline uint8_t FrameProfiler<TBlocks,TFramesPerBlock>::getBlockCount() const {
+  return _used;
+}
+
+
+/**
+ * Get a block
+ * @param age 0 is the current block, 1 the one before it and so on
+ * @return The block
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+inline const typename FrameProfiler<TBlocks,TFramesPerBlock>::Block& FrameProfiler<TBlocks,TFramesPerBlock>::getBlock(uint8_t age) const {
+  return _blocks[(_current+TBlocks-age) % TBlocks];
+}
+
+
+/**
+ * Write a tick count in microseconds to one decimal place
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+template<class TOutput>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::writeTime(TOutput& output,uint64_t ticks) {
+
+  uint32_t tenths;
+
+  tenths=static_cast<uint32_t>(ticks*10/ProfileClock::ticksPerMicrosecond());
+  output << tenths/10 << "." << tenths%10 << "us";
+}
+
+
+/**
+ * Write the ring as text, oldest block first. The output can be anything with operator<< for
+ * const char * and uint32_t: an stm32plus TextOutputStream on a UsartPollingOutputStream,
+ * a SemihostingOutput or a std::ostream on the host. One line per metric:
+ *
+ *   busy n=64 min=11200.3us mean=11931.0us max=13511.9us | 2^21:12 2^22:52
+ *
+ * The bucket labels are the upper bounds in ticks (or words).
+ *
+ * @param output Where to write it
+ */
+
+template<uint8_t TBlocks,uint16_t TFramesPerBlock>
+template<class TOutput>
+inline void FrameProfiler<TBlocks,TFramesPerBlock>::dump(TOutput& output) const {
+
+  static const char *names[NUM_METRICS]={ "busy","background","actors","flush","words" };
+  uint8_t age,i,b;
+
+  for(age=_used;age-->0;) {
+
+    const Block& block(getBlock(age));
+
+    output << "frames " << block.FirstFrame << "-" << block.FirstFrame+block.Frames-1 << "\r\n";
+
+    for(i=0;i<NUM_METRICS;i++) {
+
+      const ProfileHistogram& h(block.Histograms[i]);
+
+      if(h.Count==0)
+        continue;
+
+      output << "  " << names[i] << " n=" << static_cast<uint32_t>(h.Count) << " min=";
+
+      if(i==WORDS) {
+        output << h.Min << " mean=" << static_cast<uint32_t>(h.Total/h.Count) << " max=" << h.Max;
+      }
+      else {
+        writeTime(output,h.Min);
+        output << " mean=";
+        writeTime(output,h.Total/h.Count);
+        output << " max=";
+        writeTime(output,h.Max);
+      }
+
+      output << " |";
+
+      for(b=0;b<ProfileHistogram::NUM_BUCKETS;b++)
+        if(h.Buckets[b])
+          output << " 2^" << static_cast<uint32_t>(b) << ":" << static_cast<uint32_t>(h.Buckets[b]);
+
+      output << "\r\n";
+    }
+  }
+}
+
+
+#if !defined(ASE_EMULATOR)
+
+/**
+ * Minimal text output over ARM semihosting (SYS_WRITE0) for use with FrameProfiler::dump().
+ * The core stops at the BKPT if no debugger is attached, so only use it under a debugger.
+ */
+
+class SemihostingOutput {
+
+  protected:
+    static void write0(const char *str);
+
+  public:
+    SemihostingOutput& operator<<(const char *str);
+    SemihostingOutput& operator<<(uint32_t value);
+};
+
+
+/**
+ * Send a null terminated string to the host
+ */
+
+inline void SemihostingOutput::write0(const char *str) {
+
+  __asm volatile(
+    " mov  r0, #4        \n\t"        // SYS_WRITE0
+    " mov  r1, %[str]    \n\t"
+    " bkpt 0xab          \n\t"
+    :: [str] "r" (str)
+    : "r0", "r1", "memory"
+  );
+}
+
+
+/**
+ * Write a string
+ */
+
+inline SemihostingOutput& SemihostingOutput::operator<<(const char *str) {
+  write0(str);
+  return *this;
+}
+
+
+/**
+ * Write an unsigned decimal number
+ */
+
+inline SemihostingOutput& SemihostingOutput::operator<<(uint32_t value) {
+
+  char buffer[11],*ptr;
+
+  ptr=buffer+sizeof(buffer)-1;
+  *ptr='\0';
+
+  do {
+    *--ptr='0'+value%10;
+    value/=10;
+  } while(value);
+
+  write0(ptr);
+  return *this;
+}
+
+#endif
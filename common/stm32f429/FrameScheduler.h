@@ -0,0 +1,333 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/**
+ * Interrupt driven frame scheduler. An EXTI interrupt on both edges of the FPGA BUSY pin (PC14)
+ * marks the phase as pending and the main loop runs the callback registered for it:
+ *
+ *   BUSY_START: the FPGA has started drawing the sprites. Compute the next frame but don't
+ *               touch the bus, BRAM writes are lost while BUSY is high.
+ *   BUSY_END:   the FPGA has finished with the BRAM. Send the commands.
+ *   IDLE:       nothing is pending. If there's no callback then the core sleeps with WFI
+ *               until the next interrupt.
+ *
+ * Callbacks run in thread mode, never in the interrupt. The exception is an interrupt callback
+ * registered with setInterruptCallback(), which is called from the EXTI handler as soon as the
+ * edge is seen and before the phase is made pending. It must be short and it can only share data
+ * with thread mode through something that's safe to use from both, such as an AseCommandQueue.
+ *
+ * Overruns are counted and the scheduler carries on. A busy period longer than one TE period
+ * means too many graphics and a BUSY_END callback that's still running when the next busy period
+ * starts means too much work. A BUSY_END callback is never run while BUSY is high, if its window
+ * has passed it's skipped and counted.
+ */
+
+class FrameScheduler {
+
+  public:
+
+    /**
+     * The phases of a frame
+     */
+
+    enum Phase {
+      BUSY_START,
+      BUSY_END,
+      IDLE,
+      NUM_PHASES
+    };
+
+    /**
+     * Phase callback. The context is whatever was passed to setCallback().
+     */
+
+    typedef void (*Callback)(void *context);
+
+    /**
+     * Counters maintained by the interrupt handler and the dispatcher
+     */
+
+    struct Statistics {
+      uint32_t Frames;            // busy periods that have ended
+      uint32_t BusyOverruns;      // busy periods longer than BUSY_BUDGET_MILLIS
+      uint32_t WorkOverruns;      // BUSY_END callbacks still running when BUSY went high again
+      uint32_t MissedFrames;      // BUSY_END windows that passed without the callback being run
+      uint32_t LastBusyMillis;    // duration of the last busy period
+    };
+
+  protected:
+
+    enum {
+      BUSY_PIN = 14,              // PC14
+      BUSY_BUDGET_MILLIS = 16     // one TE period at 61Hz
+    };
+
+    struct Slot {
+      Callback Function;
+      void *Context;
+    };
+
+    Slot _slots[NUM_PHASES];
+    Slot _interruptSlots[NUM_PHASES];
+    GpioPinRef _busyPin;
+    Exti14 _exti;
+
+    volatile uint8_t _pending;
+    volatile bool _inBusyEnd;
+    volatile uint32_t _busyStartMillis;
+    volatile Statistics _statistics;
+
+  protected:
+    void onInterrupt(uint8_t extiLine);
+    void call(Phase phase);
+    void callInterrupt(Phase phase);
+    void callBusyEnd();
+
+  public:
+    FrameScheduler();
+
+    void setCallback(Phase phase,Callback function,void *context);
+    void setInterruptCallback(Phase phase,Callback function,void *context);
+
+    bool dispatch();
+    void run();
+
+    bool isBusy() const;
+    Statistics getStatistics() const;
+};
+
+
+/**
+ * Constructor. The interrupt is enabled immediately so the scheduler should be created after
+ * the FPGA has been programmed.
+ */
+
+inline FrameScheduler::FrameScheduler()
+  : _busyPin(GpioC<DefaultDigitalInputFeature<BUSY_PIN>>()[BUSY_PIN]),
+    _exti(EXTI_Mode_Interrupt,EXTI_Trigger_Rising_Falling,_busyPin),
+    _pending(0),
+    _inBusyEnd(false),
+    _busyStartMillis(0) {
+
+  uint8_t i;
+
+  for(i=0;i<NUM_PHASES;i++) {
+    _slots[i].Function=nullptr;
+    _slots[i].Context=nullptr;
+    _interruptSlots[i].Function=nullptr;
+    _interruptSlots[i].Context=nullptr;
+  }
+
+  _statistics.Frames=0;
+  _statistics.BusyOverruns=0;
+  _statistics.WorkOverruns=0;
+  _statistics.MissedFrames=0;
+  _statistics.LastBusyMillis=0;
+
+  _exti.ExtiInterruptEventSender.insertSubscriber(
+      ExtiInterruptEventSourceSlot::bind(this,&FrameScheduler::onInterrupt)
+    );
+}
+
+
+/**
+ * Register the callback for a phase. Pass nullptr to remove it.
+ * @param phase The phase
+ * @param function The function to call
+ * @param context Passed to the function
+ */
+
+inline void FrameScheduler::setCallback(Phase phase,Callback function,void *context) {
+  _slots[phase].Function=function;
+  _slots[phase].Context=context;
+}
+
+
+/**
+ * Register the callback that's run in the interrupt for the edge that starts a phase. Pass
+ * nullptr to remove it. The IDLE phase has no edge so its interrupt callback is never run.
+ * @param phase The phase
+ * @param function The function to call
+ * @param context Passed to the function
+ */
+
+inline void FrameScheduler::setInterruptCallback(Phase phase,Callback function,void *context) {
+
+  __disable_irq();
+
+  _interruptSlots[phase].Function=function;
+  _interruptSlots[phase].Context=context;
+
+  __enable_irq();
+}
+
+
+/**
+ * BUSY edge interrupt. Record what happened and run the interrupt callback for the edge, the
+ * rest of the work is done in dispatch().
+ * @param extiLine The EXTI line (14)
+ */
+
+inline void FrameScheduler::onInterrupt(uint8_t /* extiLine */) {
+
+  uint32_t now;
+
+  now=MillisecondTimer::millis();
+
+  if(_busyPin.read()) {
+
+    // the FPGA has started drawing
+
+    _busyStartMillis=now;
+
+    if(_inBusyEnd)
+      _statistics.WorkOverruns++;
+
+    callInterrupt(BUSY_START);
+    _pending|=1 << BUSY_START;
+  }
+  else {
+
+    // the FPGA has finished drawing
+
+    _statistics.Frames++;
+    _statistics.LastBusyMillis=now-_busyStartMillis;
+
+    if(_statistics.LastBusyMillis>BUSY_BUDGET_MILLIS)
+      _statistics.BusyOverruns++;
+
+    if(_pending & (1 << BUSY_END))
+      _statistics.MissedFrames++;
+
+    callInterrupt(BUSY_END);
+    _pending|=1 << BUSY_END;
+  }
+}
+
+
+/**
+ * Call the callback for a phase if there is one
+ * @param phase The phase
+ */
+
+inline void FrameScheduler::call(Phase phase) {
+
+  if(_slots[phase].Function)
+    _slots[phase].Function(_slots[phase].Context);
+}
+
+
+/**
+ * Call the interrupt callback for a phase if there is one
+ * @param phase The phase
+ */
+
+inline void FrameScheduler::callInterrupt(Phase phase) {
+
+  if(_interruptSlots[phase].Function)
+    _interruptSlots[phase].Function(_interruptSlots[phase].Context);
+}
+
+
+/**
+ * Run the callbacks for the pending phases. If nothing is pending then run the idle callback
+ * or sleep until the next interrupt.
+ * @return true if a BUSY_START or BUSY_END callback was run
+ */
+
+inline bool FrameScheduler::dispatch() {
+
+  uint8_t pending;
+
+  // take the pending flags. Interrupts are disabled across the check and the WFI so that
+  // an edge can't sneak in between them. WFI still wakes up on the pending interrupt.
+
+  __disable_irq();
+
+  if((pending=_pending)==0 && !_slots[IDLE].Function)
+    __WFI();
+
+  _pending=0;
+  __enable_irq();
+
+  if(pending==0) {
+    call(IDLE);
+    return false;
+  }
+
+  // if BUSY is high again then we've fallen so far behind that the BUSY_END window has gone.
+  // The bus isn't safe so the callback is skipped and its work is left for the next one.
+
+  if((pending & (1 << BUSY_END)) && _busyPin.read()) {
+    _statistics.MissedFrames++;
+    pending&=~(1 << BUSY_END);
+  }
+
+  if(pending & (1 << BUSY_START))
+    call(BUSY_START);
+
+  if(pending & (1 << BUSY_END))
+    callBusyEnd();
+
+  return true;
+}
+
+
+/**
+ * Call the BUSY_END callback and flag that it's running
+ */
+
+inline void FrameScheduler::callBusyEnd() {
+  _inBusyEnd=true;
+  call(BUSY_END);
+  _inBusyEnd=false;
+}
+
+
+/**
+ * Dispatch forever
+ */
+
+inline void FrameScheduler::run() {
+  for(;;)
+    dispatch();
+}
+
+
+/**
+ * Get the current state of the BUSY pin
+ * @return true if the FPGA is drawing
+ */
+
+inline bool FrameScheduler::isBusy() const {
+  return _busyPin.read();
+}
+
+
+/**
+ * Get a consistent copy of the counters
+ * @return The counters
+ */
+
+inline FrameScheduler::Statistics FrameScheduler::getStatistics() const {
+
+  Statistics s;
+
+  __disable_irq();
+
+  s.Frames=_statistics.Frames;
+  s.BusyOverruns=_statistics.BusyOverruns;
+  s.WorkOverruns=_statistics.WorkOverruns;
+  s.MissedFrames=_statistics.MissedFrames;
+  s.LastBusyMillis=_statistics.LastBusyMillis;
+
+  __enable_irq();
+
+  return s;
+}
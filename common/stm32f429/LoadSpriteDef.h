@@ -13,10 +13,10 @@
 
 struct LoadSpriteDef {
   uint16_t SpriteNumber;      // sprite number (0..511)
-  uint32_t SramAddress;       // pixel address on the screen (y * 360) + x
+  uint32_t SramAddress;       // pixel address (y * 360) + x, less the viewport offset when drawn
   uint32_t FlashAddress;      // flash address of the graphic
   uint16_t PixelWidth;        // width of this sprite in pixels
-  uint32_t NumPixels;         // total number of pixels
+  uint32_t NumPixels;         // total number of pixels, or of flash words for a span sprite
   uint16_t RepeatX;           // number of times to repeat on X axis (minimum = 1)
   uint16_t RepeatY;           // number of times to repeat on Y axis (minimum = 1)
   uint8_t Visible;            // 1 if visible, 0 if hidden
@@ -24,4 +24,8 @@ struct LoadSpriteDef {
   uint16_t LastX;             // last visible X column (or 359 if fully on screen)
   uint16_t FirstY;            // first visible Y column (or zero if fully on screen)
   uint16_t LastY;             // last visible Y column (or 639 if fully on screen)
+  uint8_t Persistent;         // 1 if nothing on or under it changes so it need only be drawn once
+  uint8_t Mirror;             // 1 to draw the rows bottom up from SramAddress, the bottom row
+  uint8_t Indexed;            // 1 if the flash holds one palette index byte per pixel
+  uint8_t Spans;              // 1 if the flash holds runs of opaque pixels with span headers
 };
@@ -13,7 +13,7 @@
 
 struct MoveSpriteDef {
   uint16_t SpriteNumber;      // sprite number (0..511)
-  uint32_t SramAddress;       // pixel address on the screen (y * 360) + x
+  uint32_t SramAddress;       // pixel address (y * 360) + x, less the viewport offset when drawn
   uint16_t FirstX;            // first visible X column (or zero if fully on screen)
   uint16_t LastX;             // last visible X column (or 359 if fully on screen)
   uint16_t FirstY;            // first visible Y column (or zero if fully on screen)
@@ -11,11 +11,10 @@
 #include "config/stm32plus.h"
 #include "config/timing.h"
 #include "config/display/tft.h"
-#include "config/fx.h"
 #include "config/smartptr.h"
+#include "config/exti.h"
 
 using namespace stm32plus;
-using namespace stm32plus::fx;
 using namespace stm32plus::display;
 
 // common ASE includes
@@ -23,6 +22,13 @@ using namespace stm32plus::display;
 #include "Error.h"
 #include "FpgaProgrammer.h"
 #include "AseAccessMode.h"
+#include "AseIndexes.h"
+#include "AseCommandQueue.h"
+#include "AseSpriteCost.h"
+#include "AseSpriteShadow.h"
+#include "AseSpriteBudget.h"
+#include "FrameScheduler.h"
+#include "FrameProfiler.h"
 
 // local application includes
 
@@ -31,20 +37,21 @@ using namespace stm32plus::display;
 #include "world/EasingType.h"
 #include "world/AnimationType.h"
 #include "world/EasingMode.h"
+#include "world/EasingTable.h"
+#include "world/FrameTime.h"
 #include "world/defs/SpriteDefs.h"
 #include "world/BackgroundSprites.h"
 #include "world/PathSprites.h"
+#include "world/PathPalette.h"
 #include "world/defs/PathDef.h"
 #include "world/defs/ActorDef.h"
 #include "world/defs/LevelDef.h"
 #include "world/defs/ActorDef.h"
 #include "world/Background.h"
-#include "world/PathBase.h"
-#include "world/MovingPath.h"
-#include "world/StaticPath.h"
-#include "world/Actor.h"
+#include "world/ActorGrid.h"
+#include "world/SpriteSlotAllocator.h"
+#include "world/ActorEngine.h"
 #include "world/Level1.h"
 #include "world/World.h"
-#include "FpgaBusyMonitor.h"
 #include "Introduction.h"
 #include "ManicKnights.h"
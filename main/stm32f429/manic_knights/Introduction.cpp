@@ -13,7 +13,11 @@
 
 Introduction::Introduction(Panel& panel)
   : _panel(panel),
-    _world(panel,Level1) {
+    _world(panel,Level1),
+    _frameCounter(0),
+    _commandOverflows(0),
+    _lateFrames(0),
+    _framePrepared(false) {
 }
 
 
@@ -23,10 +27,6 @@ Introduction::Introduction(Panel& panel)
 
 void Introduction::run() {
 
-  uint32_t start,busy_elapsed,frame_counter;
-  uint32_t free_elapsed __attribute__((unused));
-  Buttons buttons;
-
   // fade up the backlight to 90%
 
   _panel.setBacklight(90);
@@ -36,27 +36,95 @@ void Introduction::run() {
 
   _panel.enableSpriteMode();
 
-  // create a busy monitor
+  // the indexed sprites' palette can only be written while the FPGA isn't drawing. The first
+  // pass in sprite mode has no visible sprites so it's over almost as soon as it starts.
+
+  _panel.getAccessMode().waitBusyStart();
+  _panel.getAccessMode().waitBusyEnd();
+  _panel.getAccessMode().loadPalette(PathPalette,0,PATH_PALETTE_COUNT);
 
-  FpgaBusyMonitor busyMonitor;
+  // the next frame is computed while the FPGA is drawing this one and the commands that were
+  // queued are sent from the interrupt as soon as it has finished. The core sleeps the rest
+  // of the time.
 
-  // infinite loop
+  FrameScheduler scheduler;
 
-  for(frame_counter=0;;frame_counter++) {
+  scheduler.setCallback(FrameScheduler::BUSY_START,&Introduction::onBusyStart,this);
+  scheduler.setInterruptCallback(FrameScheduler::BUSY_END,&Introduction::onBusyFalling,this);
+  scheduler.setCallback(FrameScheduler::BUSY_END,&Introduction::onBusyEnd,this);
+  scheduler.run();
+}
 
-    // wait for busy to go high and then back to low
 
-    while(!busyMonitor.isBusy());
-    start=MillisecondTimer::millis();
-    while(busyMonitor.isBusy());
-    busy_elapsed=MillisecondTimer::millis()-start;
-    if(busy_elapsed>16)
-      for(;;);          // lock up so a debugger break can detect this 'too many graphics' case
+/*
+ * Update the world and queue the command stream for the next frame. Nothing is written to the
+ * bus so this is safe to do while BUSY is high. The frame can't be sent until it's committed.
+ * If the queue overflowed then the sprite shadow has forgotten the lost sprites and they'll be
+ * sent again next time.
+ */
 
-    // update the sprites based on the state of the world
+void Introduction::prepareFrame() {
+
+  _world.update(_buttons,_frameCounter++);
+  _world.getProfiler().record(World::Profiler::WORDS,_panel.getCommandQueue().getWordCount());
+
+  if(!_panel.commitCommands())
+    _commandOverflows++;
+
+  _framePrepared=true;
+}
+
+
+/*
+ * BUSY has gone high. The FPGA owns the sprite memory for the next 16ms or so and that's when
+ * we do the work for the following frame.
+ */
+
+void Introduction::onBusyStart(void *context) {
+
+  Introduction& intro(*static_cast<Introduction *>(context));
+
+  intro._world.getProfiler().start(World::Profiler::BUSY);
+  intro.prepareFrame();
+}
 
-    start=MillisecondTimer::millis();
-    _world.update(buttons,frame_counter);
-    free_elapsed=MillisecondTimer::millis()-start;
+
+/*
+ * Interrupt: BUSY has gone low. Send the committed frames straight away, whatever the main
+ * loop happens to be doing.
+ */
+
+void Introduction::onBusyFalling(void *context) {
+  static_cast<Introduction *>(context)->_panel.drainCommands();
+}
+
+
+/*
+ * BUSY has gone low and the interrupt has sent what was committed. If there's no prepared
+ * frame, e.g. the scheduler started during a busy period, then it's built now at the cost of a
+ * late flush. A frame that was committed after the edge missed the interrupt so it's sent from
+ * here, with the interrupt held off so that the queue still has just one consumer. The profile
+ * can be read out with _world.getProfiler().dump() to a UART text stream or a SemihostingOutput.
+ */
+
+void Introduction::onBusyEnd(void *context) {
+
+  Introduction& intro(*static_cast<Introduction *>(context));
+  World::Profiler& profiler(intro._world.getProfiler());
+
+  profiler.stop(World::Profiler::BUSY);
+
+  if(!intro._framePrepared) {
+    intro.prepareFrame();
+    intro._lateFrames++;
   }
+
+  __disable_irq();
+  intro._panel.drainCommands();
+  __enable_irq();
+
+  profiler.record(World::Profiler::FLUSH,intro._panel.getDrainTicks());
+  profiler.endFrame();
+
+  intro._framePrepared=false;
 }
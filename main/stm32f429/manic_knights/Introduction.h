@@ -16,6 +16,18 @@ class Introduction {
   public:
     Panel& _panel;
     World _world;
+    Buttons _buttons;
+    uint32_t _frameCounter;
+    uint32_t _commandOverflows;
+    uint32_t _lateFrames;
+    bool _framePrepared;
+
+  protected:
+    void prepareFrame();
+
+    static void onBusyStart(void *context);
+    static void onBusyFalling(void *context);
+    static void onBusyEnd(void *context);
 
   public:
     Introduction(Panel& panel);
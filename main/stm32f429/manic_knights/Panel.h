@@ -21,11 +21,28 @@ class Panel {
 
     typedef R61523_Portrait_64K_TypeB<AseAccessMode> LcdPanel;
 
+    /*
+     * The sprite commands for each frame are queued here and sent from the BUSY falling edge
+     * interrupt. The worst case frame is a full background reload (77 x 17 words) plus a hide
+     * and a load for every actor, and there's room for one to wait while the next is built.
+     */
+
+    typedef AseCommandQueue<4096> CommandQueue;
+
+    /*
+     * Sprite requests go through the shadow so that only what has changed reaches the queue
+     */
+
+    typedef AseSpriteShadow<CommandQueue> SpriteShadow;
+
   protected:
 
     AseAccessMode& _accessMode;
     LcdPanel _gl;
     R61523PwmBacklight<AseAccessMode> _backlight;
+    CommandQueue _commandQueue;
+    SpriteShadow _spriteShadow;
+    volatile uint32_t _drainTicks;
 
   public:
     Panel(AseAccessMode& accessMode);
@@ -34,6 +51,11 @@ class Panel {
     void setBacklight(uint8_t percentage);
 
     AseAccessMode& getAccessMode();
+    CommandQueue& getCommandQueue();
+    SpriteShadow& getSpriteShadow();
+    bool commitCommands();
+    void drainCommands();
+    uint32_t getDrainTicks() const;
 
     uint16_t getHeight() const;
 };
@@ -46,7 +68,9 @@ class Panel {
 inline Panel::Panel(AseAccessMode& accessMode)
   : _accessMode(accessMode),
     _gl(_accessMode),
-    _backlight(_accessMode) {
+    _backlight(_accessMode),
+    _spriteShadow(_commandQueue),
+    _drainTicks(0) {
 
   // backlight off
 
@@ -116,6 +140,75 @@ inline AseAccessMode& Panel::getAccessMode() {
 }
 
 
+/*
+ * Get a reference to the command queue
+ */
+
+inline Panel::CommandQueue& Panel::getCommandQueue() {
+  return _commandQueue;
+}
+
+
+/*
+ * Get a reference to the sprite shadow
+ */
+
+inline Panel::SpriteShadow& Panel::getSpriteShadow() {
+  return _spriteShadow;
+}
+
+
+/*
+ * Thread mode: the frame's commands are complete. The sprite writer's active range is brought
+ * up to date and the frame is published for drainCommands() to send. Returns false if any
+ * commands were lost because the queue was full, or if the frame couldn't be published because
+ * all the frame markers are waiting to be sent. An unpublished frame stays open and joins the
+ * next one, and the sprite shadow isn't told that its persistent sprites were drawn.
+ */
+
+inline bool Panel::commitCommands() {
+
+  bool ok;
+
+  _spriteShadow.updateLastSprite();
+
+  ok=!_commandQueue.isOverflowed();
+
+  if(!_commandQueue.endFrame())
+    return false;
+
+  _spriteShadow.endFrame();
+
+  return ok;
+}
+
+
+/*
+ * Send the published frames to the FPGA while BUSY is low. Call it from the BUSY falling edge
+ * interrupt, or from thread mode with interrupts disabled to catch a frame that was published
+ * after the edge.
+ */
+
+inline void Panel::drainCommands() {
+
+  uint32_t start;
+
+  start=ProfileClock::now();
+
+  if(_commandQueue.drain(_accessMode))
+    _drainTicks=ProfileClock::now()-start;
+}
+
+
+/*
+ * Get the time taken by the last drainCommands() that sent anything, in ProfileClock ticks
+ */
+
+inline uint32_t Panel::getDrainTicks() const {
+  return _drainTicks;
+}
+
+
 /*
  * Return the panel height
  */
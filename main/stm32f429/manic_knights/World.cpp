@@ -14,22 +14,8 @@
 World::World(Panel& panel,const LevelDef& ldef)
   : _levelDef(ldef),
     _panel(panel),
-    _background(panel,ldef) {
-
-  createActors(panel);
-}
-
-
-/*
- * Destructor
- */
-
-World::~World() {
-
-  for(int i=0;i<_levelDef.ActorCount;i++)
-    delete &_actors[i];
-
-  free(_actors);
+    _background(panel,ldef),
+    _actors(panel,ldef) {
 }
 
 
@@ -40,8 +26,6 @@ World::~World() {
 void World::update(const Buttons& buttons,uint32_t frame_counter) {
 
   Point topLeft(_background.getTopLeft());
-  uint16_t i;
-  float f;
 
   // sample the navigation buttons
 
@@ -61,30 +45,34 @@ void World::update(const Buttons& buttons,uint32_t frame_counter) {
 
   // update the components
 
+  _profiler.start(Profiler::BACKGROUND);
   _background.update();
+  _profiler.stop(Profiler::BACKGROUND);
 
-  f=static_cast<float>(frame_counter);
-  for(i=0;i<_levelDef.ActorCount;i++)
-    _actors[i]->update(f,_background.getTopLeft());
-}
+  // the background is always drawn. The actors share what's left of the sprite writer's
+  // time, nearest to the centre of the screen first.
 
+  _profiler.start(Profiler::ACTORS);
 
-/*
- * Create the actors for this level
- */
+  _budget.beginFrame(getFixedCycles());
+  _actors.update(FrameTime::fromFrames(frame_counter),_background.getTopLeft(),_budget);
 
-void World::createActors(Panel& panel) {
+  // the tiles that no actor is drawn over only need drawing once
 
-  uint16_t i,fpgaSpriteIndex;
+  _actors.cover(_background);
+  _background.updatePersistence();
 
-  // actor has a non-default constructor with reference members
+  _profiler.stop(Profiler::ACTORS);
+}
 
-  _actors=reinterpret_cast<Actor **>(malloc(sizeof(Actor)*_levelDef.ActorCount));
 
-  fpgaSpriteIndex=FIRST_PATH_SPRITE;
+/*
+ * Get the predicted cost of the sprites that aren't actors, i.e. what the sprite writer will
+ * need if every actor is hidden. The persistent tiles are counted in full because the actors
+ * that are admitted may be drawn over them.
+ */
 
-  // initialise array
+uint32_t World::getFixedCycles() const {
 
-  for(i=0;i<_levelDef.ActorCount;i++)
-    _actors[i]=new Actor(panel,_levelDef.ActorDefs[i],fpgaSpriteIndex++);
+  return _panel.getSpriteShadow().getWorstCaseCycles()-_actors.getShownCycles();
 }
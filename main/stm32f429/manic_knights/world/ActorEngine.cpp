@@ -0,0 +1,560 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Application.h"
+
+
+/*
+ * Constructor: take the actors from the level definition, enter them into the grid and start
+ * each one on its first path
+ */
+
+ActorEngine::ActorEngine(Panel& panel,const LevelDef& ldef)
+  : _panel(panel),
+    _started(false),
+    _slotAllocator(FIRST_PATH_SPRITE,LAST_PATH_SPRITE),
+    _visible(0),
+    _housekeeping(0) {
+
+  static_assert(MAX_ACTORS<=32,"The visible set is a 32-bit mask");
+
+  uint16_t i;
+
+  _actorCount=ldef.ActorCount<MAX_ACTORS ? ldef.ActorCount : static_cast<uint16_t>(MAX_ACTORS);
+
+  for(i=0;i<_actorCount;i++) {
+
+    const ActorDef& def(ldef.ActorDefs[i]);
+
+    _pathTables[i]=def.Paths;
+    _pathCounts[i]=def.PathCount;
+    _moving[i]=def.PathType==AnimationType::MOVING;
+
+    _positions[i].X=def.Paths[0].StartX;
+    _positions[i].Y=def.Paths[0].StartY;
+    _shownSpriteNumbers[i]=NO_SPRITE;
+    _slots[i]=_lastSlots[i]=SpriteSlotAllocator::NO_SLOT;
+    _order[i]=i;
+    _distances[i]=UINT32_MAX;
+
+    addToGrid(i);
+
+    _currentPaths[i]=0;
+    restart(i,0);
+  }
+}
+
+
+/*
+ * Enter an actor into the grid. Its bounding box covers all of its paths and the largest of
+ * the images that it shows on each one. The time for a cycle of its paths is also noted.
+ */
+
+void ActorEngine::addToGrid(uint16_t actor) {
+
+  int16_t left,top,right,bottom;
+  uint16_t i,j;
+
+  left=top=INT16_MAX;
+  right=bottom=INT16_MIN;
+  _cycleTicks[actor]=0;
+
+  for(i=0;i<_pathCounts[actor];i++) {
+
+    const PathDef& path(_pathTables[actor][i]);
+    uint16_t width,height;
+
+    width=height=0;
+
+    for(j=path.FirstSpriteNumber;j<=path.LastSpriteNumber;j++) {
+
+      const PathSpriteDef& psd(AllSprites.PathSprites[j]);
+
+      if(psd.PixelWidth>width)
+        width=psd.PixelWidth;
+      if(psd.PixelHeight>height)
+        height=psd.PixelHeight;
+    }
+
+    if(path.StartX<left || path.EndX<left)
+      left=path.StartX<path.EndX ? path.StartX : path.EndX;
+    if(path.StartY<top || path.EndY<top)
+      top=path.StartY<path.EndY ? path.StartY : path.EndY;
+    if(path.StartX+width-1>right || path.EndX+width-1>right)
+      right=(path.StartX>path.EndX ? path.StartX : path.EndX)+width-1;
+    if(path.StartY+height-1>bottom || path.EndY+height-1>bottom)
+      bottom=(path.StartY>path.EndY ? path.StartY : path.EndY)+height-1;
+
+    _cycleTicks[actor]+=FrameTime::fromFrames(path.Easing->Duration);
+  }
+
+  _grid.add(actor,left,top,right,bottom);
+}
+
+
+/*
+ * Start the current path of an actor
+ */
+
+void ActorEngine::restart(uint16_t actor,uint32_t time) {
+
+  const PathDef& path(_pathTables[actor][_currentPaths[actor]]);
+
+  _spriteNumbers[actor]=path.FirstSpriteNumber;
+  _lastPoints[actor]=-1;
+  _timeBases[actor]=time;
+  _easingCurves[actor]=path.Easing;
+
+  // a moving actor eases across the pixels between the end points. A static actor
+  // eases across its animation frames.
+
+  if(!_moving[actor])
+    _changes[actor]=path.LastSpriteNumber-path.FirstSpriteNumber+1;
+  else if(path.StartY==path.EndY)
+    _changes[actor]=path.EndX-path.StartX+1;
+  else
+    _changes[actor]=path.EndY-path.StartY+1;
+}
+
+
+/*
+ * Move an actor on to the path that's running at the given time. The next path starts exactly
+ * when the last one ended so the phase carries over. An actor that hasn't been updated for a
+ * while skips the whole cycles of its paths and then as many paths as it takes to catch up.
+ */
+
+void ActorEngine::advance(uint16_t actor,uint32_t time) {
+
+  uint32_t elapsed,duration;
+
+  elapsed=FrameTime::elapsed(time,_timeBases[actor]);
+  duration=FrameTime::fromFrames(_easingCurves[actor]->Duration);
+
+  if(elapsed<duration)
+    return;
+
+  hide(actor);
+
+  // a whole cycle brings the actor back to the start of its current path
+
+  _timeBases[actor]+=elapsed-elapsed % _cycleTicks[actor];
+  elapsed%=_cycleTicks[actor];
+
+  while(elapsed>=duration) {
+
+    _timeBases[actor]+=duration;
+    elapsed-=duration;
+
+    if(++_currentPaths[actor]==_pathCounts[actor])
+      _currentPaths[actor]=0;
+
+    duration=FrameTime::fromFrames(_pathTables[actor][_currentPaths[actor]].Easing->Duration);
+  }
+
+  restart(actor,_timeBases[actor]);
+}
+
+
+/*
+ * Bring back the animation frame of a MOVING actor that's coming into view. The frame steps
+ * on each time the position changes so the whole frames since the start of the path are
+ * replayed. That's the same answer that updating it every frame would have given.
+ */
+
+void ActorEngine::replay(uint16_t actor,uint32_t time) {
+
+  const PathDef& path(_pathTables[actor][_currentPaths[actor]]);
+  uint32_t frames;
+  uint16_t frame;
+  int16_t start;
+
+  _spriteNumbers[actor]=path.FirstSpriteNumber;
+  _lastPoints[actor]=-1;
+
+  frames=FrameTime::frames(FrameTime::elapsed(time,_timeBases[actor]));
+  start=path.StartY==path.EndY ? path.StartX : path.StartY;
+
+  for(frame=0;frame<frames;frame++)
+    step(actor,start+_easingCurves[actor]->offset(frame,0,_changes[actor]));
+}
+
+
+/*
+ * Update a MOVING actor. The animation frame steps on each time the position changes.
+ */
+
+void ActorEngine::moveActor(uint16_t actor,uint32_t time) {
+
+  const PathDef& path(_pathTables[actor][_currentPaths[actor]]);
+  Point& pos(_positions[actor]);
+  int16_t newPoint,newPosition;
+
+  newPosition=ease(actor,time);
+
+  if(path.StartY==path.EndY) {
+    pos.X=path.StartX+newPosition;
+    pos.Y=path.StartY;
+    newPoint=pos.X;
+  }
+  else {
+    pos.X=path.StartX;
+    pos.Y=path.StartY+newPosition;
+    newPoint=pos.Y;
+  }
+
+  step(actor,newPoint);
+}
+
+
+/*
+ * Step the animation frame of a MOVING actor if its position has changed
+ */
+
+void ActorEngine::step(uint16_t actor,int16_t newPoint) {
+
+  const PathDef& path(_pathTables[actor][_currentPaths[actor]]);
+
+  if(newPoint!=_lastPoints[actor]) {
+
+    if(_spriteNumbers[actor]==path.LastSpriteNumber)
+      _spriteNumbers[actor]=path.FirstSpriteNumber;
+    else
+      _spriteNumbers[actor]++;
+
+    _lastPoints[actor]=newPoint;
+  }
+}
+
+
+/*
+ * Update a STATIC actor. The easing function selects the animation frame.
+ */
+
+void ActorEngine::animateActor(uint16_t actor,uint32_t time) {
+
+  const PathDef& path(_pathTables[actor][_currentPaths[actor]]);
+  uint16_t newSpriteNumber;
+
+  _positions[actor].X=path.StartX;
+  _positions[actor].Y=path.StartY;
+
+  newSpriteNumber=ease(actor,time)+path.FirstSpriteNumber;
+
+  if(newSpriteNumber>=path.FirstSpriteNumber && newSpriteNumber<=path.LastSpriteNumber)
+    _spriteNumbers[actor]=newSpriteNumber;
+}
+
+
+/*
+ * Update the actors that could be on screen, nearest to the centre of the screen first so that
+ * they get the first claim on the budget. The others are left where they are until they come
+ * back into view.
+ */
+
+void ActorEngine::update(uint32_t time,const Point& bgTopLeft,AseSpriteBudget& budget) {
+
+  uint32_t visible,entering,leaving;
+  uint16_t i,actor;
+
+  if(!_started) {
+
+    for(i=0;i<_actorCount;i++)
+      _timeBases[i]=time;
+
+    _started=true;
+  }
+
+  visible=_grid.query(bgTopLeft.X-VIEWPORT_MARGIN,bgTopLeft.Y-VIEWPORT_MARGIN,
+                      bgTopLeft.X+359+VIEWPORT_MARGIN,bgTopLeft.Y+639+VIEWPORT_MARGIN);
+
+  entering=visible & ~_visible;
+  leaving=_visible & ~visible;
+  _visible=visible;
+
+  // the actors that have gone out of range are hidden and sorted to the back
+
+  while(leaving) {
+
+    actor=__builtin_ctz(leaving);
+    leaving&=leaving-1;
+
+    hide(actor);
+    _distances[actor]=UINT32_MAX;
+  }
+
+  // advance one parked actor per frame so that no time base gets old enough to be ambiguous
+  // across the wrap of the timebase
+
+  if(_actorCount) {
+
+    if(++_housekeeping>=_actorCount)
+      _housekeeping=0;
+
+    if(!(visible & (1UL << _housekeeping)))
+      advance(_housekeeping,time);
+  }
+
+  prioritise(bgTopLeft,visible);
+
+  // the visible actors are at the front of the order
+
+  for(i=0;i<_actorCount;i++) {
+
+    actor=_order[i];
+
+    if(!(visible & (1UL << actor)))
+      break;
+
+    advance(actor,time);
+
+    if(_moving[actor]) {
+
+      if(entering & (1UL << actor))
+        replay(actor,time);
+
+      moveActor(actor,time);
+    }
+    else
+      animateActor(actor,time);
+
+    show(actor,bgTopLeft,budget);
+  }
+}
+
+
+/*
+ * Show an actor in its new state if it's on screen and the budget allows
+ */
+
+void ActorEngine::show(uint16_t actor,const Point& bgTopLeft,AseSpriteBudget& budget) {
+
+  const PathSpriteDef& current(AllSprites.PathSprites[_spriteNumbers[actor]]);
+  LoadSpriteDef lsd,fallback;
+  uint32_t cycles,fallbackCycles;
+  uint16_t shown;
+
+  if(!isOnScreen(current,_positions[actor],bgTopLeft)) {
+    hide(actor);
+    return;
+  }
+
+  createLoadDef(actor,current,bgTopLeft,lsd);
+  cycles=AseSpriteCost::cycles(lsd);
+
+  // the fallback is to skip the change of animation frame
+
+  fallbackCycles=cycles;
+  shown=_shownSpriteNumbers[actor];
+
+  if(shown!=NO_SPRITE && shown!=_spriteNumbers[actor] && isOnScreen(AllSprites.PathSprites[shown],_positions[actor],bgTopLeft)) {
+    createLoadDef(actor,AllSprites.PathSprites[shown],bgTopLeft,fallback);
+    fallbackCycles=AseSpriteCost::cycles(fallback);
+  }
+
+  switch(budget.admit(cycles,fallbackCycles)) {
+
+    case AseSpriteBudget::ADMITTED:
+
+      if(_slots[actor]==SpriteSlotAllocator::NO_SLOT && !allocateSlot(actor))
+        break;
+
+      lsd.SpriteNumber=_slots[actor];
+      _panel.getSpriteShadow().loadSprite(lsd);
+      _shownSpriteNumbers[actor]=_spriteNumbers[actor];
+      break;
+
+    case AseSpriteBudget::FALLBACK:
+      _panel.getSpriteShadow().loadSprite(fallback);
+      break;
+
+    default:
+      hide(actor);
+      break;
+  }
+}
+
+
+/*
+ * Get a slot for an actor that's about to be shown. If other actors had to be renumbered to
+ * keep the drawing order then the FPGA gets their records at the new slots.
+ * @return false if there are no free slots
+ */
+
+bool ActorEngine::allocateSlot(uint16_t actor) {
+
+  uint16_t i,slot;
+
+  if((slot=_slotAllocator.allocate(actor,_lastSlots[actor]))==SpriteSlotAllocator::NO_SLOT)
+    return false;
+
+  for(i=0;i<_slotAllocator.getRelocationCount();i++) {
+
+    const SpriteSlotAllocator::Relocation& r(_slotAllocator.getRelocation(i));
+
+    _panel.getSpriteShadow().copySprite(r.From,r.To);
+    _slots[r.Key]=r.To;
+  }
+
+  _slots[actor]=slot;
+  return true;
+}
+
+
+/*
+ * Get the predicted cost of the actors that the FPGA is showing
+ */
+
+uint32_t ActorEngine::getShownCycles() const {
+
+  const Panel::SpriteShadow& shadow(_panel.getSpriteShadow());
+  uint32_t cycles;
+  uint16_t i;
+
+  cycles=0;
+
+  for(i=0;i<_actorCount;i++)
+    if(_slots[i]!=SpriteSlotAllocator::NO_SLOT)
+      cycles+=shadow.getCycles(_slots[i]);
+
+  return cycles;
+}
+
+
+/*
+ * Mark the background tiles under the actors that the FPGA is showing
+ */
+
+void ActorEngine::cover(Background& background) const {
+
+  uint16_t i;
+
+  for(i=0;i<_actorCount;i++) {
+
+    if(_shownSpriteNumbers[i]==NO_SPRITE)
+      continue;
+
+    const PathSpriteDef& psd(AllSprites.PathSprites[_shownSpriteNumbers[i]]);
+    const Point& pos(_positions[i]);
+
+    background.cover(pos.X,pos.Y,pos.X+psd.PixelWidth-1,pos.Y+psd.PixelHeight-1);
+  }
+}
+
+
+/*
+ * Create the sprite definition that shows an image at the actor's position
+ */
+
+void ActorEngine::createLoadDef(uint16_t actor,const PathSpriteDef& psd,const Point& bgTopLeft,LoadSpriteDef& lsd) const {
+
+  const Point& pos(_positions[actor]);
+
+  // calculate the overlaps
+
+  lsd.FirstX=pos.X>=bgTopLeft.X ? 0 : bgTopLeft.X-pos.X;
+  lsd.LastX=pos.X+psd.PixelWidth-1<=bgTopLeft.X+359 ? 0x3ff : psd.PixelWidth-((pos.X+psd.PixelWidth)-(bgTopLeft.X+360))-1;
+  lsd.FirstY=pos.Y>=bgTopLeft.Y ? 0 : bgTopLeft.Y-pos.Y;
+  lsd.LastY=pos.Y+psd.PixelHeight-1<=bgTopLeft.Y+639 ? 0x3ff : psd.PixelHeight-((pos.Y+psd.PixelHeight)-(bgTopLeft.Y+639))-1;
+
+  // the sprite lives at its world position. The FPGA subtracts the viewport offset.
+
+  lsd.SpriteNumber=_slots[actor];
+  lsd.SramAddress=(pos.Y*360+pos.X) & 0x3ffff;
+  lsd.FlashAddress=psd.FlashAddress;
+  lsd.PixelWidth=psd.PixelWidth;
+  lsd.NumPixels=psd.Spans ? psd.SpanWords : psd.PixelHeight*psd.PixelWidth;
+  lsd.Visible=1;
+  lsd.Persistent=0;
+  lsd.Mirror=psd.Mirror;
+  lsd.Indexed=psd.Indexed;
+  lsd.Spans=psd.Spans;
+  lsd.RepeatX=1;
+  lsd.RepeatY=1;
+
+  // a mirror image is drawn up from its bottom row so the rows are clipped from the other end
+
+  if(psd.Mirror) {
+
+    uint16_t firstY,lastY;
+
+    firstY=lsd.FirstY;
+    lastY=lsd.LastY==0x3ff ? psd.PixelHeight-1 : lsd.LastY;
+
+    lsd.FirstY=psd.PixelHeight-1-lastY;
+    lsd.LastY=firstY==0 ? 0x3ff : psd.PixelHeight-1-firstY;
+    lsd.SramAddress=((pos.Y+psd.PixelHeight-1)*360+pos.X) & 0x3ffff;
+  }
+}
+
+
+/*
+ * Sort the actors by the distance of their last position from the centre of the screen. The
+ * ones out of range keep the largest distance so they sort to the back. The order hardly
+ * changes from one frame to the next so an insertion sort that starts from the last order is
+ * almost free.
+ */
+
+void ActorEngine::prioritise(const Point& bgTopLeft,uint32_t visible) {
+
+  uint16_t i,j,actor;
+  int32_t dx,dy;
+  uint32_t distance;
+
+  while(visible) {
+
+    i=__builtin_ctz(visible);
+    visible&=visible-1;
+
+    const PathSpriteDef& psd(AllSprites.PathSprites[_spriteNumbers[i]]);
+
+    dx=_positions[i].X+psd.PixelWidth/2-(bgTopLeft.X+180);
+    dy=_positions[i].Y+psd.PixelHeight/2-(bgTopLeft.Y+320);
+
+    _distances[i]=(dx<0 ? -dx : dx)+(dy<0 ? -dy : dy);
+  }
+
+  for(i=1;i<_actorCount;i++) {
+
+    actor=_order[i];
+    distance=_distances[actor];
+
+    for(j=i;j>0 && _distances[_order[j-1]]>distance;j--)
+      _order[j]=_order[j-1];
+
+    _order[j]=actor;
+  }
+}
+
+
+/*
+ * Get the flash used by the easing curves of all the paths. Each distinct curve is counted once.
+ */
+
+uint32_t ActorEngine::getEasingFlashBytes(uint16_t& curves) const {
+
+  const EasingCurve *seen[MAX_ACTORS*4];
+  uint32_t bytes;
+  uint16_t i,j,k;
+
+  bytes=0;
+  curves=0;
+
+  for(i=0;i<_actorCount;i++) {
+    for(j=0;j<_pathCounts[i];j++) {
+
+      const EasingCurve *curve=_pathTables[i][j].Easing;
+
+      for(k=0;k<curves && seen[k]!=curve;k++);
+
+      if(k==curves && curves<sizeof(seen)/sizeof(seen[0])) {
+        seen[curves++]=curve;
+        bytes+=curve->getFlashBytes();
+      }
+    }
+  }
+
+  return bytes;
+}
@@ -0,0 +1,173 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * All the actors in a level held as a structure of arrays so that the per-frame update is one
+ * loop over contiguous state. Each actor follows the closed sequence of paths in its ActorDef.
+ * A MOVING actor is eased between the end points of the path and steps its animation frame
+ * each time its position changes. A STATIC actor stays put and eases through its frames.
+ * Times are FrameTime ticks so the path timing is integer arithmetic that survives the wrap.
+ * The paths start at the time of the first update, whatever the frame counter is by then.
+ *
+ * Only the actors that the ActorGrid finds near the viewport are updated. The others are
+ * parked and when they come back into range they're moved on to where they would have been
+ * from the time alone.
+ *
+ * The arrays are sized by LevelDef::MAX_ACTORS. The easing is a baked EasingCurve so moving
+ * an actor is one table read scaled by the length of its path. There's no floating point
+ * easing and nothing is allocated from the heap.
+ *
+ * An actor only holds an FPGA slot while its sprite is showing. The slots come from a
+ * SpriteSlotAllocator keyed on the actor's index so the actors are drawn in the order that the
+ * level lists them, as they always have been. If it's on screen then it has to be admitted by
+ * the AseSpriteBudget. If it doesn't fit then it keeps the image that the
+ * FPGA already has, as long as that's cheaper, or it's hidden until there's time for it.
+ */
+
+class ActorEngine {
+
+  protected:
+
+    enum {
+      MAX_ACTORS = LevelDef::MAX_ACTORS,
+      NO_SPRITE = 0xffff,
+      VIEWPORT_MARGIN = 64        // actors this close to the screen are kept up to date
+    };
+
+    Panel& _panel;
+    uint16_t _actorCount;
+    bool _started;
+    ActorGrid _grid;
+    SpriteSlotAllocator _slotAllocator;
+
+    // the definitions
+
+    const PathDef *_pathTables[MAX_ACTORS];
+    uint8_t _pathCounts[MAX_ACTORS];
+    bool _moving[MAX_ACTORS];
+    uint32_t _cycleTicks[MAX_ACTORS];
+
+    // the state
+
+    uint8_t _currentPaths[MAX_ACTORS];
+    uint32_t _timeBases[MAX_ACTORS];
+    Point _positions[MAX_ACTORS];
+    uint16_t _spriteNumbers[MAX_ACTORS];
+    int16_t _lastPoints[MAX_ACTORS];
+    uint16_t _shownSpriteNumbers[MAX_ACTORS];
+    uint16_t _slots[MAX_ACTORS];
+    uint16_t _lastSlots[MAX_ACTORS];
+    const EasingCurve *_easingCurves[MAX_ACTORS];
+    int16_t _changes[MAX_ACTORS];
+
+    // the update order and the actors in range last time
+
+    uint16_t _order[MAX_ACTORS];
+    uint32_t _distances[MAX_ACTORS];
+    uint32_t _visible;
+    uint16_t _housekeeping;
+
+  protected:
+    void addToGrid(uint16_t actor);
+    void restart(uint16_t actor,uint32_t time);
+    void advance(uint16_t actor,uint32_t time);
+    void replay(uint16_t actor,uint32_t time);
+    void step(uint16_t actor,int16_t newPoint);
+    int16_t ease(uint16_t actor,uint32_t time) const;
+    void moveActor(uint16_t actor,uint32_t time);
+    void animateActor(uint16_t actor,uint32_t time);
+    void show(uint16_t actor,const Point& bgTopLeft,AseSpriteBudget& budget);
+    void hide(uint16_t actor);
+    bool allocateSlot(uint16_t actor);
+    void prioritise(const Point& bgTopLeft,uint32_t visible);
+
+    bool isOnScreen(const PathSpriteDef& psd,const Point& pos,const Point& bgTopLeft) const;
+    void createLoadDef(uint16_t actor,const PathSpriteDef& psd,const Point& bgTopLeft,LoadSpriteDef& lsd) const;
+
+  public:
+    ActorEngine(Panel& panel,const LevelDef& ldef);
+
+    void update(uint32_t time,const Point& bgTopLeft,AseSpriteBudget& budget);
+
+    uint16_t getActorCount() const;
+    uint16_t getVisibleCount() const;
+    uint32_t getShownCycles() const;
+    void cover(Background& background) const;
+    const SpriteSlotAllocator& getSlotAllocator() const;
+    uint32_t getEasingFlashBytes(uint16_t& curves) const;
+};
+
+
+/*
+ * Get the number of actors
+ */
+
+inline uint16_t ActorEngine::getActorCount() const {
+  return _actorCount;
+}
+
+
+/*
+ * Get the number of actors that were in range at the last update
+ */
+
+inline uint16_t ActorEngine::getVisibleCount() const {
+  return __builtin_popcount(_visible);
+}
+
+
+/*
+ * Get the slot allocator
+ */
+
+inline const SpriteSlotAllocator& ActorEngine::getSlotAllocator() const {
+  return _slotAllocator;
+}
+
+
+/*
+ * Get the eased offset of an actor along its current path
+ */
+
+inline int16_t ActorEngine::ease(uint16_t actor,uint32_t time) const {
+
+  uint32_t elapsed;
+
+  elapsed=FrameTime::elapsed(time,_timeBases[actor]);
+  return _easingCurves[actor]->offset(FrameTime::frames(elapsed),FrameTime::phase(elapsed),_changes[actor]);
+}
+
+
+/*
+ * Hide an actor's sprite if it's showing and give its slot back
+ */
+
+inline void ActorEngine::hide(uint16_t actor) {
+
+  if(_shownSpriteNumbers[actor]==NO_SPRITE)
+    return;
+
+  _panel.getSpriteShadow().hideSprite(_slots[actor]);
+  _slotAllocator.release(_slots[actor]);
+
+  _lastSlots[actor]=_slots[actor];
+  _slots[actor]=SpriteSlotAllocator::NO_SLOT;
+  _shownSpriteNumbers[actor]=NO_SPRITE;
+}
+
+
+/*
+ * Check if an image at a world position is at least partially on screen
+ */
+
+inline bool ActorEngine::isOnScreen(const PathSpriteDef& psd,const Point& pos,const Point& bgTopLeft) const {
+
+  return pos.X<bgTopLeft.X+359 && pos.X+psd.PixelWidth-1>bgTopLeft.X &&
+         pos.Y<bgTopLeft.Y+639 && pos.Y+psd.PixelHeight-1>bgTopLeft.Y;
+}
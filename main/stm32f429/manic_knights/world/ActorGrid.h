@@ -0,0 +1,105 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Uniform grid over the world that says which actors could be inside an area. Each actor is
+ * entered into every cell that its bounding box touches and a cell is a bit mask with one bit
+ * per actor, so a query is an OR of the cells that the area touches. The answer can include
+ * actors that are near the area but it never misses one that's inside it.
+ *
+ * The grid covers the 1280x1920 world in 128 pixel cells. Anything outside is clamped to the
+ * edge cells.
+ */
+
+class ActorGrid {
+
+  public:
+    enum {
+      CELL_SHIFT = 7,
+      COLUMNS = 1280 >> CELL_SHIFT,
+      ROWS = 1920 >> CELL_SHIFT
+    };
+
+  protected:
+    uint32_t _cells[ROWS][COLUMNS];
+
+  protected:
+    static uint16_t column(int16_t x);
+    static uint16_t row(int16_t y);
+
+  public:
+    ActorGrid();
+
+    void add(uint16_t actor,int16_t left,int16_t top,int16_t right,int16_t bottom);
+    uint32_t query(int16_t left,int16_t top,int16_t right,int16_t bottom) const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline ActorGrid::ActorGrid() {
+  memset(_cells,0,sizeof(_cells));
+}
+
+
+/*
+ * Get the cell column of an X coordinate
+ */
+
+inline uint16_t ActorGrid::column(int16_t x) {
+  return x<0 ? 0 : x>=(COLUMNS << CELL_SHIFT) ? COLUMNS-1 : x >> CELL_SHIFT;
+}
+
+
+/*
+ * Get the cell row of a Y coordinate
+ */
+
+inline uint16_t ActorGrid::row(int16_t y) {
+  return y<0 ? 0 : y>=(ROWS << CELL_SHIFT) ? ROWS-1 : y >> CELL_SHIFT;
+}
+
+
+/*
+ * Add an actor
+ * @param actor The actor index, less than 32
+ * @param left,top,right,bottom The inclusive bounding box in world pixels
+ */
+
+inline void ActorGrid::add(uint16_t actor,int16_t left,int16_t top,int16_t right,int16_t bottom) {
+
+  uint16_t r,c;
+
+  for(r=row(top);r<=row(bottom);r++)
+    for(c=column(left);c<=column(right);c++)
+      _cells[r][c]|=1UL << actor;
+}
+
+
+/*
+ * Find the actors that could be in an area
+ * @param left,top,right,bottom The inclusive area in world pixels
+ * @return A bit mask of the actors
+ */
+
+inline uint32_t ActorGrid::query(int16_t left,int16_t top,int16_t right,int16_t bottom) const {
+
+  uint32_t actors;
+  uint16_t r,c;
+
+  actors=0;
+
+  for(r=row(top);r<=row(bottom);r++)
+    for(c=column(left);c<=column(right);c++)
+      actors|=_cells[r][c];
+
+  return actors;
+}
@@ -15,7 +15,8 @@ Background::Background(Panel& panel,const LevelDef& ldef)
   : _panel(panel),
     _levelDef(ldef),
     _topLeft(1280-360,1920-640),
-    _lastTopLeft(0,0) {
+    _lastTopLeft(0,0),
+    _scrollMode(TRACKED_SLOTS) {
 
   // constants for the load
 
@@ -24,6 +25,16 @@ Background::Background(Panel& panel,const LevelDef& ldef)
   _lsd.RepeatX=1;
   _lsd.RepeatY=1;
   _lsd.Visible=1;
+  _lsd.Mirror=0;
+  _lsd.Indexed=0;
+  _lsd.Spans=0;
+
+  memset(_covered,0,sizeof(_covered));
+  memset(_persistent,0,sizeof(_persistent));
+  memset(_cellSlots,NO_SLOT,sizeof(_cellSlots));
+
+  for(uint16_t i=0;i<NUM_SLOTS;i++)
+    _slotOrigins[i]=NO_ORIGIN;
 }
 
 
@@ -33,17 +44,19 @@ Background::Background(Panel& panel,const LevelDef& ldef)
 
 void Background::update() {
 
-  const uint16_t *tile,*row_tile;
-  uint8_t x,y,left_firstx,top_firsty;
-  uint16_t spriteNumber;
-  int16_t px,py;
-  int32_t sram_address,row_sram_address;
+  const uint16_t *row_tile;
+  uint8_t left_firstx,top_firsty;
 
   // check if update required
 
   if(_lastTopLeft==_topLeft)
     return;
 
+  // scrolling is done by the FPGA. The tiles are positioned in the world and only the ones
+  // that change slot or clipping need updating.
+
+  _panel.getSpriteShadow().setViewportOffset(_topLeft.X,_topLeft.Y);
+
   // get a pointer to the first tile
 
   row_tile=&_levelDef.Tiles[((_topLeft.Y / 64)*20)+(_topLeft.X / 64)];
@@ -53,19 +66,36 @@ void Background::update() {
   left_firstx=_topLeft.X % 64;
   top_firsty=_topLeft.Y % 64;
 
-  // there are (10+1)*(6+1) = 77 slots reserved for the scene, slots 0..76
+  if(_scrollMode==MERGED_TILES)
+    updateMerged(row_tile,left_firstx,top_firsty);
+  else
+    updateTiles(row_tile,left_firstx,top_firsty);
 
-  spriteNumber=0;
+  // done
 
-  // initial sram address
+  _lastTopLeft=_topLeft;
+}
 
-  row_sram_address=0;
 
-  if(top_firsty)
-    row_sram_address-=top_firsty*360;
+/*
+ * Load one sprite for each tile on the screen into the slot that getSlot() gives it
+ * @param row_tile The map tile under the top-left of the screen
+ * @param left_firstx,top_firsty The pixels of that tile that are off the screen
+ */
 
-  if(left_firstx)
-    row_sram_address-=left_firstx;
+void Background::updateTiles(const uint16_t *row_tile,uint8_t left_firstx,uint8_t top_firsty) {
+
+  const uint16_t *tile;
+  uint8_t x,y;
+  int16_t px,py;
+  int32_t sram_address,row_sram_address;
+
+  // there are (10+1)*(6+1) = 77 slots reserved for the scene, slots 0..76. getSlot()
+  // decides which tile goes where.
+
+  // initial sram address is the world position of the top-left tile
+
+  row_sram_address=(_topLeft.Y-top_firsty)*360+(_topLeft.X-left_firstx);
 
   py=-top_firsty;
 
@@ -87,18 +117,19 @@ void Background::update() {
 
         // values unique to the individual sprite
 
-        _lsd.SpriteNumber=spriteNumber++;
+        _lsd.SpriteNumber=getSlot(x,y);
         _lsd.FirstX=x==0 ? left_firstx : 0;
         _lsd.LastX=px+64>360 ? 63-(px+64-360) : 63;
-        _lsd.SramAddress=sram_address>=0 ? sram_address : 524288+sram_address;
+        _lsd.SramAddress=sram_address & 0x3ffff;
         _lsd.FlashAddress=BackgroundSprites[*tile].FlashAddress;
+        _lsd.Persistent=_persistent[_lsd.SpriteNumber];
 
         // load the sprite
 
-        _panel.getAccessMode().loadSprite(_lsd);
+        _panel.getSpriteShadow().loadSprite(_lsd);
       }
       else
-        _panel.getAccessMode().hideSprite(spriteNumber++);
+        _panel.getSpriteShadow().hideSprite(getSlot(x,y));
 
       // move to the adjacent sprite on the X axis
 
@@ -113,8 +144,191 @@ void Background::update() {
     row_sram_address+=360*64;
     py+=64;
   }
+}
 
-  // done
 
-  _lastTopLeft=_topLeft;
+/*
+ * Load one repeated sprite for each rectangle of the same tile on the screen. A rectangle goes
+ * back into the slot that had the same top-left map tile last time so that a scroll within a
+ * tile only changes its clipping. The clipping columns and rows count across the whole grid.
+ * @param first_tile The map tile under the top-left of the screen
+ * @param left_firstx,top_firsty The pixels of that tile that are off the screen
+ */
+
+void Background::updateMerged(const uint16_t *first_tile,uint8_t left_firstx,uint8_t top_firsty) {
+
+  Rectangle rectangles[NUM_SLOTS];
+  uint16_t origins[NUM_SLOTS];
+  uint8_t i,slot,count,columns,rows,x,y;
+  uint16_t first_origin;
+  bool claimed[NUM_SLOTS];
+
+  // the cells that are at least partly on the screen
+
+  columns=(360+left_firstx+63)/64;
+  rows=(640+top_firsty+63)/64;
+
+  count=findRectangles(first_tile,columns,rows,rectangles);
+
+  // a rectangle keeps the slot that had its top-left map tile, the others take what's left
+
+  first_origin=(_topLeft.Y/64)*MAP_COLUMNS+(_topLeft.X/64);
+  memset(claimed,0,sizeof(claimed));
+
+  for(i=0;i<count;i++) {
+
+    origins[i]=first_origin+rectangles[i].Y*MAP_COLUMNS+rectangles[i].X;
+    rectangles[i].Slot=NO_SLOT;
+
+    for(slot=0;slot<NUM_SLOTS;slot++) {
+      if(_slotOrigins[slot]==origins[i]) {
+        rectangles[i].Slot=slot;
+        claimed[slot]=true;
+        break;
+      }
+    }
+  }
+
+  slot=0;
+
+  for(i=0;i<count;i++) {
+
+    if(rectangles[i].Slot==NO_SLOT) {
+
+      while(claimed[slot])
+        slot++;
+
+      rectangles[i].Slot=slot;
+      claimed[slot]=true;
+    }
+  }
+
+  // load the rectangles and note the slot over each cell for cover()
+
+  memset(_cellSlots,NO_SLOT,sizeof(_cellSlots));
+
+  for(i=0;i<count;i++) {
+
+    const Rectangle& r(rectangles[i]);
+
+    _lsd.SpriteNumber=r.Slot;
+    _lsd.RepeatX=r.Columns;
+    _lsd.RepeatY=r.Rows;
+
+    _lsd.FirstX=r.X==0 ? left_firstx : 0;
+    _lsd.LastX=r.Columns*64-1;
+    _lsd.FirstY=r.Y==0 ? top_firsty : 0;
+    _lsd.LastY=r.Rows*64-1;
+
+    // the last cell on the screen can be cut off on the right or at the bottom
+
+    if(r.X+r.Columns==columns && columns*64-left_firstx>360)
+      _lsd.LastX-=columns*64-left_firstx-360;
+
+    if(r.Y+r.Rows==rows && rows*64-top_firsty>640)
+      _lsd.LastY-=rows*64-top_firsty-640;
+
+    _lsd.SramAddress=((_topLeft.Y-top_firsty+r.Y*64)*360+(_topLeft.X-left_firstx+r.X*64)) & 0x3ffff;
+    _lsd.FlashAddress=BackgroundSprites[first_tile[r.Y*MAP_COLUMNS+r.X]].FlashAddress;
+    _lsd.Persistent=_persistent[r.Slot];
+
+    _panel.getSpriteShadow().loadSprite(_lsd);
+
+    for(y=r.Y;y<r.Y+r.Rows;y++)
+      for(x=r.X;x<r.X+r.Columns;x++)
+        _cellSlots[y][x]=r.Slot;
+  }
+
+  // the slots that aren't needed now are hidden
+
+  for(slot=0;slot<NUM_SLOTS;slot++) {
+
+    if(!claimed[slot]) {
+      _slotOrigins[slot]=NO_ORIGIN;
+      _panel.getSpriteShadow().hideSprite(slot);
+    }
+  }
+
+  for(i=0;i<count;i++)
+    _slotOrigins[rectangles[i].Slot]=origins[i];
+
+  // the other modes always repeat once
+
+  _lsd.RepeatX=1;
+  _lsd.RepeatY=1;
+}
+
+
+/*
+ * Split the cells on the screen into rectangles of the same tile. Each rectangle is as wide as
+ * the run of its tile from its top-left cell and then as tall as the rows below that repeat the
+ * whole run.
+ * @param first_tile The map tile under the top-left of the screen
+ * @param columns,rows The cells that are on the screen
+ * @param rectangles Receives the rectangles
+ * @return The number of rectangles
+ */
+
+uint8_t Background::findRectangles(const uint16_t *first_tile,uint8_t columns,uint8_t rows,Rectangle *rectangles) {
+
+  bool used[SLOT_ROWS][SLOT_COLUMNS];
+  uint8_t x,y,x1,y1,count;
+  uint16_t tile;
+
+  memset(used,0,sizeof(used));
+  count=0;
+
+  for(y=0;y<rows;y++) {
+    for(x=0;x<columns;x++) {
+
+      if(used[y][x])
+        continue;
+
+      tile=first_tile[y*MAP_COLUMNS+x];
+
+      for(x1=x+1;x1<columns && !used[y][x1] && first_tile[y*MAP_COLUMNS+x1]==tile;x1++);
+
+      for(y1=y+1;y1<rows;y1++) {
+
+        uint8_t xx;
+
+        for(xx=x;xx<x1 && !used[y1][xx] && first_tile[y1*MAP_COLUMNS+xx]==tile;xx++);
+
+        if(xx!=x1)
+          break;
+      }
+
+      Rectangle& r(rectangles[count++]);
+
+      r.X=x;
+      r.Y=y;
+      r.Columns=x1-x;
+      r.Rows=y1-y;
+
+      for(uint8_t yy=y;yy<y1;yy++)
+        for(uint8_t xx=x;xx<x1;xx++)
+          used[yy][xx]=true;
+    }
+  }
+
+  return count;
+}
+
+
+/*
+ * Make the tiles that nothing was drawn over this frame persistent and the others not. Call
+ * after everything has been covered. A hidden tile is left alone.
+ */
+
+void Background::updatePersistence() {
+
+  uint16_t slot;
+
+  for(slot=0;slot<NUM_SLOTS;slot++) {
+
+    _persistent[slot]=!_covered[slot];
+    _panel.getSpriteShadow().setPersistent(slot,_persistent[slot]);
+  }
+
+  memset(_covered,0,sizeof(_covered));
 }
@@ -10,26 +10,139 @@
 /*
  * The background class looks after maintaining the tiles that make up
  * the background.
+ *
+ * A tile is persistent, so the sprite writer only draws it once, unless something is drawn
+ * over it. Each frame the actors mark the tiles that they cover and updatePersistence()
+ * changes the flag of the tiles that were covered or uncovered.
  */
 
 class Background {
 
+  public:
+
+    /*
+     * How map tiles are assigned to the 77 background slots.
+     *
+     * FIXED_SLOTS: slot n is always the n'th tile on the screen so every tile changes slot
+     * when the view crosses a 64 pixel boundary and all of them have to be reloaded.
+     *
+     * TRACKED_SLOTS: a map tile keeps the same slot for as long as it's on the screen. The
+     * slot is the tile's map row mod 11 and column mod 7, so the row or column that scrolls
+     * out hands its slots to the one that scrolls in. Tiles that only shifted cost a move and
+     * just the new row or column needs a full load.
+     *
+     * MERGED_TILES: the visible tiles are split into rectangles of the same tile and each one
+     * is a single sprite repeated with RepeatX and RepeatY. A rectangle keeps its slot while
+     * its top-left map tile is still the top-left of a rectangle. Fewer slots are used and
+     * fewer records are loaded, but an actor over any part of a rectangle stops all of it being
+     * persistent.
+     */
+
+    enum ScrollMode {
+      FIXED_SLOTS,
+      TRACKED_SLOTS,
+      MERGED_TILES
+    };
+
   protected:
+
+    enum {
+      SLOT_COLUMNS = 7,
+      SLOT_ROWS = 11,
+      NUM_SLOTS = SLOT_COLUMNS*SLOT_ROWS,
+      MAP_COLUMNS = 20,
+      NO_SLOT = 0xff,
+      NO_ORIGIN = 0xffff
+    };
+
+    /*
+     * A rectangle of the same tile on the screen grid
+     */
+
+    struct Rectangle {
+      uint8_t X,Y;
+      uint8_t Columns,Rows;
+      uint8_t Slot;
+    };
+
     Panel& _panel;
     const LevelDef &_levelDef;
     Point _topLeft;
     Point _lastTopLeft;
     LoadSpriteDef _lsd;
+    ScrollMode _scrollMode;
+    uint8_t _covered[NUM_SLOTS];
+    uint8_t _persistent[NUM_SLOTS];
+    uint8_t _cellSlots[SLOT_ROWS][SLOT_COLUMNS];    // MERGED_TILES: the slot over each cell
+    uint16_t _slotOrigins[NUM_SLOTS];               // MERGED_TILES: the top-left map tile in each slot
+
+  protected:
+    uint16_t getSlot(uint8_t x,uint8_t y) const;
+    void updateTiles(const uint16_t *row_tile,uint8_t left_firstx,uint8_t top_firsty);
+    void updateMerged(const uint16_t *first_tile,uint8_t left_firstx,uint8_t top_firsty);
+    uint8_t findRectangles(const uint16_t *first_tile,uint8_t columns,uint8_t rows,Rectangle *rectangles);
 
   public:
     Background(Panel& panel,const LevelDef& ldef);
 
     void update();
+    void cover(int16_t left,int16_t top,int16_t right,int16_t bottom);
+    void updatePersistence();
     void setTopLeft(const Point& topLeft);
     const Point& getTopLeft() const;
+    void setScrollMode(ScrollMode scrollMode);
 };
 
 
+/*
+ * Get the FPGA sprite slot for the tile at (x,y) on the screen grid
+ */
+
+inline uint16_t Background::getSlot(uint8_t x,uint8_t y) const {
+
+  if(_scrollMode==FIXED_SLOTS)
+    return y*SLOT_COLUMNS+x;
+
+  if(_scrollMode==MERGED_TILES)
+    return _cellSlots[y][x];
+
+  return (((_topLeft.Y/64)+y) % SLOT_ROWS)*SLOT_COLUMNS+(((_topLeft.X/64)+x) % SLOT_COLUMNS);
+}
+
+
+/*
+ * Note that something is drawn over an area this frame
+ * @param left,top,right,bottom The inclusive area in world pixels
+ */
+
+inline void Background::cover(int16_t left,int16_t top,int16_t right,int16_t bottom) {
+
+  int16_t x,y,firstX,lastX,firstY,lastY;
+  uint16_t slot;
+
+  // the screen grid starts at the tile that holds the top-left
+
+  firstX=(left>>6)-(_topLeft.X/64);
+  lastX=(right>>6)-(_topLeft.X/64);
+  firstY=(top>>6)-(_topLeft.Y/64);
+  lastY=(bottom>>6)-(_topLeft.Y/64);
+
+  if(firstX<0)
+    firstX=0;
+  if(lastX>=SLOT_COLUMNS)
+    lastX=SLOT_COLUMNS-1;
+  if(firstY<0)
+    firstY=0;
+  if(lastY>=SLOT_ROWS)
+    lastY=SLOT_ROWS-1;
+
+  for(y=firstY;y<=lastY;y++)
+    for(x=firstX;x<=lastX;x++)
+      if((slot=getSlot(x,y))<NUM_SLOTS)
+        _covered[slot]=1;
+}
+
+
 /*
  * Set a new top-left point
  */
@@ -46,3 +159,13 @@ inline void Background::setTopLeft(const Point& topLeft) {
 inline const Point& Background::getTopLeft() const {
   return _topLeft;
 }
+
+
+/*
+ * Change the slot assignment. Takes effect at the next update.
+ */
+
+inline void Background::setScrollMode(ScrollMode scrollMode) {
+  _scrollMode=scrollMode;
+  _lastTopLeft=Point(-1,-1);
+}
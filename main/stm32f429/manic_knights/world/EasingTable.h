@@ -0,0 +1,251 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * A baked easing curve. Offsets[t] is the eased fraction of the total change at frame t
+ * in Q2.14 fixed point, for t=0..Duration. The curve is independent of the distance that's
+ * travelled so every path with the same function, mode, duration and parameters shares it.
+ */
+
+struct EasingCurve {
+
+  enum {
+    FRACTION_BITS = 14,
+    ONE = 1 << FRACTION_BITS
+  };
+
+  uint16_t Duration;              // in frames
+  const int16_t *Offsets;         // Duration+1 entries
+
+  int16_t offset(uint16_t frame,uint8_t phase,int16_t change) const;
+  uint32_t getFlashBytes() const;
+};
+
+
+/*
+ * Get the eased offset at a time within the curve, truncated towards zero the same way that
+ * casting the result of a floating point easing function would be. Between frames the table
+ * is interpolated linearly.
+ * @param frame The whole frames since the start, less than Duration
+ * @param phase 1/256ths of a frame
+ * @param change The total change
+ */
+
+inline int16_t EasingCurve::offset(uint16_t frame,uint8_t phase,int16_t change) const {
+
+  int32_t value;
+
+  value=Offsets[frame];
+
+  if(phase)
+    value+=((Offsets[frame+1]-value)*phase)/256;
+
+  return static_cast<int16_t>((value*change)/ONE);
+}
+
+
+/*
+ * Get the size of the curve and its table
+ */
+
+inline uint32_t EasingCurve::getFlashBytes() const {
+  return sizeof(EasingCurve)+(Duration+1)*sizeof(int16_t);
+}
+
+
+/*
+ * The Robert Penner easing equations evaluated at compile time with a total change of 1. C++11
+ * constexpr functions are a single return statement so the iterations are tail recursions and
+ * the intermediate values are passed down as parameters. The transcendental functions are
+ * plain series and Newton iterations that are more than accurate enough for 14 bits.
+ */
+
+class EasingMath {
+
+  public:
+    static constexpr double PI=3.14159265358979323846;
+    static constexpr double LN2=0.69314718055994530942;
+
+    static constexpr double sqrt(double x) { return x<=0 ? 0 : sqrtIterate(x,x>1 ? x : 1,40); }
+    static constexpr double exp(double x) { return x>0.5 || x<-0.5 ? square(exp(x/2)) : expSeries(x,1,1,1); }
+    static constexpr double pow2(double x) { return exp(x*LN2); }
+    static constexpr double sin(double x) { return sinSeries(reduce(x),reduce(x),reduce(x),1); }
+    static constexpr double cos(double x) { return sin(x+PI/2); }
+    static constexpr double asin(double x) { return x>=1 ? PI/2 : x<=-1 ? -PI/2 : asinIterate(x,x,40); }
+
+    static constexpr double ease(EasingType type,EasingMode mode,double t,double d,double p1,double p2) {
+      return type==EasingType::BACK ? back(mode,t/d,p1) :
+             type==EasingType::BOUNCE ? bounce(mode,t/d) :
+             type==EasingType::CIRCULAR ? circular(mode,t/d) :
+             type==EasingType::CUBIC ? cubic(mode,t/d) :
+             type==EasingType::ELASTIC ? elastic(mode,t,d,p1,p2) :
+             type==EasingType::EXPONENTIAL ? exponential(mode,t/d) :
+             type==EasingType::QUADRATIC ? quadratic(mode,t/d) :
+             type==EasingType::QUARTIC ? quartic(mode,t/d) :
+             type==EasingType::QUINTIC ? quintic(mode,t/d) :
+             type==EasingType::SINE ? sine(mode,t/d) :
+             t/d;
+    }
+
+  protected:
+    static constexpr double square(double x) { return x*x; }
+    static constexpr double sqrtIterate(double x,double y,int n) { return n==0 ? y : sqrtIterate(x,(y+x/y)/2,n-1); }
+    static constexpr double expSeries(double x,double term,double sum,int n) { return n==20 ? sum : expSeries(x,term*x/n,sum+term*x/n,n+1); }
+    static constexpr double reduce(double x) { return x-2*PI*static_cast<long long>(x/(2*PI)+(x<0 ? -0.5 : 0.5)); }
+    static constexpr double sinSeries(double x,double term,double sum,int n) { return n==31 ? sum : sinSeries(x,-term*x*x/((2*n)*(2*n+1)),sum-term*x*x/((2*n)*(2*n+1)),n+1); }
+    static constexpr double asinIterate(double x,double y,int n) { return n==0 ? y : asinIterate(x,y-(sin(y)-x)/cos(y),n-1); }
+
+    // the functions of x=t/d
+
+    static constexpr double back(EasingMode mode,double x,double s) {
+      return mode==EasingMode::IN ? x*x*((s+1)*x-s) :
+             mode==EasingMode::OUT ? square(x-1)*((s+1)*(x-1)+s)+1 :
+             backInOut(x*2,s*1.525);
+    }
+
+    static constexpr double backInOut(double u,double s) {
+      return u<1 ? (u*u*((s+1)*u-s))/2 : (square(u-2)*((s+1)*(u-2)+s)+2)/2;
+    }
+
+    static constexpr double bounceOut(double x) {
+      return x<1/2.75 ? 7.5625*x*x :
+             x<2/2.75 ? 7.5625*square(x-1.5/2.75)+.75 :
+             x<2.5/2.75 ? 7.5625*square(x-2.25/2.75)+.9375 :
+             7.5625*square(x-2.625/2.75)+.984375;
+    }
+
+    static constexpr double bounce(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? 1-bounceOut(1-x) :
+             mode==EasingMode::OUT ? bounceOut(x) :
+             x<0.5 ? (1-bounceOut(1-x*2))/2 : bounceOut(x*2-1)/2+0.5;
+    }
+
+    static constexpr double circular(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? 1-sqrt(1-x*x) :
+             mode==EasingMode::OUT ? sqrt(1-square(x-1)) :
+             x<0.5 ? (1-sqrt(1-square(x*2)))/2 : (sqrt(1-square(x*2-2))+1)/2;
+    }
+
+    static constexpr double cubic(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? x*x*x :
+             mode==EasingMode::OUT ? (x-1)*(x-1)*(x-1)+1 :
+             x<0.5 ? 4*x*x*x : ((x*2-2)*(x*2-2)*(x*2-2)+2)/2;
+    }
+
+    static constexpr double exponential(EasingMode mode,double x) {
+      return x==0 ? 0 :
+             x==1 ? 1 :
+             mode==EasingMode::IN ? pow2(10*(x-1)) :
+             mode==EasingMode::OUT ? 1-pow2(-10*x) :
+             x<0.5 ? pow2(10*(x*2-1))/2 : (2-pow2(-10*(x*2-1)))/2;
+    }
+
+    static constexpr double quadratic(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? x*x :
+             mode==EasingMode::OUT ? -x*(x-2) :
+             x<0.5 ? 2*x*x : -((x*2-1)*(x*2-3)-1)/2;
+    }
+
+    static constexpr double quartic(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? square(x*x) :
+             mode==EasingMode::OUT ? 1-square(square(x-1)) :
+             x<0.5 ? 8*square(x*x) : -(square(square(x*2-2))-2)/2;
+    }
+
+    static constexpr double quintic(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? square(x*x)*x :
+             mode==EasingMode::OUT ? square(square(x-1))*(x-1)+1 :
+             x<0.5 ? 16*square(x*x)*x : (square(square(x*2-2))*(x*2-2)+2)/2;
+    }
+
+    static constexpr double sine(EasingMode mode,double x) {
+      return mode==EasingMode::IN ? 1-cos(x*PI/2) :
+             mode==EasingMode::OUT ? sin(x*PI/2) :
+             (1-cos(PI*x))/2;
+    }
+
+    // elastic works in frames because the period is in frames. The amplitude is a multiple
+    // of the change and the defaults are those of the Penner equations.
+
+    static constexpr double elastic(EasingMode mode,double t,double d,double p,double a) {
+      return t==0 ? 0 :
+             t==d ? 1 :
+             mode==EasingMode::INOUT ? elasticInOut(t*2/d,d,p==0 ? d*.45 : p,a<1 ? 1 : a) :
+             elasticInOrOut(mode,t/d,d,p==0 ? d*.3 : p,a<1 ? 1 : a);
+    }
+
+    static constexpr double elasticShift(double p,double a) {
+      return a==1 ? p/4 : p/(2*PI)*asin(1/a);
+    }
+
+    static constexpr double elasticInOrOut(EasingMode mode,double x,double d,double p,double a) {
+      return mode==EasingMode::IN ?
+               -(a*pow2(10*(x-1))*sin(((x-1)*d-elasticShift(p,a))*(2*PI)/p)) :
+               a*pow2(-10*x)*sin((x*d-elasticShift(p,a))*(2*PI)/p)+1;
+    }
+
+    static constexpr double elasticInOut(double u,double d,double p,double a) {
+      return u<1 ?
+               -(a*pow2(10*(u-1))*sin(((u-1)*d-elasticShift(p,a))*(2*PI)/p))/2 :
+               a*pow2(-10*(u-1))*sin(((u-1)*d-elasticShift(p,a))*(2*PI)/p)/2+1;
+    }
+};
+
+
+/*
+ * The values of a curve for each frame in a table that's generated by the compiler. The
+ * parameters are template arguments so they're integers in 1/10000ths.
+ *
+ *   BACK:     TParameter1 is the overshoot. 17016 is the usual "10 percent".
+ *   ELASTIC:  TParameter1 is the period in frames, 0 for the default of 0.3 x duration.
+ *             TParameter2 is the amplitude as a multiple of the change, 0 for the default.
+ */
+
+template<EasingType TType,EasingMode TMode,uint16_t TDuration,int32_t TParameter1,int32_t TParameter2,class TIndices>
+struct EasingTableData;
+
+template<EasingType TType,EasingMode TMode,uint16_t TDuration,int32_t TParameter1,int32_t TParameter2,uint16_t... I>
+struct EasingTableData<TType,TMode,TDuration,TParameter1,TParameter2,AseIndexes<I...>> {
+
+  static constexpr int16_t bake(double value) {
+    return static_cast<int16_t>(value<0 ? value*EasingCurve::ONE-0.5 : value*EasingCurve::ONE+0.5);
+  }
+
+  static constexpr int16_t Offsets[sizeof...(I)]={
+    bake(EasingMath::ease(TType,TMode,I,TDuration,TParameter1/10000.0,TParameter2/10000.0))...
+  };
+};
+
+template<EasingType TType,EasingMode TMode,uint16_t TDuration,int32_t TParameter1,int32_t TParameter2,uint16_t... I>
+constexpr int16_t EasingTableData<TType,TMode,TDuration,TParameter1,TParameter2,AseIndexes<I...>>::Offsets[sizeof...(I)];
+
+
+/*
+ * A baked easing curve. There's one instance of each distinct set of template arguments in
+ * the program however many paths refer to it, e.g.
+ *
+ *   typedef EasingTable<EasingType::CUBIC,EasingMode::INOUT,90> Cubic90;
+ *   static const PathDef paths[]={ { 128,512,128,640,FIRST,LAST,&Cubic90::Curve }, ... };
+ *
+ * Q2.14 covers the overshoot of BACK and ELASTIC curves as long as they stay within -2..2. A
+ * curve that goes outside that range is an overflow in a constant expression and won't compile.
+ */
+
+template<EasingType TType,EasingMode TMode,uint16_t TDuration,int32_t TParameter1=0,int32_t TParameter2=0>
+struct EasingTable {
+
+  static_assert(TDuration>0 && TDuration<=600,"Easing durations are 1 to 600 frames");
+
+  typedef EasingTableData<TType,TMode,TDuration,TParameter1,TParameter2,typename AseMakeIndexes<TDuration+1>::Type> Data;
+
+  static constexpr EasingCurve Curve={ TDuration,Data::Offsets };
+};
+
+template<EasingType TType,EasingMode TMode,uint16_t TDuration,int32_t TParameter1,int32_t TParameter2>
+constexpr EasingCurve EasingTable<TType,TMode,TDuration,TParameter1,TParameter2>::Curve;
@@ -0,0 +1,72 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * The world's timebase: a free running 32-bit count of frames in Q24.8 fixed point. The low
+ * 8 bits are the phase within a frame. The count wraps every 2^24 frames (about 76 hours at
+ * 61Hz) so times are only ever compared by subtracting them as unsigned numbers, which is
+ * exact across the wrap for any interval shorter than that.
+ */
+
+class FrameTime {
+
+  public:
+    enum {
+      PHASE_BITS = 8,
+      ONE_FRAME = 1 << PHASE_BITS,
+      PHASE_MASK = ONE_FRAME-1
+    };
+
+    static uint32_t fromFrames(uint32_t frames,uint8_t phase=0);
+    static uint32_t elapsed(uint32_t now,uint32_t then);
+    static uint32_t frames(uint32_t ticks);
+    static uint8_t phase(uint32_t ticks);
+};
+
+
+/*
+ * Convert a frame count and a phase to a time. The top 8 bits of the count are lost.
+ * @param frames The frame count
+ * @param phase 1/256ths of a frame
+ * @return The time
+ */
+
+inline uint32_t FrameTime::fromFrames(uint32_t frames,uint8_t phase) {
+  return (frames << PHASE_BITS) | phase;
+}
+
+
+/*
+ * Get the time between two times, correct across the wrap
+ * @param now The later time
+ * @param then The earlier time
+ * @return The ticks between them
+ */
+
+inline uint32_t FrameTime::elapsed(uint32_t now,uint32_t then) {
+  return now-then;
+}
+
+
+/*
+ * Get the whole frames in an interval
+ */
+
+inline uint32_t FrameTime::frames(uint32_t ticks) {
+  return ticks >> PHASE_BITS;
+}
+
+
+/*
+ * Get the phase within a frame of an interval
+ */
+
+inline uint8_t FrameTime::phase(uint32_t ticks) {
+  return ticks & PHASE_MASK;
+}
@@ -0,0 +1,38 @@
+
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Application.h"
+
+
+const uint16_t PathPalette[]={
+  0x1ff8,0xa408,0xc410,0xc608,0x0711,0x8b01,0x6811,0x8c01,
+  0xeb21,0xe410,0x0f84,0x6721,0x5202,0xe418,0xad7b,0xe608,
+  0x0511,0x5903,0xa729,0xef83,0x2619,0x6d73,0x8600,0x4811,
+  0x083a,0x9302,0xd2a4,0x484a,0x9402,0x9502,0x8721,0x8729,
+  0x4a01,0x5a03,0x0c01,0x6b01,0x6529,0x685a,0x0949,0xb19c,
+  0x6c73,0x8c7b,0x0932,0x4852,0x4a3a,0x4b32,0x4529,0x6621,
+  0xa821,0xae73,0xce7b,0xb502,0xa600,0x6a01,0x8300,0x7202,
+  0x7302,0xf802,0xb1a4,0x8e01,0x9ad6,0x4c32,0x2519,0x2a51,
+  0x2b32,0x4d6b,0x8629,0x8310,0xb294,0x2c63,0x18c6,0x75b5,
+  0x8d7b,0x8e73,0xa639,0x308c,0x494a,0xbef7,0x7094,0x6952,
+  0x9194,0x895a,0xbad6,0xd29c,0xce83,0x59ce,0xc700,0x718c,
+  0x6911,0x0b63,0x3302,0x8a52,0x6d6b,0x75ad,0x1202,0xa731,
+  0xc731,0x8f01,0x6d01,0xa631,0xc610,0x4c73,0x6c32,0xa800,
+  0x1ce7,0x2c6b,0x0421,0x14a5,0xad01,0xcd01,0x96b5,0x2b01,
+  0x4b01,0x4c01,0x6c01,0xd001,0x1084,0x3002,0x3102,0xa921,
+  0xc921,0xca21,0xea62,0xcb5a,0xcf7b,0x2809,0x4809,0xb6bd,
+  0xc739,0xd702,0xf702,0xce01,0x518c,0x694a,0x919c,0xa95a,
+  0x38c6,0x4909,0xb29c,0xca5a,0xae01,0xc600,0x9294,0xaa52,
+  0xb001,0xc800,0x34ad,0x4c6b,0x0c63,0x2421,0x9ef7,0xb6b5,
+  0x1102,0x2901,0x0701,0x8d32,0x8d73,0x0842,0x4521,0x5502,
+  0xe318,0xeb5a,0xf39c,0xfbde,0xe739,0xef7b,0xf7bd,0xffff,
+  0x79ce,0x8210,0x55ad,0x5def,0x7def,0x8631,0x34a5,0x3ce7,
+  0x2842,0x3084,0xd39c,0xdbde,0xd7bd,0xdfff,0xd602,0xe600,
+  0x0f02,0x0742,0xe900,0xf101,0xe700,0xef01,0x2a01,0x3202,
+  0xa700,0xaf01,0x8500,0x8d01,0x2521,0x2d01,0xe800,0xf001,
+  0x4901,0x5102,0x1002,0x1803,
+};
@@ -0,0 +1,13 @@
+
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+extern const uint16_t PathPalette[];
+enum { PATH_PALETTE_COUNT=204 };
+
@@ -9,63 +9,63 @@
 
 
 const PathSpriteDef PathSprites[]={
-  { 498432, 64, 128 },    // 100_torch_1 
-  { 515072, 64, 128 },    // 101_torch_2 
-  { 531712, 64, 128 },    // 102_torch_3 
-  { 548352, 64, 128 },    // 103_torch_4 
-  { 564992, 68, 52 },    // 104_enemy1_walk1_l 
-  { 572160, 68, 52 },    // 105_enemy1_walk2_l 
-  { 579328, 68, 52 },    // 106_enemy1_walk3_l 
-  { 586496, 68, 52 },    // 107_enemy1_walk4_l 
-  { 593664, 68, 52 },    // 108_enemy1_walk5_l 
-  { 600832, 68, 52 },    // 109_enemy1_walk6_l 
-  { 608000, 68, 52 },    // 110_enemy1_walk7_l 
-  { 615168, 68, 52 },    // 111_enemy1_walk8_l 
-  { 622336, 68, 52 },    // 112_enemy1_walk9_l 
-  { 629504, 68, 52 },    // 113_enemy1_walk10_l 
-  { 636672, 68, 52 },    // 114_enemy1_walk11_l 
-  { 643840, 68, 52 },    // 115_enemy1_walk12_l 
-  { 651008, 68, 52 },    // 116_enemy1_walk1_r 
-  { 658176, 68, 52 },    // 117_enemy1_walk2_r 
-  { 665344, 68, 52 },    // 118_enemy1_walk3_r 
-  { 672512, 68, 52 },    // 119_enemy1_walk4_r 
-  { 679680, 68, 52 },    // 120_enemy1_walk5_r 
-  { 686848, 68, 52 },    // 121_enemy1_walk6_r 
-  { 694016, 68, 52 },    // 122_enemy1_walk7_r 
-  { 701184, 68, 52 },    // 123_enemy1_walk8_r 
-  { 708352, 68, 52 },    // 124_enemy1_walk9_r 
-  { 715520, 68, 52 },    // 125_enemy1_walk10_r 
-  { 722688, 68, 52 },    // 126_enemy1_walk11_r 
-  { 729856, 68, 52 },    // 127_enemy1_walk12_r 
-  { 737024, 64, 76 },    // 128_enemy2_walk1_r 
-  { 747008, 64, 76 },    // 129_enemy2_walk2_r 
-  { 756992, 64, 76 },    // 130_enemy2_walk3_r 
-  { 766976, 64, 76 },    // 131_enemy2_walk4_r 
-  { 776960, 64, 76 },    // 132_enemy2_walk5_r 
-  { 786944, 64, 76 },    // 133_enemy2_walk6_r 
-  { 796928, 64, 76 },    // 134_enemy2_walk7_r 
-  { 806912, 64, 76 },    // 135_enemy2_walk8_r 
-  { 816896, 64, 76 },    // 136_enemy2_walk9_r 
-  { 826880, 64, 76 },    // 137_enemy2_walk10_r 
-  { 836864, 64, 76 },    // 138_enemy2_walk11_r 
-  { 846848, 64, 76 },    // 139_enemy2_walk12_r 
-  { 856832, 64, 76 },    // 140_enemy2_walk1_l 
-  { 866816, 64, 76 },    // 141_enemy2_walk2_l 
-  { 876800, 64, 76 },    // 142_enemy2_walk3_l 
-  { 886784, 64, 76 },    // 143_enemy2_walk4_l 
-  { 896768, 64, 76 },    // 144_enemy2_walk5_l 
-  { 906752, 64, 76 },    // 145_enemy2_walk6_l 
-  { 916736, 64, 76 },    // 146_enemy2_walk7_l 
-  { 926720, 64, 76 },    // 147_enemy2_walk8_l 
-  { 936704, 64, 76 },    // 148_enemy2_walk9_l 
-  { 946688, 64, 76 },    // 149_enemy2_walk10_l 
-  { 956672, 64, 76 },    // 150_enemy2_walk11_l 
-  { 966656, 64, 76 },    // 151_enemy2_walk12_l 
-  { 976640, 39, 64 },    // 152_moving_platform 
-  { 981760, 65, 64 },    // 153_saw_1 
-  { 990208, 65, 64 },    // 154_saw_2 
-  { 998656, 65, 64 },    // 155_saw_3 
-  { 1007104, 65, 64 },    // 156_saw_4 
-  { 1015552, 65, 64 },    // 157_saw_5 
-  { 1024000, 65, 64 },    // 158_saw_6 
+  { 498432, 64, 128, 0, 0, 0, 0 },    // 100_torch_1 
+  { 515072, 64, 128, 0, 0, 0, 0 },    // 101_torch_2 
+  { 531712, 64, 128, 0, 0, 0, 0 },    // 102_torch_3 
+  { 548352, 64, 128, 0, 0, 0, 0 },    // 103_torch_4 
+  { 564992, 68, 52, 0, 0, 1, 2241 },    // 104_enemy1_walk1_l 
+  { 569600, 68, 52, 0, 0, 1, 2187 },    // 105_enemy1_walk2_l 
+  { 574208, 68, 52, 0, 0, 1, 2166 },    // 106_enemy1_walk3_l 
+  { 578560, 68, 52, 0, 0, 1, 2184 },    // 107_enemy1_walk4_l 
+  { 583168, 68, 52, 0, 0, 1, 2166 },    // 108_enemy1_walk5_l 
+  { 587520, 68, 52, 0, 0, 1, 2187 },    // 109_enemy1_walk6_l 
+  { 564992, 68, 52, 0, 0, 1, 2241 },    // 110_enemy1_walk7_l 
+  { 592128, 68, 52, 0, 0, 1, 2185 },    // 111_enemy1_walk8_l 
+  { 596736, 68, 52, 0, 0, 1, 2101 },    // 112_enemy1_walk9_l 
+  { 601088, 68, 52, 0, 0, 1, 2047 },    // 113_enemy1_walk10_l 
+  { 596736, 68, 52, 0, 0, 1, 2101 },    // 114_enemy1_walk11_l 
+  { 592128, 68, 52, 0, 0, 1, 2185 },    // 115_enemy1_walk12_l 
+  { 564992, 68, 52, 1, 0, 1, 2241 },    // 116_enemy1_walk1_r 
+  { 569600, 68, 52, 1, 0, 1, 2187 },    // 117_enemy1_walk2_r 
+  { 574208, 68, 52, 1, 0, 1, 2166 },    // 118_enemy1_walk3_r 
+  { 578560, 68, 52, 1, 0, 1, 2184 },    // 119_enemy1_walk4_r 
+  { 583168, 68, 52, 1, 0, 1, 2166 },    // 120_enemy1_walk5_r 
+  { 587520, 68, 52, 1, 0, 1, 2187 },    // 121_enemy1_walk6_r 
+  { 564992, 68, 52, 1, 0, 1, 2241 },    // 122_enemy1_walk7_r 
+  { 592128, 68, 52, 1, 0, 1, 2185 },    // 123_enemy1_walk8_r 
+  { 596736, 68, 52, 1, 0, 1, 2101 },    // 124_enemy1_walk9_r 
+  { 601088, 68, 52, 1, 0, 1, 2047 },    // 125_enemy1_walk10_r 
+  { 596736, 68, 52, 1, 0, 1, 2101 },    // 126_enemy1_walk11_r 
+  { 592128, 68, 52, 1, 0, 1, 2185 },    // 127_enemy1_walk12_r 
+  { 605184, 64, 76, 0, 0, 1, 2313 },    // 128_enemy2_walk1_r 
+  { 610048, 64, 76, 0, 0, 1, 2316 },    // 129_enemy2_walk2_r 
+  { 614912, 64, 76, 0, 0, 1, 2282 },    // 130_enemy2_walk3_r 
+  { 619520, 64, 76, 0, 0, 1, 2290 },    // 131_enemy2_walk4_r 
+  { 614912, 64, 76, 0, 0, 1, 2282 },    // 132_enemy2_walk5_r 
+  { 624128, 64, 76, 0, 0, 1, 2315 },    // 133_enemy2_walk6_r 
+  { 628992, 64, 76, 0, 0, 1, 2313 },    // 134_enemy2_walk7_r 
+  { 633856, 64, 76, 0, 0, 1, 2310 },    // 135_enemy2_walk8_r 
+  { 638720, 64, 76, 0, 0, 1, 2289 },    // 136_enemy2_walk9_r 
+  { 643328, 64, 76, 0, 0, 1, 2229 },    // 137_enemy2_walk10_r 
+  { 647936, 64, 76, 0, 0, 1, 2288 },    // 138_enemy2_walk11_r 
+  { 652544, 64, 76, 0, 0, 1, 2310 },    // 139_enemy2_walk12_r 
+  { 605184, 64, 76, 1, 0, 1, 2313 },    // 140_enemy2_walk1_l 
+  { 610048, 64, 76, 1, 0, 1, 2316 },    // 141_enemy2_walk2_l 
+  { 614912, 64, 76, 1, 0, 1, 2282 },    // 142_enemy2_walk3_l 
+  { 619520, 64, 76, 1, 0, 1, 2290 },    // 143_enemy2_walk4_l 
+  { 614912, 64, 76, 1, 0, 1, 2282 },    // 144_enemy2_walk5_l 
+  { 624128, 64, 76, 1, 0, 1, 2315 },    // 145_enemy2_walk6_l 
+  { 628992, 64, 76, 1, 0, 1, 2313 },    // 146_enemy2_walk7_l 
+  { 633856, 64, 76, 1, 0, 1, 2310 },    // 147_enemy2_walk8_l 
+  { 638720, 64, 76, 1, 0, 1, 2289 },    // 148_enemy2_walk9_l 
+  { 643328, 64, 76, 1, 0, 1, 2229 },    // 149_enemy2_walk10_l 
+  { 647936, 64, 76, 1, 0, 1, 2288 },    // 150_enemy2_walk11_l 
+  { 652544, 64, 76, 1, 0, 1, 2310 },    // 151_enemy2_walk12_l 
+  { 657408, 39, 64, 0, 1, 0, 0 },    // 152_moving_platform 
+  { 659968, 65, 64, 0, 1, 0, 0 },    // 153_saw_1 
+  { 664320, 65, 64, 0, 1, 0, 0 },    // 154_saw_2 
+  { 668672, 65, 64, 0, 1, 0, 0 },    // 155_saw_3 
+  { 673024, 65, 64, 0, 1, 0, 0 },    // 156_saw_4 
+  { 677376, 65, 64, 0, 1, 0, 0 },    // 157_saw_5 
+  { 681728, 65, 64, 0, 1, 0, 0 },    // 158_saw_6 
 };
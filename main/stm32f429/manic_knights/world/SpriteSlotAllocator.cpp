@@ -0,0 +1,170 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Application.h"
+
+
+/*
+ * Constructor
+ * @param first The first slot that can be handed out
+ * @param last The last slot that can be handed out
+ */
+
+SpriteSlotAllocator::SpriteSlotAllocator(uint16_t first,uint16_t last)
+  : _first(first),
+    _last(last),
+    _clock(0),
+    _live(0),
+    _relocationCount(0) {
+
+  uint16_t i;
+
+  for(i=0;i<NUM_SLOTS;i++)
+    _keys[i]=FREE;
+
+  memset(_freedAt,0,sizeof(_freedAt));
+  memset(&_statistics,0,sizeof(_statistics));
+}
+
+
+/*
+ * Get a slot for an owner
+ * @param key The owner's place in the drawing order
+ * @param preferred The slot that the owner had last time, or NO_SLOT
+ * @return The slot, or NO_SLOT if they're all in use
+ */
+
+uint16_t SpriteSlotAllocator::allocate(uint16_t key,uint16_t preferred) {
+
+  int32_t i,below,above;
+  uint16_t best;
+
+  _relocationCount=0;
+
+  if(_live==_last-_first+1) {
+    _statistics.Failures++;
+    return NO_SLOT;
+  }
+
+  // find the live neighbours in the drawing order. The new slot must go between them.
+
+  below=_first-1;
+  above=_last+1;
+
+  for(i=_first;i<=_last;i++) {
+
+    if(_keys[i]==FREE)
+      continue;
+
+    if(_keys[i]<key)
+      below=i;
+    else if(above>_last)
+      above=i;
+  }
+
+  // nothing live above it: it goes straight after the highest live slot to keep them packed
+
+  if(above>_last && below<_last)
+    above=below+2;
+
+  // the slot it had before, the one that's been free the longest, or make a gap
+
+  if(preferred!=NO_SLOT && preferred>below && preferred<above && _keys[preferred]==FREE) {
+    best=preferred;
+    _statistics.Reused++;
+  }
+  else {
+
+    best=NO_SLOT;
+
+    for(i=below+1;i<above;i++)
+      if(_keys[i]==FREE && (best==NO_SLOT || _freedAt[i]<_freedAt[best]))
+        best=i;
+
+    if(best==NO_SLOT && (best=makeRoom(below,above))==NO_SLOT) {
+      _statistics.Failures++;
+      return NO_SLOT;
+    }
+  }
+
+  _keys[best]=key;
+  _live++;
+  _statistics.Allocations++;
+
+  return best;
+}
+
+
+/*
+ * There's no free slot between two live ones. Shift the live run that starts at 'above' up
+ * into the nearest free slot above it, or the run that ends at 'below' down into the nearest
+ * free slot below it, whichever moves fewer. There is a free slot somewhere.
+ * @return The slot that's been freed up in between, or NO_SLOT if too many would move
+ */
+
+uint16_t SpriteSlotAllocator::makeRoom(int32_t below,int32_t above) {
+
+  int32_t up,down,i;
+
+  for(up=above;up<=_last && _keys[up]!=FREE;up++);
+  for(down=below;down>=_first && _keys[down]!=FREE;down--);
+
+  if(up<=_last && (down<_first || up-above<=below-down)) {
+
+    if(up-above>MAX_RELOCATIONS)
+      return NO_SLOT;
+
+    for(i=up;i>above;i--)
+      relocate(i-1,i);
+
+    return above;
+  }
+
+  if(below-down>MAX_RELOCATIONS)
+    return NO_SLOT;
+
+  for(i=down;i<below;i++)
+    relocate(i+1,i);
+
+  return below;
+}
+
+
+/*
+ * Move a live slot to a free neighbour and note it for the caller
+ */
+
+void SpriteSlotAllocator::relocate(uint16_t from,uint16_t to) {
+
+  _keys[to]=_keys[from];
+  _keys[from]=FREE;
+
+  if(_relocationCount<MAX_RELOCATIONS) {
+
+    Relocation& r(_relocations[_relocationCount++]);
+
+    r.Key=_keys[to];
+    r.From=from;
+    r.To=to;
+  }
+
+  _statistics.Relocations++;
+}
+
+
+/*
+ * Give a slot back. The caller should already have hidden it.
+ */
+
+void SpriteSlotAllocator::release(uint16_t slot) {
+
+  if(slot<_first || slot>_last || _keys[slot]==FREE)
+    return;
+
+  _keys[slot]=FREE;
+  _freedAt[slot]=++_clock;
+  _live--;
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Hands out FPGA sprite slots to the sprites that are on screen. The sprite writer draws the
+ * slots in index order so each owner has a key and the live slots are always in key order: a
+ * higher key is drawn over a lower one.
+ *
+ * A new owner gets a free slot between the live neighbours of its key. It's the slot it had
+ * last time if that's still free, because the FPGA may still hold the record, or else the one
+ * that has been free the longest, which leaves recently released slots for their last owners.
+ * If there's no gap then the live slots above it are renumbered up by one into the nearest
+ * free slot (or those below it down by one) and the moves are reported as relocations for the
+ * caller to apply to the FPGA. At most MAX_RELOCATIONS are moved for one allocation.
+ *
+ * An owner that goes above all the live ones always gets the slot straight after the highest
+ * live slot. That keeps the live slots packed at the bottom of the range so the sprite writer's
+ * active range (CMD_LAST_SPRITE) stays short.
+ */
+
+class SpriteSlotAllocator {
+
+  public:
+
+    enum {
+      NUM_SLOTS = 512,
+      NO_SLOT = 0xffff,
+      FREE = 0xffff,
+      MAX_RELOCATIONS = 32
+    };
+
+    /*
+     * A live slot that was renumbered
+     */
+
+    struct Relocation {
+      uint16_t Key;
+      uint16_t From;
+      uint16_t To;
+    };
+
+    /*
+     * Counters since construction
+     */
+
+    struct Statistics {
+      uint32_t Allocations;
+      uint32_t Reused;            // got back the slot that it had before
+      uint32_t Relocations;
+      uint32_t Failures;          // no free slot at all
+    };
+
+  protected:
+    uint16_t _first;
+    uint16_t _last;
+    uint16_t _keys[NUM_SLOTS];
+    uint32_t _freedAt[NUM_SLOTS];
+    uint32_t _clock;
+    uint16_t _live;
+    Relocation _relocations[MAX_RELOCATIONS];
+    uint16_t _relocationCount;
+    Statistics _statistics;
+
+  protected:
+    uint16_t makeRoom(int32_t below,int32_t above);
+    void relocate(uint16_t from,uint16_t to);
+
+  public:
+    SpriteSlotAllocator(uint16_t first,uint16_t last);
+
+    uint16_t allocate(uint16_t key,uint16_t preferred);
+    void release(uint16_t slot);
+
+    uint16_t getRelocationCount() const;
+    const Relocation& getRelocation(uint16_t n) const;
+
+    uint16_t getLiveCount() const;
+    const Statistics& getStatistics() const;
+};
+
+
+/*
+ * Get the number of slots renumbered by the last allocate()
+ */
+
+inline uint16_t SpriteSlotAllocator::getRelocationCount() const {
+  return _relocationCount;
+}
+
+
+/*
+ * Get a relocation made by the last allocate()
+ */
+
+inline const SpriteSlotAllocator::Relocation& SpriteSlotAllocator::getRelocation(uint16_t n) const {
+  return _relocations[n];
+}
+
+
+/*
+ * Get the number of slots in use
+ */
+
+inline uint16_t SpriteSlotAllocator::getLiveCount() const {
+  return _live;
+}
+
+
+/*
+ * Get the counters
+ */
+
+inline const SpriteSlotAllocator::Statistics& SpriteSlotAllocator::getStatistics() const {
+  return _statistics;
+}
@@ -13,16 +13,68 @@
 
 class World {
 
+  public:
+
+    /*
+     * Per-phase timings of the last 8 blocks of 64 frames
+     */
+
+    typedef FrameProfiler<8,64> Profiler;
+
   protected:
     const LevelDef& _levelDef;
     Panel& _panel;
     Background _background;
-    Actor **_actors;
+    ActorEngine _actors;
+    AseSpriteBudget _budget;
+    Profiler _profiler;
+
+  protected:
+    uint32_t getFixedCycles() const;
 
   public:
     World(Panel& panel,const LevelDef& ldef);
-    ~World();
 
     void update(const Buttons& buttons,uint32_t frame_counter);
-    void createActors(Panel& panel);
+
+    Background& getBackground();
+    const ActorEngine& getActors() const;
+    AseSpriteBudget& getBudget();
+    Profiler& getProfiler();
 };
+
+
+/*
+ * Get a reference to the background
+ */
+
+inline Background& World::getBackground() {
+  return _background;
+}
+
+
+/*
+ * Get a reference to the actors
+ */
+
+inline const ActorEngine& World::getActors() const {
+  return _actors;
+}
+
+
+/*
+ * Get a reference to the sprite writer budget
+ */
+
+inline AseSpriteBudget& World::getBudget() {
+  return _budget;
+}
+
+
+/*
+ * Get a reference to the profiler
+ */
+
+inline World::Profiler& World::getProfiler() {
+  return _profiler;
+}
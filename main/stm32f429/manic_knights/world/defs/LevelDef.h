@@ -12,6 +12,11 @@
  */
 
 struct LevelDef {
+
+  enum {
+    MAX_ACTORS = 32                 // the size of the ActorEngine arrays
+  };
+
   const uint16_t *Tiles;            // The tile array (30*20)
   uint16_t ActorCount;              // number of actors in the array below
   const ActorDef *ActorDefs;        // pointer to array of actors
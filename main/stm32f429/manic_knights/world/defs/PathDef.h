@@ -9,8 +9,9 @@
 
 /*
  * Definition of an actor's path. A path starts and finishes at a point in the world. The
- * path should be horizontal or vertical. The actor is eased between the points using the
- * easing function to allow for acceleration and deceleration.
+ * path should be horizontal or vertical. The actor is eased between the points using a baked
+ * EasingCurve to allow for acceleration and deceleration. The curve's duration is the length
+ * of the path in frames.
  */
 
 struct PathDef {
@@ -20,9 +21,5 @@ struct PathDef {
   uint16_t FirstSpriteNumber;     // first sprite index
   uint16_t LastSpriteNumber;      // last sprite index
 
-  EasingType EasingFunction;      // the easing function used to move the sprite
-  EasingMode EasingInOutMode;     // the easing mode (in,out,inout)
-  float EasingDuration;           // total duration, in frames
-  float EasingParameter1;         // optional. used if easing function has parameters
-  float EasingParameter2;         // optional. used if easing function has parameters
+  const EasingCurve *Easing;      // the baked easing curve, e.g. &EasingTable<...>::Curve
 };
@@ -13,7 +13,8 @@
  */
 
 enum {
-  FIRST_PATH_SPRITE = 100
+  FIRST_PATH_SPRITE = 77,       // straight after the 7x11 background slots. The slots from here
+  LAST_PATH_SPRITE = 511        // to LAST_PATH_SPRITE are allocated to the actors on demand
 };
 
 
@@ -28,13 +29,20 @@ struct BackgroundSpriteDef {
 
 
 /*
- * Definition of a path (moving) sprite. The sprite number is assigned during the initialisation
+ * Definition of a path (moving) sprite. The sprite number is assigned during the initialisation.
+ * A mirrored sprite shares the flash of one that's its mirror image. An indexed sprite is one
+ * byte per pixel in flash and the colours are in PathPalette. A span sprite stores only its
+ * opaque pixels and SpanWords is the size of its stream.
  */
 
 struct PathSpriteDef {
   uint32_t FlashAddress;
   uint16_t PixelWidth;
   uint16_t PixelHeight;
+  uint8_t Mirror;             // 1 if the rows in flash are in reverse order
+  uint8_t Indexed;            // 1 if the flash holds PathPalette indexes
+  uint8_t Spans;              // 1 if the flash holds span headers and opaque pixels
+  uint32_t SpanWords;         // header and pixel words in a span sprite
 };
 
 
@@ -7,9 +7,12 @@
 #include "config/stm32plus.h"
 #include "config/timing.h"
 #include "config/display/tft.h"
+#include "config/exti.h"
 #include "Error.h"
 #include "FpgaProgrammer.h"
 #include "AseAccessMode.h"
+#include "AseEncodedCommand.h"
+#include "FrameScheduler.h"
 
 
 using namespace stm32plus;
@@ -98,23 +101,22 @@ class SpritesDemo {
 
     void loadSprites() {
 
-      LoadSpriteDef defs[8]= {
-        { 0, 0, 90624,  360, 230400, 1, 1, 1, 0, 359, 0, 639 },     // background
-        { 1, 0, 0    ,  112, 45248,  1, 1, 1, 0, 359, 0, 639 },     // andy's workshop
-        { 2, 0, 551680, 32,  1024,   1, 1, 0, 0, 359, 0, 639 },     // left1
-        { 3, 0, 553984, 32,  1024,   1, 1, 0, 0, 359, 0, 639 },     // left2
-        { 4, 0, 556288, 32,  1024,   1, 1, 0, 0, 359, 0, 639 },     // left3
-        { 5, 0, 558592, 32,  1024,   1, 1, 0, 0, 359, 0, 639 },     // right1
-        { 6, 0, 560896, 32,  1024,   1, 1, 0, 0, 359, 0, 639 },     // right2
-        { 7, 0, 563200, 32,  1024,   1, 1, 0, 0, 359, 0, 639 }      // right3
+      static constexpr LoadSpriteDef defs[8]= {
+        { 0, 0, 90624,  360, 230400, 1, 1, 1, 0, 359, 0, 639, 0, 0, 0, 0 },     // background
+        { 1, 0, 0    ,  112, 45248,  1, 1, 1, 0, 359, 0, 639, 0, 0, 0, 0 },     // andy's workshop
+        { 2, 0, 551680, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 },     // left1
+        { 3, 0, 553984, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 },     // left2
+        { 4, 0, 556288, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 },     // left3
+        { 5, 0, 558592, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 },     // right1
+        { 6, 0, 560896, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 },     // right2
+        { 7, 0, 563200, 32,  1024,   1, 1, 0, 0, 359, 0, 639, 0, 0, 0, 0 }      // right3
       };
 
-      uint8_t i;
+      // the compiler encodes them as one block in flash, ready to be sent as it is
 
-      // load up the sprites
+      static constexpr auto block=AseEncodedCommands::loadBlock(defs);
 
-      for(i=0;i<sizeof(defs)/sizeof(defs[0]);i++)
-        _accessMode.loadSprite(defs[i]);
+      block.flush(_accessMode);
     }
 
 
@@ -166,16 +168,11 @@ class SpritesDemo {
 
     /*
      * Animate our sprites. This is not the most efficient way to do this because it does not
-     * make use of the busy period to do 'game' calculations.
+     * make use of the busy period to do 'game' calculations. The core sleeps between frames.
      */
 
     void animateSprites() {
 
-      // set up the animation sequences for the walker
-
-      uint8_t walkerLeftSprites[]= { 2,3,4,3 };
-      uint8_t walkerRightSprites[]= { 5,6,7,6 };
-
       // set the logo position and dimensions
 
       _logoPosition.X=0;
@@ -190,18 +187,30 @@ class SpritesDemo {
       _walkerSpriteIndex=0;
       _walkerDirection=1;
 
-      for(;;) {
+      // animate the parts each time the FPGA has finished drawing
 
-        // wait for the next frame
+      FrameScheduler scheduler;
 
-        _accessMode.waitBusyStart();
-        _accessMode.waitBusyEnd();
+      scheduler.setCallback(FrameScheduler::BUSY_END,&SpritesDemo::onBusyEnd,this);
+      scheduler.run();
+    }
 
-        // animate the parts
 
-        animateLogo();
-        animateWalker(walkerLeftSprites,walkerRightSprites);
-      }
+    /*
+     * Frame scheduler callback
+     */
+
+    static void onBusyEnd(void *context) {
+
+      // the animation sequences for the walker
+
+      static const uint8_t walkerLeftSprites[]= { 2,3,4,3 };
+      static const uint8_t walkerRightSprites[]= { 5,6,7,6 };
+
+      SpritesDemo& demo(*static_cast<SpritesDemo *>(context));
+
+      demo.animateLogo();
+      demo.animateWalker(walkerLeftSprites,walkerRightSprites);
     }
 
 
@@ -50,9 +50,13 @@ package constants is
       reading_load_sprite_flash_addr_low,reading_load_sprite_flash_addr_mid,reading_load_sprite_flash_addr_high,
       reading_load_sprite_repeat_x,reading_load_sprite_repeat_y,reading_load_sprite_visible,
       reading_load_sprite_first_x,reading_load_sprite_last_x,reading_load_sprite_first_y,reading_load_sprite_last_y,
+    reading_load_block_first,reading_load_block_count,
     reading_mode,
     reading_move_sprite,reading_move_addr_low,reading_move_addr_high,
     reading_move_first_x,reading_move_last_x,reading_move_first_y,reading_move_last_y,
+    reading_offset_low,reading_offset_high,
+    reading_last_sprite,
+    reading_palette_first,reading_palette_count,reading_palette_colour_low,reading_palette_colour_high,
  
     execute_showhide_0,execute_showhide_1,execute_showhide_2,
     execute_load_sprite_0,execute_load_sprite_1,
@@ -146,7 +150,7 @@ package constants is
   -- subtypes for the various bit vectors
   --
 
-  subtype bram_data_t       is std_logic_vector(126 downto 0);
+  subtype bram_data_t       is std_logic_vector(131 downto 0);
   subtype sprite_number_t   is std_logic_vector(8 downto 0);
   subtype flash_addr_t      is std_logic_vector(23 downto 0);
   subtype sram_pixel_addr_t is std_logic_vector(17 downto 0);
@@ -158,9 +162,10 @@ package constants is
   subtype sprite_height_t   is std_logic_vector(9 downto 0);
   subtype pixel_t           is std_logic_vector(15 downto 0);
   subtype flash_io_bus_t    is std_logic_vector(3 downto 0);
+  subtype palette_index_t   is std_logic_vector(7 downto 0);
 
   --
-  -- Structure of a sprite in BRAM. Total size is 127 bits
+  -- Structure of a sprite in BRAM. Total size is 132 bits
   --
 
   type sprite_record_t is record
@@ -198,6 +203,27 @@ package constants is
     -- lasty is the offset of the last pixel to be displayed if the sprite is partially off the bottom
     lasty : sprite_height_t;
 
+    -- persistent flag (1 bit). The MCU says that nothing on or under this sprite changes so once
+    -- it has been drawn it can be skipped until the next command for it or viewport offset change
+    persistent : std_logic;
+
+    -- drawn flag (1 bit). Set by the sprite writer when it finishes drawing a persistent sprite
+    -- and cleared by every command that changes the record
+    drawn : std_logic;
+
+    -- mirror flag (1 bit). The rows are drawn bottom up from sram_addr, which is the start of the
+    -- bottom row. The panel is rotated so this is a left-right flip to the player.
+    mirror : std_logic;
+
+    -- indexed flag (1 bit). The sprite is stored in flash as one byte per pixel, an index into
+    -- the palette, instead of as a 16 bit colour.
+    indexed : std_logic;
+
+    -- spans flag (1 bit). The sprite is stored in flash as runs of opaque pixels, each after a
+    -- header word, and the transparent pixels between them aren't stored at all. size is the
+    -- number of words. A span sprite can't also be indexed.
+    spans : std_logic;
+
   end record;
 
   --
@@ -215,6 +241,10 @@ package constants is
   constant CMD_HIDE         : std_logic_vector(7 downto 0) := X"A4";
   constant CMD_LOAD         : std_logic_vector(7 downto 0) := X"A5";
   constant CMD_MOVE         : std_logic_vector(7 downto 0) := X"A6";
+  constant CMD_OFFSET       : std_logic_vector(7 downto 0) := X"A7";
+  constant CMD_LAST_SPRITE  : std_logic_vector(7 downto 0) := X"A8";
+  constant CMD_PALETTE      : std_logic_vector(7 downto 0) := X"A9";
+  constant CMD_LOAD_BLOCK   : std_logic_vector(7 downto 0) := X"AA";
 
 end constants;
 
@@ -45,6 +45,11 @@ package body functions is
     result(106 downto 98)  := arg.lastx;
     result(116 downto 107) := arg.firsty;
     result(126 downto 117) := arg.lasty;
+    result(127)            := arg.persistent;
+    result(128)            := arg.drawn;
+    result(129)            := arg.mirror;
+    result(130)            := arg.indexed;
+    result(131)            := arg.spans;
 
     return result;
   
@@ -70,6 +75,11 @@ package body functions is
     result.lastx := arg(106 downto 98);
     result.firsty := arg(116 downto 107);
     result.lasty := arg(126 downto 117);
+    result.persistent := arg(127);
+    result.drawn := arg(128);
+    result.mirror := arg(129);
+    result.indexed := arg(130);
+    result.spans := arg(131);
 
     return result;
 
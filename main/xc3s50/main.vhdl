@@ -159,6 +159,19 @@ architecture behavioral of main is
   );
   end component;
 
+  --
+  -- distributed RAM that holds the colours of the indexed sprites
+  --
+
+  component palette_memory port(
+    clk100 : in std_logic;
+    wr     : in std_logic;
+    addr   : in palette_index_t;
+    din    : in pixel_t;
+    dout   : out pixel_t
+  );
+  end component;
+
   -- 
   -- send a 16-bit value to the LCD via the 8-bit bus and latch
   --
@@ -203,6 +216,11 @@ architecture behavioral of main is
     bram_addr       : out sprite_number_t;
     bram_din        : out sprite_record_t;
     mode            : out mode_t;
+    viewport_offset : out sram_pixel_addr_t;
+    last_sprite     : out sprite_number_t;
+    palette_wr      : out std_logic;
+    palette_addr    : out palette_index_t;
+    palette_din     : out pixel_t;
     debug           : out std_logic
 
 --pragma synthesis_off
@@ -258,6 +276,9 @@ architecture behavioral of main is
     frame_index   : in  std_logic;
     flash_io_in   : in  flash_io_bus_t;
     bram_dout     : in  sprite_record_t;
+    viewport_offset : in sram_pixel_addr_t;
+    last_sprite   : in  sprite_number_t;
+    palette_dout  : in  pixel_t;
     
     -- outputs
     
@@ -269,8 +290,11 @@ architecture behavioral of main is
     flash_io_mode : out flash_io_mode_t;
     flash_clk     : out std_logic;
     bram_addr     : out sprite_number_t;
+    bram_din      : out sprite_record_t;
+    bram_wr       : out std_logic;
     bram_en_mcu_interface : out std_logic;
     bram_en_sprite_writer : out std_logic;
+    palette_addr  : out palette_index_t;
     busy          : out boolean;
     debug         : out std_logic
 
@@ -312,6 +336,8 @@ architecture behavioral of main is
   -- mcu interface signals
   
   signal mcu_interface_rs_i   : std_logic := '0';
+  signal viewport_offset_i    : sram_pixel_addr_t := (others => '0');
+  signal last_sprite_i        : sprite_number_t := LAST_SPRITE;
  
   -- BRAM signals (port A: mcu_interface, RW)
   
@@ -322,14 +348,25 @@ architecture behavioral of main is
   signal bram_a_wr_i       : std_logic_vector(0 downto 0) := (others => '0');
   signal bram_a_en_i       : std_logic := '0';
   
-  -- BRAM signals (port B: sprite_writer, R)
+  -- BRAM signals (port B: sprite_writer, RW to mark persistent sprites as drawn)
   
   signal bram_b_dout_i     : sprite_record_t;
   signal bram_b_dout_i_tmp : bram_data_t;
   signal bram_b_addr_i     : sprite_number_t := (others => '0');
+  signal bram_b_din_i      : sprite_record_t;
   signal bram_b_wr_i       : std_logic_vector(0 downto 0) := (others => '0');
   signal bram_b_en_i       : std_logic := '0';
 
+  -- palette signals. The sprite writer reads it while it's busy, the mcu_interface writes it otherwise.
+
+  signal palette_wr_i                 : std_logic := '0';
+  signal palette_addr_i               : palette_index_t;
+  signal palette_din_i                : pixel_t;
+  signal palette_dout_i               : pixel_t;
+  signal palette_wr_mcu_interface_i   : std_logic := '0';
+  signal palette_addr_mcu_interface_i : palette_index_t;
+  signal palette_addr_sprite_writer_i : palette_index_t;
+
   -- sprite_writer signals
   
   signal sram_addr_sprite_writer_i : sram_byte_addr_t;
@@ -378,13 +415,14 @@ begin
   bram_a_dout_i <= unpack_sprite_record(bram_a_dout_i_tmp);
   bram_b_dout_i <= unpack_sprite_record(bram_b_dout_i_tmp);
 
-  -- register the busy output
+  -- the palette has a single port that goes to whoever owns the BRAM
 
-  busy <= to_std_logic(sprite_writer_busy_i);
+  palette_addr_i <= palette_addr_sprite_writer_i when sprite_writer_busy_i else palette_addr_mcu_interface_i;
+  palette_wr_i <= palette_wr_mcu_interface_i when not sprite_writer_busy_i else '0';
 
-  -- never write to the B port
+  -- register the busy output
 
-  bram_b_wr_i(0) <= '0';
+  busy <= to_std_logic(sprite_writer_busy_i);
 
   -- debug output
 
@@ -438,6 +476,11 @@ begin
     bram_addr       => bram_a_addr_i,
     bram_din        => bram_a_din_i,
     mode            => mode_i,
+    viewport_offset => viewport_offset_i,
+    last_sprite     => last_sprite_i,
+    palette_wr      => palette_wr_mcu_interface_i,
+    palette_addr    => palette_addr_mcu_interface_i,
+    palette_din     => palette_din_i,
     debug           => open
 --pragma synthesis_off
     ,
@@ -458,10 +501,20 @@ begin
     enb   => bram_b_en_i,
     web   => bram_b_wr_i,
     addrb => bram_b_addr_i,
-    dinb  => (others => '0'),
+    dinb  => pack_sprite_record(bram_b_din_i),
     doutb => bram_b_dout_i_tmp
   );
 
+  -- Instantiate the palette
+
+  inst_palette_memory : palette_memory port map(
+    clk100 => clk100,
+    wr     => palette_wr_i,
+    addr   => palette_addr_i,
+    din    => palette_din_i,
+    dout   => palette_dout_i
+  );
+
   inst_frame_writer : frame_writer port map(
     reset       => conditioned_reset_i,
     clk100      => clk100,
@@ -483,6 +536,9 @@ begin
     frame_index   => frame_index_i,
     flash_io_in   => flash_io,
     bram_dout     => bram_b_dout_i,
+    viewport_offset => viewport_offset_i,
+    last_sprite   => last_sprite_i,
+    palette_dout  => palette_dout_i,
     sram_addr     => sram_addr_sprite_writer_i,
     sram_data     => sram_data_sprite_writer_i,
     sram_nwr      => sram_nwr_sprite_writer_i,
@@ -491,8 +547,11 @@ begin
     flash_io_mode => flash_io_mode_i,
     flash_clk     => flash_clk,
     bram_addr     => bram_b_addr_i,
+    bram_din      => bram_b_din_i,
+    bram_wr       => bram_b_wr_i(0),
     bram_en_mcu_interface => bram_a_en_i,
     bram_en_sprite_writer => bram_b_en_i,
+    palette_addr  => palette_addr_sprite_writer_i,
     busy          => sprite_writer_busy_i,
     debug         => open
 --pragma synthesis_off
@@ -39,6 +39,11 @@ entity mcu_interface is
     bram_addr       : out sprite_number_t;    -- address to read/write in BRAM
     bram_din        : out sprite_record_t;    -- data to write to BRAM
     mode            : out mode_t;             -- the current mode selection (default passthrough)
+    viewport_offset : out sram_pixel_addr_t;  -- subtracted from every sprite's SRAM address
+    last_sprite     : out sprite_number_t;    -- the sprite writer stops after this record
+    palette_wr      : out std_logic;          -- write enable for the palette memory
+    palette_addr    : out palette_index_t;    -- palette entry to write
+    palette_din     : out pixel_t;            -- colour to write to the palette
 
     debug           : out std_logic           -- internal debug flag (normally NC)
     
@@ -77,6 +82,7 @@ architecture behavioral of mcu_interface is
   signal lcd_sender_go_i : std_logic := '0';
   signal lcd_rs_i : std_logic := '0';
   signal cmd_flag_i : std_logic;
+  signal persistent_flag_i : std_logic;
   signal bram_addr_i : sprite_number_t := (others => '0');
   signal bram_din_i : sprite_record_t;
   signal bram_wr_i : std_logic := '0';
@@ -87,6 +93,16 @@ architecture behavioral of mcu_interface is
   signal visible_i : std_logic;
   signal data_ready_i : boolean := false;
   signal move_partial_i : boolean := false;
+  signal viewport_offset_i : sram_pixel_addr_t := (others => '0');
+  signal offset_low_i : mcu_bus_t;
+  signal last_sprite_i : sprite_number_t := LAST_SPRITE;
+  signal palette_wr_i : std_logic := '0';
+  signal palette_addr_i : palette_index_t := (others => '0');
+  signal palette_din_i : pixel_t;
+  signal palette_count_i : palette_index_t;
+  signal load_block_i : boolean := false;
+  signal load_block_next_i : boolean := false;
+  signal load_block_count_i : sprite_number_t;
 
   signal fifo_write_state_i : fifo_writer_state_t := idle;
   signal fifo_read_state_i : fifo_reader_state_t := idle;
@@ -111,6 +127,11 @@ begin
   bram_addr <= bram_addr_i;
   bram_din <= bram_din_i;
   mode <= mode_i;
+  viewport_offset <= viewport_offset_i;
+  last_sprite <= last_sprite_i;
+  palette_wr <= palette_wr_i;
+  palette_addr <= palette_addr_i;
+  palette_din <= palette_din_i;
 
   debug <= debug_i;
 
@@ -222,12 +243,23 @@ begin
 
         state_i <= passthrough_0;
         mode_i <= mode_passthrough;
+        viewport_offset_i <= (others => '0');
+        last_sprite_i <= LAST_SPRITE;
+        load_block_i <= false;
+        load_block_next_i <= false;
         
       else
 
         -- default values
         
         bram_wr_i <= '0';
+        palette_wr_i <= '0';
+
+        -- a palette colour is written for one clock and then the address moves on to the next entry
+
+        if palette_wr_i = '1' then
+          palette_addr_i <= palette_index_t(unsigned(palette_addr_i)+1);
+        end if;
 
         -- process the execute states
         
@@ -252,6 +284,8 @@ begin
           when execute_showhide_1 =>    
             bram_din_i <= bram_dout;
             bram_din_i.visible <= cmd_flag_i;
+            bram_din_i.persistent <= persistent_flag_i;
+            bram_din_i.drawn <= '0';
             bram_wr_i <= '1';
             state_i <= execute_showhide_2;
 
@@ -261,7 +295,8 @@ begin
             bram_wr_i <= '1';
             state_i <= reading_cmd;
   --pragma synthesis_off
-            REPORT "CMD_SHOW/HIDE: sprite = " & hstr(bram_addr_i) & " visible = " & std_logic'image(cmd_flag_i);
+            REPORT "CMD_SHOW/HIDE: sprite = " & hstr(bram_addr_i) & " visible = " & std_logic'image(cmd_flag_i) &
+                   " persistent = " & std_logic'image(persistent_flag_i);
   --pragma synthesis_on
 
           when execute_load_sprite_0 =>
@@ -270,7 +305,18 @@ begin
 
           when execute_load_sprite_1 =>         -- hold the write for this clock and we're done
             bram_wr_i <= '1';
-            state_i <= reading_cmd;
+
+            -- a block goes straight on to the next record. The address moves on when its first
+            -- parameter arrives, by which time the write held here has finished.
+
+            if load_block_i and load_block_count_i /= (load_block_count_i'range => '0') then
+              load_block_count_i <= sprite_number_t(unsigned(load_block_count_i)-1);
+              load_block_next_i <= true;
+              state_i <= reading_load_sprite_addr_low;
+            else
+              load_block_i <= false;
+              state_i <= reading_cmd;
+            end if;
   --pragma synthesis_off
             REPORT "CMD_LOAD: sprite = " & hstr(sprite_number_i) &
                    " flash_addr = " & hstr(bram_din_i.flash_addr) &
@@ -280,6 +326,10 @@ begin
                    " rep_x = " & hstr(bram_din_i.repeat_x) &
                    " rep_y = " & hstr(bram_din_i.repeat_y) &
                    " visible = " & std_logic'image(bram_din_i.visible) &
+                   " persistent = " & std_logic'image(bram_din_i.persistent) &
+                   " mirror = " & std_logic'image(bram_din_i.mirror) &
+                   " indexed = " & std_logic'image(bram_din_i.indexed) &
+                   " spans = " & std_logic'image(bram_din_i.spans) &
                    " firstx = " & hstr(bram_din_i.firstx) &
                    " lastx = " & hstr(bram_din_i.lastx) &
                    " firsty = " & hstr(bram_din_i.firsty) &
@@ -294,6 +344,7 @@ begin
             bram_din_i <= bram_dout;
             bram_din_i.sram_addr <= sram_start_i;
             bram_din_i.visible <= '1';
+            bram_din_i.drawn <= '0';
             bram_wr_i <= '1';
             state_i <= execute_move_2;
 
@@ -318,6 +369,7 @@ begin
             bram_din_i.lastx <= lastx_i;
             bram_din_i.firsty <= firsty_i;
             bram_din_i.lasty <= lasty_i;
+            bram_din_i.drawn <= '0';
             bram_wr_i <= '1';
             state_i <= execute_move_2;
 
@@ -376,11 +428,12 @@ begin
                       mode_i <= mode_passthrough;
                       state_i <= passthrough_0;
                   
-                    -- show a sprite (1 read)
+                    -- show a sprite (1 read). Bit 9 set is CMD_SHOW_PERSISTENT.
                     -- params: sprite(9)
                     
                     when CMD_SHOW =>
                       cmd_flag_i <= '1';
+                      persistent_flag_i <= fifo_data_i(fifo_data_i'left);
                       state_i <= reading_showhide_sprite;
                     
                     -- hide a sprite (1 read)
@@ -388,10 +441,11 @@ begin
                     
                     when CMD_HIDE =>
                       cmd_flag_i <= '0';
+                      persistent_flag_i <= '0';
                       state_i <= reading_showhide_sprite;
 
                     -- load a full sprite (11 reads)
-                    -- params: sprite(9),x(9),y(10),width(9),pixel_size(18),flash_start(24),rep_x(9),rep_y(10),flags(1)
+                    -- params: sprite(9),x(9),y(10),width(9),pixel_size(18),flash_start(24),rep_x(9),rep_y(10),flags(5)
                     
                     when CMD_LOAD =>
                       state_i <= reading_load_sprite_number;
@@ -403,6 +457,30 @@ begin
                       move_partial_i <= to_boolean(fifo_data_i(fifo_data_i'left));
                       state_i <= reading_move_sprite;
 
+                    -- set the viewport offset (2 reads)
+                    -- params: offset(18)
+
+                    when CMD_OFFSET =>
+                      state_i <= reading_offset_low;
+
+                    -- set the last sprite record that the sprite writer reads (1 read)
+                    -- params: sprite(9)
+
+                    when CMD_LAST_SPRITE =>
+                      state_i <= reading_last_sprite;
+
+                    -- write consecutive palette entries (2 + 2*count reads)
+                    -- params: first(8), count-1(8), count * (colour low(8), colour high(8))
+
+                    when CMD_PALETTE =>
+                      state_i <= reading_palette_first;
+
+                    -- load consecutive sprites (2 + 15*count reads)
+                    -- params: first(9), count-1(9), count * (the CMD_LOAD params after the sprite number)
+
+                    when CMD_LOAD_BLOCK =>
+                      state_i <= reading_load_block_first;
+
                     when others =>
                       null;
 
@@ -454,6 +532,73 @@ begin
                   lasty_i <= fifo_data_i(lasty_i'left downto 0);
                   state_i <= execute_move_partial_0;
 
+                -- read the viewport offset. The register is updated in one go when the high bits
+                -- arrive so the sprite writer never sees half of it.
+
+                when reading_offset_low =>
+                  offset_low_i <= fifo_data_i;
+                  state_i <= reading_offset_high;
+
+                when reading_offset_high =>
+                  viewport_offset_i <= fifo_data_i(7 downto 0) & offset_low_i;
+                  state_i <= reading_cmd;
+  --pragma synthesis_off
+                  REPORT "CMD_OFFSET: offset = " & hstr(fifo_data_i(7 downto 0) & offset_low_i);
+  --pragma synthesis_on
+
+                -- read the last sprite number. Like the viewport offset it's not in BRAM so it can
+                -- be written while the sprite writer is busy. It's latched at the start of a pass.
+
+                when reading_last_sprite =>
+                  last_sprite_i <= fifo_data_i(last_sprite_i'left downto 0);
+                  state_i <= reading_cmd;
+  --pragma synthesis_off
+                  REPORT "CMD_LAST_SPRITE: sprite = " & hstr(fifo_data_i(last_sprite_i'left downto 0));
+  --pragma synthesis_on
+
+                -- read the palette entries. Like the BRAM the palette belongs to the sprite writer
+                -- while it's busy and a colour written then is lost.
+
+                when reading_palette_first =>
+                  palette_addr_i <= fifo_data_i(palette_addr_i'left downto 0);
+                  state_i <= reading_palette_count;
+
+                when reading_palette_count =>
+                  palette_count_i <= fifo_data_i(palette_count_i'left downto 0);
+                  state_i <= reading_palette_colour_low;
+
+                when reading_palette_colour_low =>
+                  palette_din_i(7 downto 0) <= fifo_data_i(7 downto 0);
+                  state_i <= reading_palette_colour_high;
+
+                when reading_palette_colour_high =>
+                  palette_din_i(15 downto 8) <= fifo_data_i(7 downto 0);
+                  palette_wr_i <= '1';
+
+                  if palette_count_i = (palette_count_i'range => '0') then
+                    state_i <= reading_cmd;
+                  else
+                    palette_count_i <= palette_index_t(unsigned(palette_count_i)-1);
+                    state_i <= reading_palette_colour_low;
+                  end if;
+
+                -- read the first sprite and the count for the block load. The records that follow
+                -- are read by the load command's states.
+
+                when reading_load_block_first =>
+                  bram_addr_i <= fifo_data_i(sprite_number_i'left downto 0);
+                  state_i <= reading_load_block_count;
+
+                when reading_load_block_count =>
+                  load_block_count_i <= fifo_data_i(load_block_count_i'left downto 0);
+                  load_block_i <= true;
+                  load_block_next_i <= false;
+                  state_i <= reading_load_sprite_addr_low;
+  --pragma synthesis_off
+                  REPORT "CMD_LOAD_BLOCK: first = " & hstr(bram_addr_i) &
+                         " count-1 = " & hstr(fifo_data_i(load_block_count_i'left downto 0));
+  --pragma synthesis_on
+
                 -- read all the parameters for the load command
                 
                 when reading_load_sprite_number =>     -- read the sprite number
@@ -462,6 +607,12 @@ begin
                   
                 when reading_load_sprite_addr_low => 
                   bram_din_i.sram_addr(9 downto 0) <= fifo_data_i;
+
+                  if load_block_next_i then
+                    bram_addr_i <= sprite_number_t(unsigned(bram_addr_i)+1);
+                    load_block_next_i <= false;
+                  end if;
+
                   state_i <= reading_load_sprite_addr_high;
                   
                 when reading_load_sprite_addr_high =>
@@ -502,6 +653,11 @@ begin
                 
                 when reading_load_sprite_visible =>
                   bram_din_i.visible <= fifo_data_i(0);
+                  bram_din_i.persistent <= fifo_data_i(1);
+                  bram_din_i.drawn <= '0';
+                  bram_din_i.mirror <= fifo_data_i(2);
+                  bram_din_i.indexed <= fifo_data_i(3);
+                  bram_din_i.spans <= fifo_data_i(4);
                   state_i <= reading_load_sprite_first_x;
 
                 when reading_load_sprite_first_x =>
@@ -0,0 +1,60 @@
+-- This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+-- Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+-- Please see website for licensing terms.
+
+library ieee;
+
+use ieee.std_logic_1164.all;
+use ieee.numeric_std.all;
+
+use work.constants.all;
+
+
+--
+-- palette_memory holds the 256 colours used by indexed sprites. All four block RAMs are taken by
+-- the sprite records so this is single port distributed RAM with a synchronous write and an
+-- asynchronous read. main gives the address to the sprite writer while it's busy and to the
+-- mcu_interface while it isn't, in the same way as the BRAM ports are enabled.
+--
+
+entity palette_memory is
+  port(
+
+    -- inputs
+
+    clk100 : in std_logic;          -- 100MHz clock
+    wr     : in std_logic;          -- write enable
+    addr   : in palette_index_t;    -- entry to read or write
+    din    : in pixel_t;            -- colour to write
+
+    -- outputs
+
+    dout   : out pixel_t            -- colour at addr
+  );
+end entity palette_memory;
+
+architecture behavioural of palette_memory is
+
+  type palette_t is array(0 to 255) of pixel_t;
+
+  signal palette_i : palette_t := (others => TRANSPARENT);
+
+  attribute ram_style : string;
+  attribute ram_style of palette_i : signal is "distributed";
+
+begin
+
+  dout <= palette_i(to_integer(unsigned(addr)));
+
+  process(clk100) is
+  begin
+
+    if rising_edge(clk100) then
+      if wr = '1' then
+        palette_i(to_integer(unsigned(addr))) <= din;
+      end if;
+    end if;
+
+  end process;
+
+end architecture behavioural;
@@ -11,7 +11,26 @@ use work.functions.all;
 
 -- sprite_writer makes a pass through the BRAM sprite records and transfers each visible sprite
 -- from flash to SRAM. SRAM is not cleared down so there should usually be enough sprites to fill
--- the background.
+-- the background. The pass stops after the last_sprite record, which the MCU sets to the highest
+-- record that it has made visible.
+--
+-- A persistent sprite is marked as drawn in BRAM once it has been written out in full and then
+-- skipped, because its pixels are still in SRAM, until the MCU sends another command for it or
+-- the viewport offset changes.
+--
+-- A mirrored sprite starts at its bottom row and each row is written one SRAM row above the last.
+--
+-- An indexed sprite has one byte per pixel in flash that is looked up in the palette. The pixel
+-- loop still takes 4 clocks because of the two SRAM byte writes, so the flash clock is stopped on
+-- every other clock and each byte takes 4 clocks to read instead of 2. The data read in a state
+-- was clocked out by the edge enabled two states before.
+--
+-- A span sprite is a stream of 16-bit words in which each run of opaque pixels follows a header:
+-- bit 15 is set on the last run in a row, bits 14..8 are the number of transparent pixels to skip
+-- before the run and bits 7..0 are its length. A header takes the place of a pixel in the loop
+-- but isn't written and doesn't move the position on by one. Instead it moves it on past the
+-- skipped pixels, or to the start of the next row after the last run in a row. The skipped pixels
+-- aren't read from flash at all. The position jumps, so the clipping test for X is a range test.
 
 entity sprite_writer is
 
@@ -26,6 +45,9 @@ entity sprite_writer is
     frame_index   : in  std_logic;              -- current frame index (0/1)
     flash_io_in   : in  flash_io_bus_t;         -- data that we read from the flash
     bram_dout     : in  sprite_record_t;        -- data that we read from BRAM port B
+    viewport_offset : in sram_pixel_addr_t;     -- subtracted from each sprite's SRAM address
+    last_sprite   : in  sprite_number_t;        -- the last record to read in a pass
+    palette_dout  : in  pixel_t;                -- the palette colour at palette_addr
 
     -- outputs
     
@@ -37,8 +59,11 @@ entity sprite_writer is
     flash_io_mode : out flash_io_mode_t;        -- how we're operating the flash
     flash_clk     : out std_logic;              -- the 100MHz flash clock
     bram_addr     : out sprite_number_t;        -- the BRAM address on port B
+    bram_din      : out sprite_record_t;        -- data to write back to BRAM port B
+    bram_wr       : out std_logic;              -- WR line for BRAM port B
     bram_en_mcu_interface : out std_logic;      -- BRAM EN signal on port A
     bram_en_sprite_writer : out std_logic;      -- BRAM EN signal on port B
+    palette_addr  : out palette_index_t;        -- the palette entry to look up
     busy          : out boolean;                -- our busy signal (goes out to a pin)
     debug         : out std_logic               -- debug signal (normally NC)
 
@@ -92,7 +117,11 @@ architecture behavioral of sprite_writer is
   signal sram_adder_a_i   : sram_byte_addr_t;
   signal sram_adder_b_i   : byte_width_t;
   signal sram_adder_sum_i : sram_byte_addr_t;
+  signal sram_row_up_i    : sram_byte_addr_t;
   signal sram_org_i       : sram_byte_addr_t;
+  signal viewport_offset_i : sram_pixel_addr_t := (others => '0');
+  signal last_sprite_i    : sprite_number_t := LAST_SPRITE;
+  signal redraw_i         : boolean := false;
   signal sram_next_x_i    : sram_byte_addr_t;
   signal sram_addr_i      : sram_byte_addr_t;
   signal sram_data_i      : sram_data_t;
@@ -104,6 +133,10 @@ architecture behavioral of sprite_writer is
   signal last_pixel_i      : pixel_t;
   signal pixel_i           : std_logic_vector(15 downto 4);   -- last 4 bits transferred direct to last_pixel_i from flash bus
   signal first_in_column_i : boolean;
+  signal palette_addr_i    : palette_index_t;
+  signal span_run_i        : std_logic_vector(7 downto 0);    -- pixels left in the current span
+  signal span_last_i       : std_logic;                       -- the current span ends its row
+  signal span_slot_i       : boolean;                         -- last_pixel_i holds a span header
 
   signal xok_i,yok_i : boolean;
   signal xok_reset_i : boolean;
@@ -114,6 +147,8 @@ architecture behavioral of sprite_writer is
   signal nextx_adder_sum_i : sprite_width_t;
 
   signal bram_addr_i : sprite_number_t;
+  signal bram_din_i : sprite_record_t;
+  signal bram_wr_i : std_logic := '0';
   signal bram_en_mcu_interface_i : std_logic;
   signal bram_en_sprite_writer_i : std_logic;
 
@@ -174,8 +209,11 @@ begin
   debug <= debug_i;
   busy <= busy_i;
   bram_addr <= bram_addr_i;
+  bram_din <= bram_din_i;
+  bram_wr <= bram_wr_i;
   bram_en_mcu_interface <= bram_en_mcu_interface_i;
   bram_en_sprite_writer <= bram_en_sprite_writer_i;
+  palette_addr <= palette_addr_i;
 
 --pragma synthesis_off
   state_out_sim <= state_i;
@@ -198,6 +236,10 @@ begin
 
       else 
 
+        -- default values
+
+        bram_wr_i <= '0';
+
         case state_i is
         
           -- if we're in sprite mode and we're entering frame '1' then we can start
@@ -205,6 +247,9 @@ begin
           when idle =>
             
             if mode = mode_sprite and last_frame_index_i = '0' and frame_index_i = '1' then
+              redraw_i <= viewport_offset /= viewport_offset_i;   -- everything moved on the screen
+              viewport_offset_i <= viewport_offset;     -- latched for the whole pass
+              last_sprite_i <= last_sprite;             -- records above this are not read
               state_i <= bram_0;
             end if;
 
@@ -239,18 +284,19 @@ begin
           when bram_1 =>            -- hold for data out
             state_i <= bram_2;
 
-          when bram_2 =>            -- if not visible then fast-forward to the next sprite
-            if bram_dout.visible = '0' then
+          when bram_2 =>            -- if not visible or already drawn then fast-forward to the next sprite
+            if bram_dout.visible = '0' or (bram_dout.persistent = '1' and bram_dout.drawn = '1' and not redraw_i) then
               state_i <= next_sprite;
             else
               sprite_record_i <= bram_dout;       -- get a copy of the sprite data record
               state_i <= outer_setup_0;
             end if;
 
-          -- calculate the first origin and get the resettable y counter
+          -- calculate the first origin and get the resettable y counter. The viewport offset is
+          -- subtracted modulo the 18-bit pixel address so sprites can be positioned in world space.
 
           when outer_setup_0 =>
-            sram_org_i <= sprite_record_i.sram_addr & "0";      -- pixel -> byte address
+            sram_org_i <= sram_pixel_addr_t(unsigned(sprite_record_i.sram_addr)-unsigned(viewport_offset_i)) & "0";      -- pixel -> byte address
             sprite_repeat_y_i <= sprite_record_i.repeat_y;
             first_in_column_i <= true;
             yok_i <= false;               -- the *ok_i signals are true if current posn is within the partial ranges
@@ -396,32 +442,60 @@ begin
             state_i <= data_out_pause1;
 
           when data_out_pause1 =>
+            flash_clk_ce_i <= not sprite_record_i.indexed;    -- indexed: hold the first nibble for 2 clocks
             state_i <= first_pixel_read_0;
 
           -- read out the first pixel (2 x 8 bits). this primes last_pixel_i because the main loop will
           -- write out last_pixel_i to SRAM while concurrently reading the next pixel from flash.
+          -- An indexed pixel is 2 x 4 bits read in states 0 and 2 and looked up in state 3.
 
           when first_pixel_read_0 =>
             last_pixel_i(15 downto 12) <= flash_io_in;
+            flash_clk_ce_i <= '1';
             state_i <= first_pixel_read_1;
 
           when first_pixel_read_1 =>
             last_pixel_i(11 downto 8) <= flash_io_in;
+            flash_clk_ce_i <= not sprite_record_i.indexed;
             state_i <= first_pixel_read_2;
 
           when first_pixel_read_2 =>
             last_pixel_i(7 downto 4) <= flash_io_in;
+            palette_addr_i <= last_pixel_i(15 downto 12) & flash_io_in;
+            flash_clk_ce_i <= '1';
             state_i <= first_pixel_read_3;
 
           when first_pixel_read_3 =>
-            last_pixel_i(3 downto 0) <= flash_io_in;
+            if sprite_record_i.indexed = '1' then
+              last_pixel_i <= palette_dout;
+            else
+              last_pixel_i(3 downto 0) <= flash_io_in;
+            end if;
+
+            flash_clk_ce_i <= not sprite_record_i.indexed;
             
-            -- first setting of xok, yok so they can be tested
-            -- in the next state
+            if sprite_record_i.spans = '1' then
+
+              -- the first word is the first header of the first row
+
+              span_run_i <= last_pixel_i(7 downto 4) & flash_io_in;
+              span_last_i <= last_pixel_i(15);
+              span_slot_i <= true;
+
+              sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+unsigned(last_pixel_i(14 downto 8) & "0"));
+              x_i <= sprite_width_t(unsigned(x_i)+unsigned(last_pixel_i(14 downto 8)));
+
+            else
+
+              span_slot_i <= false;
+
+              -- first setting of xok, yok so they can be tested
+              -- in the next state
 
-            if x_i = sprite_record_i.firstx then
-              xok_i <= true;
-              xok_reset_i <= true;
+              if x_i = sprite_record_i.firstx then
+                xok_i <= true;
+                xok_reset_i <= true;
+              end if;
             end if;
 
             state_i <= pixel_read_0;
@@ -436,6 +510,7 @@ begin
 
               sram_adder_a_i <= sram_org_i;
               sram_adder_b_i <= "1011010000";     -- 360*2 = next row in SRAM 
+              sram_row_up_i <= sram_byte_addr_t(unsigned(sram_org_i)-720);    -- previous row if mirrored
 
               -- decrease the number of pixels remaining to be read
 
@@ -444,6 +519,7 @@ begin
               -- get the top 4 bits of the next pixel from flash
 
               pixel_i(15 downto 12) <= flash_io_in;
+              flash_clk_ce_i <= '1';
 
               -- update the ok-to-write flag for the Y direction
 
@@ -453,7 +529,7 @@ begin
 
               -- if all clear at the current position then write out the last pixel we read in
 
-              if last_pixel_i /= TRANSPARENT and xok_i and (yok_i or (y_i = sprite_record_i.firsty)) then
+              if last_pixel_i /= TRANSPARENT and xok_i and (yok_i or (y_i = sprite_record_i.firsty)) and not span_slot_i then
                 sram_nwr_i <= SRAM_WRITE;
               end if;
 
@@ -466,15 +542,19 @@ begin
 
           when pixel_read_1 =>
             
-            -- get the second 4 bits from flash
+            -- get the second 4 bits from flash, or stop the clock between the two indexed nibbles
 
             pixel_i(11 downto 8) <= flash_io_in;
+            flash_clk_ce_i <= not sprite_record_i.indexed;
 
             -- finish the SRAM write transaction, if there was one and update the address for
-            -- the second lot of 8 bits
+            -- the second lot of 8 bits. A span header has no position of its own.
 
             sram_nwr_i <= SRAM_READ;
-            sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+1);
+
+            if not span_slot_i then
+              sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+1);
+            end if;
             
             -- decrease the number of pixels remaining on this row
 
@@ -484,13 +564,16 @@ begin
 
           when pixel_read_2 =>
             
-            -- get the third lot of 4 bits from the flash
+            -- get the third lot of 4 bits from the flash. For an indexed pixel this is the low half
+            -- of the index and the palette has the colour by the next state.
 
             pixel_i(7 downto 4) <= flash_io_in;
+            palette_addr_i <= pixel_i(15 downto 12) & flash_io_in;
+            flash_clk_ce_i <= '1';
 
             -- as before, if we're in a position to write data then do it
 
-            if last_pixel_i /= TRANSPARENT and xok_i and yok_i then
+            if last_pixel_i /= TRANSPARENT and xok_i and yok_i and not span_slot_i then
               sram_nwr_i <= SRAM_WRITE;
             end if;
 
@@ -504,7 +587,9 @@ begin
               xok_i <= false;
             end if;
 
-            x_i <= sprite_width_t(unsigned(x_i)+1);   -- may get reset in next state
+            if not span_slot_i then
+              x_i <= sprite_width_t(unsigned(x_i)+1);   -- may get reset in next state
+            end if;
 
             state_i <= pixel_read_3;
 
@@ -516,9 +601,72 @@ begin
             
             -- set up the new 'last_pixel' with data previously read and the last 4 bits from flash
 
-            last_pixel_i <= pixel_i & flash_io_in;
+            if sprite_record_i.indexed = '1' then
+              last_pixel_i <= palette_dout;
+            else
+              last_pixel_i <= pixel_i & flash_io_in;
+            end if;
+
+            flash_clk_ce_i <= not sprite_record_i.indexed;
+
+            if sprite_record_i.spans = '1' then
 
-            if sprite_size_i = (sprite_size_i'range => '0') then
+              if span_run_i = (span_run_i'range => '0') then
+
+                -- the new word is a header. It's the first in the next row if the last span ended
+                -- its row, otherwise the skip follows on from the last position.
+
+                span_run_i <= pixel_i(7 downto 4) & flash_io_in;
+                span_last_i <= pixel_i(15);
+                span_slot_i <= true;
+
+                if span_last_i = '1' then
+
+                  if sprite_record_i.mirror = '1' then
+                    sram_addr_i <= sram_byte_addr_t(unsigned(sram_row_up_i)+unsigned(pixel_i(14 downto 8) & "0"));
+                    sram_org_i <= sram_row_up_i;
+                  else
+                    sram_addr_i <= sram_byte_addr_t(unsigned(sram_adder_sum_i)+unsigned(pixel_i(14 downto 8) & "0"));
+                    sram_org_i <= sram_adder_sum_i;
+                  end if;
+
+                  x_i <= sprite_width_t(unsigned(xorg_i)+unsigned(pixel_i(14 downto 8)));
+
+                  if y_i = sprite_record_i.lasty then
+                    yok_i <= false;
+                  end if;
+
+                  y_i <= sprite_height_t(unsigned(y_i)+1);
+
+                elsif span_slot_i then
+                  sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+unsigned(pixel_i(14 downto 8) & "0"));
+                  x_i <= sprite_width_t(unsigned(x_i)+unsigned(pixel_i(14 downto 8)));
+                else
+                  sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+1+unsigned(pixel_i(14 downto 8) & "0"));
+                  x_i <= sprite_width_t(unsigned(x_i)+unsigned(pixel_i(14 downto 8)));
+                end if;
+
+              else
+
+                -- the new word is a pixel in the current span
+
+                span_run_i <= std_logic_vector(unsigned(span_run_i)-1);
+                span_slot_i <= false;
+
+                if not span_slot_i then
+                  sram_addr_i <= sram_byte_addr_t(unsigned(sram_addr_i)+1);
+                end if;
+
+                xok_i <= unsigned(x_i) >= unsigned(sprite_record_i.firstx) and unsigned(x_i) <= unsigned(sprite_record_i.lastx);
+              end if;
+
+              if sprite_size_i = (sprite_size_i'range => '0') then
+                state_i <= last_pixel_write_0;
+              else
+                state_i <= pixel_read_0;
+              end if;
+
+            elsif sprite_size_i = (sprite_size_i'range => '0') then
               
               -- loop done, but we've cached the last pixel and that needs to be written
 
@@ -529,8 +677,14 @@ begin
 
               -- end of just this row
 
-              sram_addr_i <= sram_adder_sum_i;
-              sram_org_i <= sram_adder_sum_i;
+              if sprite_record_i.mirror = '1' then
+                sram_addr_i <= sram_row_up_i;
+                sram_org_i <= sram_row_up_i;
+              else
+                sram_addr_i <= sram_adder_sum_i;
+                sram_org_i <= sram_adder_sum_i;
+              end if;
+
               sprite_width_i <= sprite_record_i.width;
 
               -- x resets back to row start state
@@ -569,7 +723,7 @@ begin
             
             -- if all the conditions are a-ok then the first half-pixel is written
 
-            if last_pixel_i /= TRANSPARENT and xok_i and yok_i then
+            if last_pixel_i /= TRANSPARENT and xok_i and yok_i and not span_slot_i then
               sram_nwr_i <= SRAM_WRITE;
             end if;
 
@@ -588,7 +742,7 @@ begin
             
             -- as before, the pixel goes out if the conditions allow
 
-            if last_pixel_i /= TRANSPARENT and xok_i and yok_i then
+            if last_pixel_i /= TRANSPARENT and xok_i and yok_i and not span_slot_i then
               sram_nwr_i <= SRAM_WRITE;
             end if;
 
@@ -615,9 +769,13 @@ begin
               state_i <= done_this_sprite_2;
             
             else
-              -- move down the column to the next sprite
+              -- move down the column to the next sprite, or up if mirrored
 
-              sram_org_i <= sram_adder_sum_i;
+              if sprite_record_i.mirror = '1' then
+                sram_org_i <= sram_row_up_i;
+              else
+                sram_org_i <= sram_adder_sum_i;
+              end if;
 
               x_i <= xorg_i;
               xok_i <= xok_reset_i;
@@ -657,9 +815,20 @@ begin
             end if;
 
           when next_sprite =>
-            if sprite_number_i = LAST_SPRITE then
 
-              -- if we've passed through all the sprites then back to idle
+            -- a persistent sprite that has just been drawn is marked in BRAM. Port B still has
+            -- its address and the write happens in the next state before the address changes.
+
+            if bram_dout.visible = '1' and bram_dout.persistent = '1' and bram_dout.drawn = '0' then
+              bram_din_i <= bram_dout;
+              bram_din_i.drawn <= '1';
+              bram_wr_i <= '1';
+            end if;
+
+            if sprite_number_i = last_sprite_i then
+
+              -- if we've passed through all the active sprites then back to idle. The records
+              -- above the last one aren't read at all so their 4 cycles each go to pixel copying.
 
               state_i <= idle;
             else
@@ -0,0 +1,385 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <atomic>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "config/stm32plus.h"
+#include "config/timing.h"
+#include "AseCommands.h"
+#include "LoadSpriteDef.h"
+#include "MoveSpriteDef.h"
+#include "AseAccessMode.h"
+#include "AseCommandBuffer.h"
+#include "AseCommandQueue.h"
+#include "AseCommandDecoder.h"
+
+
+using namespace stm32plus;
+
+
+/**
+ * Host stress test of AseCommandQueue. A producer thread builds frames of random commands
+ * into a small queue, so that it's full and wraps all the time, while a consumer thread drains
+ * it with BUSY going up and down at random. Every frame is built again into an AseCommandBuffer
+ * from the same seed and the consumer checks that what it receives is exactly those frames,
+ * whole and in order, that every burst decodes into whole commands and that nothing is sent
+ * while BUSY is high. A single threaded check of the overflow behaviour runs first.
+ *
+ * Usage: command_queue [frames]
+ */
+
+class command_queue {
+
+  protected:
+
+    enum {
+      QUEUE_WORDS = 256,
+      QUEUE_FRAMES = 4,
+      MAX_COMMANDS = 12,              // 12 x 17 = 204 words at most in a frame
+      MAX_SKIP = 16,                  // the most words that can be skipped at the end of the ring
+      BUSY_PIN = 14                   // PC14
+    };
+
+    typedef AseCommandQueue<QUEUE_WORDS,QUEUE_FRAMES> Queue;
+    typedef AseCommandBuffer<MAX_COMMANDS*17> Reference;
+
+    /*
+     * The bus that the consumer's access mode writes to
+     */
+
+    struct Receiver : AseEmulatorBus {
+
+      std::vector<uint16_t> Received;
+      uint32_t Bursts;
+      uint32_t StreamErrors;
+      uint32_t BusyWrites;
+
+      virtual void writeBus(uint16_t /* value */) override {
+        StreamErrors++;
+      }
+
+      virtual void writeEncodedBus(const uint16_t *encoded,uint32_t numWords) override {
+
+        std::vector<AseCommandDecoder::Command> commands;
+        uint32_t errorWord;
+
+        if(AseCommandDecoder::decode(encoded,numWords,commands,errorWord)!=AseCommandDecoder::OK)
+          StreamErrors++;
+
+        if(HostGpio::pin(HOST_PORTC,BUSY_PIN))
+          BusyWrites++;
+
+        Received.insert(Received.end(),encoded,encoded+numWords*2);
+        Bursts++;
+      }
+    };
+
+    uint32_t _frames;
+    std::atomic<bool> _failed;
+
+  protected:
+    template<class TEncoder>
+    static void build(TEncoder& encoder,uint32_t frameNumber);
+
+    static void reference(uint32_t frameNumber,std::vector<uint16_t>& words);
+
+    bool checkOverflow();
+    void producer(Queue& queue);
+    void consumer(Queue& queue,Receiver& receiver);
+
+  public:
+    command_queue(uint32_t frames);
+    int run();
+};
+
+
+/**
+ * Constructor
+ */
+
+command_queue::command_queue(uint32_t frames)
+  : _frames(frames),
+    _failed(false) {
+}
+
+
+/**
+ * Build a frame of random commands. The same frame number always gives the same commands.
+ */
+
+template<class TEncoder>
+void command_queue::build(TEncoder& encoder,uint32_t frameNumber) {
+
+  std::minstd_rand rng(frameNumber+1);
+  LoadSpriteDef lsd;
+  MoveSpriteDef md;
+  uint32_t i,count;
+
+  count=1+rng() % MAX_COMMANDS;
+
+  // the first command identifies the frame
+
+  encoder.setLastSprite(frameNumber & 0x1ff);
+
+  for(i=1;i<count;i++) {
+
+    switch(rng() % 6) {
+
+      case 0:
+        memset(&lsd,0,sizeof(lsd));
+        lsd.SpriteNumber=rng() & 0x1ff;
+        lsd.SramAddress=rng() & 0x3ffff;
+        lsd.FlashAddress=rng() & 0xffffff;
+        lsd.PixelWidth=rng() % 360;
+        lsd.NumPixels=rng() & 0x3ffff;
+        lsd.RepeatX=lsd.RepeatY=1;
+        lsd.Visible=1;
+        lsd.LastX=359;
+        lsd.LastY=639;
+        encoder.loadSprite(lsd);
+        break;
+
+      case 1:
+        encoder.moveSprite(rng() & 0x1ff,rng() & 0x3ffff);
+        break;
+
+      case 2:
+        md.SpriteNumber=rng() & 0x1ff;
+        md.SramAddress=rng() & 0x3ffff;
+        md.FirstX=md.FirstY=0;
+        md.LastX=359;
+        md.LastY=639;
+        encoder.moveSprite(md);
+        break;
+
+      case 3:
+        encoder.showSprite(rng() & 0x1ff,rng() & 1);
+        break;
+
+      case 4:
+        encoder.hideSprite(rng() & 0x1ff);
+        break;
+
+      default:
+        encoder.setViewportOffset(rng() % 920,rng() % 1280);
+        break;
+    }
+  }
+}
+
+
+/**
+ * Get the encoded words that a frame should arrive as
+ */
+
+void command_queue::reference(uint32_t frameNumber,std::vector<uint16_t>& words) {
+
+  Reference buffer;
+
+  build(buffer,frameNumber);
+  words.assign(buffer.getEncoded(),buffer.getEncoded()+buffer.getWordCount()*2);
+}
+
+
+/**
+ * Single threaded: a full queue drops whole commands, an open frame is never sent and a
+ * published frame that had a command dropped is still sent whole.
+ */
+
+bool command_queue::checkOverflow() {
+
+  AseAccessMode accessMode;
+  Receiver receiver;
+  Queue queue;
+  uint32_t i;
+  bool ok;
+
+  AseEmulatorBus::attach(&receiver);
+  receiver.Bursts=receiver.StreamErrors=receiver.BusyWrites=0;
+
+  // 15 loads is 255 words. The 16th doesn't fit.
+
+  LoadSpriteDef lsd;
+  memset(&lsd,0,sizeof(lsd));
+
+  for(i=0;i<16;i++)
+    queue.loadSprite(lsd);
+
+  ok=queue.isOverflowed() && queue.getWordCount()==15*17 && queue.getFreeWords()==1;
+
+  // the open frame must not be sent
+
+  ok&=queue.drain(accessMode)==0 && receiver.Received.empty();
+
+  // publish it and it all goes, overflow cleared
+
+  ok&=queue.endFrame() && !queue.isOverflowed();
+  ok&=queue.drain(accessMode)==1 && receiver.Received.size()==15*17*2 && queue.isEmpty();
+  ok&=receiver.StreamErrors==0 && queue.getFreeWords()==QUEUE_WORDS;
+
+  // the next load has to skip the last word of the ring and is sent as one burst
+
+  receiver.Received.clear();
+  receiver.Bursts=0;
+
+  queue.loadSprite(lsd);
+  queue.endFrame();
+
+  ok&=queue.drain(accessMode)==1 && receiver.Bursts==1 && receiver.Received.size()==17*2;
+
+  // frames wait while BUSY is high
+
+  queue.hideSprite(1);
+  queue.endFrame();
+
+  HostGpio::pin(HOST_PORTC,BUSY_PIN)=true;
+  ok&=queue.drain(accessMode)==0 && !queue.isEmpty();
+  HostGpio::pin(HOST_PORTC,BUSY_PIN)=false;
+  ok&=queue.drain(accessMode)==1 && queue.isEmpty();
+
+  AseEmulatorBus::attach(nullptr);
+
+  printf("overflow check:  %s\n",ok ? "passed" : "FAILED");
+  return ok;
+}
+
+
+/**
+ * Producer thread: build each frame when there's room for its worst case and publish it
+ */
+
+void command_queue::producer(Queue& queue) {
+
+  std::vector<uint16_t> words;
+  uint32_t frame;
+
+  for(frame=0;frame<_frames && !_failed;frame++) {
+
+    reference(frame,words);
+
+    while(queue.getFreeWords()<words.size()/2+MAX_SKIP) {
+      if(_failed)
+        return;
+      std::this_thread::yield();
+    }
+
+    build(queue,frame);
+
+    if(queue.isOverflowed()) {
+      fprintf(stderr,"frame %u: overflowed with %u words free\n",frame,queue.getFreeWords());
+      _failed=true;
+      return;
+    }
+
+    while(!queue.endFrame()) {
+      if(_failed)
+        return;
+      std::this_thread::yield();
+    }
+  }
+}
+
+
+/**
+ * Consumer thread: drain with BUSY toggling at random and check each frame as it arrives
+ */
+
+void command_queue::consumer(Queue& queue,Receiver& receiver) {
+
+  AseAccessMode accessMode;
+  std::minstd_rand rng(12345);
+  std::vector<uint16_t> expected,words;
+  uint32_t frame;
+  uint8_t sent;
+
+  frame=0;
+
+  while(frame<_frames && !_failed) {
+
+    HostGpio::pin(HOST_PORTC,BUSY_PIN)=(rng() & 3)==0;
+
+    receiver.Received.clear();
+    sent=queue.drain(accessMode);
+
+    if(HostGpio::pin(HOST_PORTC,BUSY_PIN) && sent) {
+      fprintf(stderr,"frame %u: sent while busy\n",frame);
+      _failed=true;
+      return;
+    }
+
+    if(!sent)
+      std::this_thread::yield();
+
+    expected.clear();
+
+    while(sent--) {
+      reference(frame++,words);
+      expected.insert(expected.end(),words.begin(),words.end());
+    }
+
+    if(receiver.Received!=expected) {
+      fprintf(stderr,"frame %u: received %u words, expected %u\n",frame,
+          static_cast<uint32_t>(receiver.Received.size()/2),static_cast<uint32_t>(expected.size()/2));
+      _failed=true;
+      return;
+    }
+  }
+
+  HostGpio::pin(HOST_PORTC,BUSY_PIN)=false;
+}
+
+
+/**
+ * Run the test
+ */
+
+int command_queue::run() {
+
+  Receiver receiver;
+  Queue queue;
+
+  if(!checkOverflow())
+    return 1;
+
+  receiver.Bursts=receiver.StreamErrors=receiver.BusyWrites=0;
+  AseEmulatorBus::attach(&receiver);
+
+  std::thread consumerThread(&command_queue::consumer,this,std::ref(queue),std::ref(receiver));
+  std::thread producerThread(&command_queue::producer,this,std::ref(queue));
+
+  producerThread.join();
+  consumerThread.join();
+
+  AseEmulatorBus::attach(nullptr);
+
+  printf("stress test:     %u frames in %u bursts, %u stream errors, %u written while busy\n",
+      _frames,receiver.Bursts,receiver.StreamErrors,receiver.BusyWrites);
+
+  if(_failed || receiver.StreamErrors || receiver.BusyWrites) {
+    printf("FAILED\n");
+    return 1;
+  }
+
+  printf("passed\n");
+  return 0;
+}
+
+
+/*
+ * Main entry point
+ */
+
+int main(int argc,char *argv[]) {
+
+  command_queue test(argc>1 ? strtoul(argv[1],nullptr,10) : 1000000);
+  return test.run();
+}
@@ -31,6 +31,8 @@ using namespace stm32plus::display;
  *
  * Note that the LCD declaration is for the type B panel more commonly found on ebay (R61523_Portrait_64K_TypeB).
  * If you have a type A (see my reverse engineering article) then strip off the _TypeB from the end.
+ *
+ * The rectangle fills are sent by the AseDmaWriter so the CPU is free while they go out.
  */
 
 class lcd {
@@ -50,6 +52,12 @@ class lcd {
 
     AseAccessMode _accessMode;
 
+    /**
+     * Timer paced DMA for the pixel fills
+     */
+
+    AseDmaWriter _dmaWriter;
+
 
     /**
      * Run the test
@@ -61,6 +69,7 @@ class lcd {
       programmer.program();
 
       _accessMode.resetFpga();
+      _accessMode.setDmaWriter(&_dmaWriter);
       lcdTest();
 
       for(;;);
@@ -123,6 +132,15 @@ class lcd {
 };
 
 
+/*
+ * The DMA writer's transfer complete interrupt
+ */
+
+extern "C" void DMA2_Stream2_IRQHandler() {
+  AseDmaWriter::onInterrupt();
+}
+
+
 /*
  * Main entry point
  */
@@ -0,0 +1,35 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+// host includes
+
+#include <cerrno>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <map>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <thread>
+#include <fstream>
+#include <iterator>
+
+// asset compiler includes
+
+#include "ContentHash.h"
+#include "Frame.h"
+#include "FileUtil.h"
+#include "ParallelFor.h"
+#include "PngReader.h"
+#include "TiledMap.h"
+#include "SpanEncoder.h"
+#include "MedianCut.h"
+#include "FrameCache.h"
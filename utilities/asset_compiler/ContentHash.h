@@ -0,0 +1,104 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * 64-bit FNV-1a hash of everything that goes into a converted frame. It names the frame in
+ * the cache so a source that hasn't changed is never decoded again.
+ */
+
+class ContentHash {
+
+  protected:
+    uint64_t _value;
+
+  public:
+    ContentHash();
+
+    ContentHash& add(const void *data,size_t size);
+    ContentHash& add(const std::string& str);
+    ContentHash& add(uint32_t value);
+
+    uint64_t getValue() const;
+    std::string toString() const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline ContentHash::ContentHash()
+  : _value(UINT64_C(14695981039346656037)) {
+}
+
+
+/*
+ * Add some bytes
+ */
+
+inline ContentHash& ContentHash::add(const void *data,size_t size) {
+
+  const uint8_t *ptr=static_cast<const uint8_t *>(data);
+
+  while(size--) {
+    _value^=*ptr++;
+    _value*=UINT64_C(1099511628211);
+  }
+
+  return *this;
+}
+
+
+/*
+ * Add a string and its length, so that "ab"+"c" and "a"+"bc" differ
+ */
+
+inline ContentHash& ContentHash::add(const std::string& str) {
+  add(static_cast<uint32_t>(str.size()));
+  return add(str.data(),str.size());
+}
+
+
+/*
+ * Add a number
+ */
+
+inline ContentHash& ContentHash::add(uint32_t value) {
+
+  uint8_t bytes[4];
+
+  bytes[0]=value;
+  bytes[1]=value >> 8;
+  bytes[2]=value >> 16;
+  bytes[3]=value >> 24;
+
+  return add(bytes,sizeof(bytes));
+}
+
+
+/*
+ * Get the hash value
+ */
+
+inline uint64_t ContentHash::getValue() const {
+  return _value;
+}
+
+
+/*
+ * Get the hash as 16 hex digits
+ */
+
+inline std::string ContentHash::toString() const {
+
+  char str[17];
+
+  snprintf(str,sizeof(str),"%016llx",static_cast<unsigned long long>(_value));
+  return str;
+}
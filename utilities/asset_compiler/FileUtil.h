@@ -0,0 +1,186 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+#include <dirent.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+/*
+ * File system helpers. Generated files are only written when their content changes so that
+ * the firmware build doesn't recompile the world sources after every asset build.
+ */
+
+class FileUtil {
+
+  public:
+    enum WriteResult {
+      WRITTEN,
+      UNCHANGED,
+      FAILED
+    };
+
+  public:
+    static bool readFile(const std::string& filename,std::string& content);
+    static bool writeFile(const std::string& filename,const std::string& content);
+    static WriteResult updateFile(const std::string& filename,const std::string& content);
+
+    static bool listFiles(const std::string& dir,const std::string& extension,std::vector<std::string>& names);
+    static bool makeDirectory(const std::string& dir);
+
+    static std::string join(const std::string& dir,const std::string& name);
+    static std::string directoryOf(const std::string& path);
+    static std::string baseName(const std::string& path);
+};
+
+
+/*
+ * Read a whole file
+ */
+
+inline bool FileUtil::readFile(const std::string& filename,std::string& content) {
+
+  std::ifstream in(filename.c_str(),std::ios::in | std::ios::binary);
+
+  if(!in)
+    return false;
+
+  content.assign(std::istreambuf_iterator<char>(in),std::istreambuf_iterator<char>());
+  return !in.bad();
+}
+
+
+/*
+ * Write a whole file. It's written to a temporary name and then renamed so a reader never
+ * sees half of it, which matters for the cache when two runs overlap.
+ */
+
+inline bool FileUtil::writeFile(const std::string& filename,const std::string& content) {
+
+  std::string temp;
+  FILE *f;
+  bool ok;
+
+  temp=filename+".tmp"+std::to_string(getpid());
+
+  if((f=fopen(temp.c_str(),"wb"))==nullptr)
+    return false;
+
+  ok=fwrite(content.data(),1,content.size(),f)==content.size();
+  ok&=fclose(f)==0;
+
+  if(ok && rename(temp.c_str(),filename.c_str())==0)
+    return true;
+
+  unlink(temp.c_str());
+  return false;
+}
+
+
+/*
+ * Write a file if it doesn't exist or its content is different
+ */
+
+inline FileUtil::WriteResult FileUtil::updateFile(const std::string& filename,const std::string& content) {
+
+  std::string existing;
+
+  if(readFile(filename,existing) && existing==content)
+    return UNCHANGED;
+
+  return writeFile(filename,content) ? WRITTEN : FAILED;
+}
+
+
+/*
+ * Get the names of the files in a directory that end with an extension, without the extension
+ * and sorted into byte order as "ls | sort" does in the C locale
+ */
+
+inline bool FileUtil::listFiles(const std::string& dir,const std::string& extension,std::vector<std::string>& names) {
+
+  DIR *d;
+  struct dirent *entry;
+
+  if((d=opendir(dir.c_str()))==nullptr)
+    return false;
+
+  while((entry=readdir(d))!=nullptr) {
+
+    std::string name(entry->d_name);
+
+    if(name.size()>extension.size() && name.compare(name.size()-extension.size(),extension.size(),extension)==0)
+      names.push_back(name.substr(0,name.size()-extension.size()));
+  }
+
+  closedir(d);
+  std::sort(names.begin(),names.end());
+
+  return true;
+}
+
+
+/*
+ * Create a directory if it doesn't exist. The parent must exist.
+ */
+
+inline bool FileUtil::makeDirectory(const std::string& dir) {
+
+  struct stat st;
+
+  if(stat(dir.c_str(),&st)==0)
+    return S_ISDIR(st.st_mode);
+
+  return mkdir(dir.c_str(),0777)==0 || errno==EEXIST;
+}
+
+
+/*
+ * Join a directory and a name
+ */
+
+inline std::string FileUtil::join(const std::string& dir,const std::string& name) {
+
+  if(dir.empty() || dir==".")
+    return name;
+
+  return dir[dir.size()-1]=='/' ? dir+name : dir+"/"+name;
+}
+
+
+/*
+ * Get the directory part of a path, "." if there isn't one
+ */
+
+inline std::string FileUtil::directoryOf(const std::string& path) {
+
+  std::string::size_type pos;
+
+  if((pos=path.rfind('/'))==std::string::npos)
+    return ".";
+
+  return pos==0 ? "/" : path.substr(0,pos);
+}
+
+
+/*
+ * Get the name part of a path without its extension
+ */
+
+inline std::string FileUtil::baseName(const std::string& path) {
+
+  std::string name;
+  std::string::size_type pos;
+
+  name=(pos=path.rfind('/'))==std::string::npos ? path : path.substr(pos+1);
+
+  if((pos=name.rfind('.'))!=std::string::npos && pos>0)
+    name.erase(pos);
+
+  return name;
+}
@@ -0,0 +1,124 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * A converted image. Each pixel is a 16-bit word in the order that it's read back from flash,
+ * first byte in the high half, which is how convert.pl and the span headers have always seen
+ * them. The colour itself is R61523 5-6-5 with blue in the top bits, stored low byte first.
+ * The transparent colour, magenta, reads as 0x1ff8.
+ */
+
+struct Frame {
+
+  enum {
+    TRANSPARENT = 0x1ff8
+  };
+
+  uint16_t Width;
+  uint16_t Height;
+  std::vector<uint16_t> Words;
+
+  Frame();
+  Frame(uint16_t width,uint16_t height);
+
+  static uint16_t fromRgb(uint8_t r,uint8_t g,uint8_t b);
+
+  Frame mirrored() const;
+  Frame rotatedLeft() const;
+  std::string toBytes() const;
+  static std::string toBytes(const std::vector<uint16_t>& words);
+};
+
+
+/*
+ * Constructors
+ */
+
+inline Frame::Frame()
+  : Width(0),
+    Height(0) {
+}
+
+inline Frame::Frame(uint16_t width,uint16_t height)
+  : Width(width),
+    Height(height),
+    Words(static_cast<size_t>(width)*height) {
+}
+
+
+/*
+ * Convert an 8-bit RGB colour the same way as "bm2rgbi r61523 64". Each channel is truncated.
+ * Alpha is ignored, as it always has been, so transparent areas must be painted magenta.
+ */
+
+inline uint16_t Frame::fromRgb(uint8_t r,uint8_t g,uint8_t b) {
+
+  uint16_t colour;
+
+  colour=((b >> 3) << 11) | ((g >> 2) << 5) | (r >> 3);
+  return (colour << 8) | (colour >> 8);
+}
+
+
+/*
+ * Get a copy with the rows in reverse order. The panel is used on its side so this is a
+ * left-right flip to the player.
+ */
+
+inline Frame Frame::mirrored() const {
+
+  Frame frame(Width,Height);
+  uint16_t y;
+
+  for(y=0;y<Height;y++)
+    std::copy(Words.begin()+y*Width,Words.begin()+(y+1)*Width,frame.Words.begin()+(Height-1-y)*Width);
+
+  return frame;
+}
+
+
+/*
+ * Get a copy turned 90 degrees anticlockwise. Background tiles are drawn in the map's
+ * orientation and stored in the panel's.
+ */
+
+inline Frame Frame::rotatedLeft() const {
+
+  Frame frame(Height,Width);
+  uint16_t x,y;
+
+  for(y=0;y<Width;y++)
+    for(x=0;x<Height;x++)
+      frame.Words[y*Height+x]=Words[x*Width+Width-1-y];
+
+  return frame;
+}
+
+
+/*
+ * Get the frame as it's written to a .bin file
+ */
+
+inline std::string Frame::toBytes() const {
+  return toBytes(Words);
+}
+
+inline std::string Frame::toBytes(const std::vector<uint16_t>& words) {
+
+  std::string bytes;
+
+  bytes.reserve(words.size()*2);
+
+  for(uint16_t word : words) {
+    bytes.push_back(static_cast<char>(word >> 8));
+    bytes.push_back(static_cast<char>(word & 0xff));
+  }
+
+  return bytes;
+}
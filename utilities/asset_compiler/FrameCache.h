@@ -0,0 +1,144 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * A directory of converted frames named by the content hash of everything they were made
+ * from. A source that hasn't changed since the last run is found here and isn't decoded. An
+ * entry is the width and height, little endian, then the words as they're written to flash.
+ * Entries are never changed once written so the directory can be deleted at any time.
+ */
+
+class FrameCache {
+
+  public:
+    enum {
+      VERSION = 1                 // change when the conversion changes to invalidate old entries
+    };
+
+  protected:
+    std::string _dir;
+    bool _enabled;
+    std::atomic<uint32_t> _hits;
+    std::atomic<uint32_t> _misses;
+
+  protected:
+    std::string entryName(const ContentHash& key) const;
+
+  public:
+    FrameCache();
+
+    bool open(const std::string& dir,bool enabled);
+
+    bool load(const ContentHash& key,Frame& frame);
+    bool store(const ContentHash& key,const Frame& frame) const;
+
+    uint32_t getHits() const;
+    uint32_t getMisses() const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline FrameCache::FrameCache()
+  : _enabled(false),
+    _hits(0),
+    _misses(0) {
+}
+
+
+/*
+ * Get the file name of an entry
+ */
+
+inline std::string FrameCache::entryName(const ContentHash& key) const {
+  return FileUtil::join(_dir,key.toString()+".frame");
+}
+
+
+/*
+ * Create the directory. If the cache isn't enabled then everything misses but the new
+ * entries are still stored for next time.
+ */
+
+inline bool FrameCache::open(const std::string& dir,bool enabled) {
+
+  _dir=dir;
+  _enabled=enabled;
+
+  return FileUtil::makeDirectory(dir);
+}
+
+
+/*
+ * Look up a frame
+ */
+
+inline bool FrameCache::load(const ContentHash& key,Frame& frame) {
+
+  std::string content;
+  size_t i;
+
+  if(_enabled && FileUtil::readFile(entryName(key),content) && content.size()>=4) {
+
+    frame.Width=static_cast<uint8_t>(content[0]) | (static_cast<uint8_t>(content[1]) << 8);
+    frame.Height=static_cast<uint8_t>(content[2]) | (static_cast<uint8_t>(content[3]) << 8);
+
+    if(content.size()==4+static_cast<size_t>(frame.Width)*frame.Height*2) {
+
+      frame.Words.resize(static_cast<size_t>(frame.Width)*frame.Height);
+
+      for(i=0;i<frame.Words.size();i++)
+        frame.Words[i]=(static_cast<uint8_t>(content[4+i*2]) << 8) | static_cast<uint8_t>(content[5+i*2]);
+
+      _hits++;
+      return true;
+    }
+  }
+
+  _misses++;
+  return false;
+}
+
+
+/*
+ * Add a frame
+ */
+
+inline bool FrameCache::store(const ContentHash& key,const Frame& frame) const {
+
+  std::string content;
+
+  content.push_back(static_cast<char>(frame.Width & 0xff));
+  content.push_back(static_cast<char>(frame.Width >> 8));
+  content.push_back(static_cast<char>(frame.Height & 0xff));
+  content.push_back(static_cast<char>(frame.Height >> 8));
+  content+=frame.toBytes();
+
+  return FileUtil::writeFile(entryName(key),content);
+}
+
+
+/*
+ * Get the number of frames found
+ */
+
+inline uint32_t FrameCache::getHits() const {
+  return _hits;
+}
+
+
+/*
+ * Get the number of frames that had to be converted
+ */
+
+inline uint32_t FrameCache::getMisses() const {
+  return _misses;
+}
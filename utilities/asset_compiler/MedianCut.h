@@ -0,0 +1,121 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Median cut quantiser for 5-6-5 colours. The colours are split into boxes, each time cutting
+ * the box with the widest range in any one channel at its median, and each box becomes the
+ * average of its colours. It's exact if there are no more colours than palette entries. Ties
+ * go to the first box and channel found so the palette is the same from run to run.
+ */
+
+class MedianCut {
+
+  protected:
+    static uint16_t channel(uint16_t colour,int c);
+
+  public:
+    static void quantise(std::vector<uint16_t> colours,
+                         uint16_t size,
+                         std::vector<uint16_t>& palette,
+                         std::map<uint16_t,uint16_t>& mapping);
+};
+
+
+/*
+ * Get channel 0, 1 or 2 of a colour. Channel 0 is the top 5 bits.
+ */
+
+inline uint16_t MedianCut::channel(uint16_t colour,int c) {
+
+  static const uint8_t shift[3]={ 11,5,0 };
+  static const uint8_t mask[3]={ 0x1f,0x3f,0x1f };
+
+  return (colour >> shift[c]) & mask[c];
+}
+
+
+/*
+ * Make the palette and the map of colour to palette index
+ */
+
+inline void MedianCut::quantise(std::vector<uint16_t> colours,
+                                uint16_t size,
+                                std::vector<uint16_t>& palette,
+                                std::map<uint16_t,uint16_t>& mapping) {
+
+  std::vector<std::vector<uint16_t>> boxes;
+  int widest,range,c,best;
+  size_t i;
+
+  palette.clear();
+  mapping.clear();
+
+  if(colours.empty())
+    return;
+
+  std::sort(colours.begin(),colours.end());
+  boxes.push_back(colours);
+
+  while(boxes.size()<size) {
+
+    // find the box with the widest range in any one channel
+
+    widest=-1;
+    range=0;
+    best=0;
+
+    for(i=0;i<boxes.size();i++) {
+      for(c=0;c<3;c++) {
+
+        auto mm=std::minmax_element(boxes[i].begin(),boxes[i].end(),[c](uint16_t a,uint16_t b) {
+          return channel(a,c)<channel(b,c);
+        });
+
+        if(channel(*mm.second,c)-channel(*mm.first,c)>range) {
+          range=channel(*mm.second,c)-channel(*mm.first,c);
+          widest=i;
+          best=c;
+        }
+      }
+    }
+
+    if(widest<0)
+      break;
+
+    // split it at the median of that channel
+
+    std::vector<uint16_t> box;
+
+    box.swap(boxes[widest]);
+    boxes.erase(boxes.begin()+widest);
+
+    std::stable_sort(box.begin(),box.end(),[best](uint16_t a,uint16_t b) {
+      return channel(a,best)<channel(b,best);
+    });
+
+    boxes.push_back(std::vector<uint16_t>(box.begin(),box.begin()+box.size()/2));
+    boxes.push_back(std::vector<uint16_t>(box.begin()+box.size()/2,box.end()));
+  }
+
+  // each box becomes the average of its colours, rounded
+
+  for(i=0;i<boxes.size();i++) {
+
+    uint32_t sum[3]={ 0,0,0 };
+    uint32_t n=boxes[i].size();
+
+    for(uint16_t colour : boxes[i]) {
+      for(c=0;c<3;c++)
+        sum[c]+=channel(colour,c);
+      mapping[colour]=i;
+    }
+
+    palette.push_back((((sum[0]*2+n)/(2*n)) << 11) | (((sum[1]*2+n)/(2*n)) << 5) | ((sum[2]*2+n)/(2*n)));
+  }
+}
@@ -0,0 +1,57 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Run a function for each index in 0..count-1 on a number of threads. The threads take the
+ * next index from a shared counter so a slow item doesn't hold up a fixed share of the rest.
+ * The function must only write to its own item. Returns false if any call returned false,
+ * though all the items are still attempted so that every error is reported.
+ */
+
+class ParallelFor {
+
+  public:
+    template<class F>
+    static bool run(uint32_t count,uint32_t threads,F func);
+};
+
+
+/*
+ * Run the items
+ */
+
+template<class F>
+inline bool ParallelFor::run(uint32_t count,uint32_t threads,F func) {
+
+  std::atomic<uint32_t> next(0);
+  std::atomic<bool> ok(true);
+  std::vector<std::thread> workers;
+  uint32_t i;
+
+  auto worker=[&]() {
+
+    uint32_t index;
+
+    while((index=next++)<count)
+      if(!func(index))
+        ok=false;
+  };
+
+  threads=std::max(1u,std::min(threads,count));
+
+  for(i=1;i<threads;i++)
+    workers.emplace_back(worker);
+
+  worker();
+
+  for(auto& t : workers)
+    t.join();
+
+  return ok;
+}
@@ -0,0 +1,41 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "AssetCompiler.h"
+
+#include <png.h>
+
+
+/*
+ * Decode the image. libpng's simplified API does the format conversion.
+ */
+
+bool PngReader::decode(const std::string& png,Image& image,std::string& error) {
+
+  png_image pi;
+
+  memset(&pi,0,sizeof(pi));
+  pi.version=PNG_IMAGE_VERSION;
+
+  if(!png_image_begin_read_from_memory(&pi,png.data(),png.size())) {
+    error=pi.message;
+    return false;
+  }
+
+  pi.format=PNG_FORMAT_RGBA;
+
+  image.Width=pi.width;
+  image.Height=pi.height;
+  image.Rgba.resize(PNG_IMAGE_SIZE(pi));
+
+  if(!png_image_finish_read(&pi,nullptr,image.Rgba.data(),0,nullptr)) {
+    error=pi.message;
+    png_image_free(&pi);
+    return false;
+  }
+
+  return true;
+}
@@ -0,0 +1,50 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Decode a PNG held in memory into RGBA bytes with libpng. Any bit depth, palette or grey
+ * image is expanded to 8-bit RGBA.
+ */
+
+class PngReader {
+
+  public:
+    struct Image {
+      uint32_t Width;
+      uint32_t Height;
+      std::vector<uint8_t> Rgba;
+
+      Frame crop(uint32_t x,uint32_t y,uint32_t width,uint32_t height) const;
+    };
+
+  public:
+    static bool decode(const std::string& png,Image& image,std::string& error);
+};
+
+
+/*
+ * Convert an area of the image to a frame
+ */
+
+inline Frame PngReader::Image::crop(uint32_t x,uint32_t y,uint32_t width,uint32_t height) const {
+
+  Frame frame(width,height);
+  uint32_t row,col;
+  const uint8_t *src;
+
+  for(row=0;row<height;row++) {
+
+    src=&Rgba[((y+row)*Width+x)*4];
+
+    for(col=0;col<width;col++,src+=4)
+      frame.Words[row*width+col]=Frame::fromRgb(src[0],src[1],src[2]);
+  }
+
+  return frame;
+}
@@ -0,0 +1,88 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Encode a frame as rows of span headers, each followed by its run of opaque pixels. A header
+ * is [15] last run in the row, [14..8] pixels to skip, [7..0] run length. A skip or a run that
+ * doesn't fit in its field is split. A row with nothing in it is one empty header. The sprite
+ * writer moves on to the next row after the run marked last.
+ */
+
+class SpanEncoder {
+
+  public:
+    enum {
+      MAX_SKIP = 127,
+      MAX_LENGTH = 255,
+      LAST = 0x8000
+    };
+
+  public:
+    static std::vector<uint16_t> encode(const Frame& frame);
+};
+
+
+/*
+ * Encode the frame
+ */
+
+inline std::vector<uint16_t> SpanEncoder::encode(const Frame& frame) {
+
+  std::vector<std::pair<uint16_t,uint16_t>> runs;
+  std::vector<uint16_t> words;
+  uint16_t x,y,start,pos,skip,length,part;
+  const uint16_t *row;
+
+  for(y=0;y<frame.Height;y++) {
+
+    row=&frame.Words[y*frame.Width];
+    runs.clear();
+
+    for(x=0;x<frame.Width;x++) {
+
+      if(row[x]==Frame::TRANSPARENT)
+        continue;
+
+      for(start=x;x<frame.Width && row[x]!=Frame::TRANSPARENT;x++);
+      runs.push_back(std::make_pair(start,x-start));
+    }
+
+    if(runs.empty()) {
+      words.push_back(LAST);
+      continue;
+    }
+
+    pos=0;
+
+    for(size_t i=0;i<runs.size();i++) {
+
+      start=runs[i].first;
+      length=runs[i].second;
+
+      for(skip=start-pos;skip>MAX_SKIP;skip-=MAX_SKIP)
+        words.push_back(MAX_SKIP << 8);
+
+      while(length>0) {
+
+        part=std::min<uint16_t>(length,MAX_LENGTH);
+
+        words.push_back((i==runs.size()-1 && part==length ? LAST : 0) | (skip << 8) | part);
+        words.insert(words.end(),row+start,row+start+part);
+
+        start+=part;
+        length-=part;
+        skip=0;
+      }
+
+      pos=start;
+    }
+  }
+
+  return words;
+}
@@ -0,0 +1,182 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "AssetCompiler.h"
+
+#include <expat.h>
+
+
+/*
+ * Expat callback state. It collects the attributes of the elements that matter from both the
+ * map and the tileset, which never have the same elements at the same depth.
+ */
+
+struct TiledMap::Parser {
+
+  std::vector<std::string> Path;            // element names from the root
+  std::map<std::string,std::string> Map;
+  std::map<std::string,std::string> Tileset;
+  std::map<std::string,std::string> Image;
+  std::vector<uint32_t> Gids;
+  bool InBackground;
+  bool BadEncoding;
+
+  Parser()
+    : InBackground(false),
+      BadEncoding(false) {
+  }
+
+  static void attributes(const XML_Char **attr,std::map<std::string,std::string>& values) {
+    for(;*attr;attr+=2)
+      values[attr[0]]=attr[1];
+  }
+
+  static std::string find(const XML_Char **attr,const char *name) {
+    for(;*attr;attr+=2)
+      if(!strcmp(attr[0],name))
+        return attr[1];
+    return "";
+  }
+
+  static void XMLCALL start(void *data,const XML_Char *name,const XML_Char **attr) {
+
+    Parser& p(*static_cast<Parser *>(data));
+    std::string parent(p.Path.empty() ? "" : p.Path.back());
+
+    p.Path.push_back(name);
+
+    if(p.Path.size()==1 && !strcmp(name,"map"))
+      attributes(attr,p.Map);
+    else if(p.Path.size()==1 && !strcmp(name,"tileset"))
+      attributes(attr,p.Tileset);
+    else if(p.Path.size()==2 && parent=="map" && !strcmp(name,"tileset") && p.Tileset.empty())
+      attributes(attr,p.Tileset);
+    else if(p.Path.size()==2 && parent=="tileset" && !strcmp(name,"image"))
+      attributes(attr,p.Image);
+    else if(p.Path.size()==2 && parent=="map" && !strcmp(name,"layer"))
+      p.InBackground=find(attr,"name")=="background";
+    else if(p.Path.size()==3 && p.InBackground && !strcmp(name,"data"))
+      p.BadEncoding=!find(attr,"encoding").empty();
+    else if(p.Path.size()==4 && p.InBackground && !strcmp(name,"tile"))
+      p.Gids.push_back(strtoul(find(attr,"gid").c_str(),nullptr,10));
+  }
+
+  static void XMLCALL end(void *data,const XML_Char * /* name */) {
+
+    Parser& p(*static_cast<Parser *>(data));
+
+    if(p.Path.size()==2)
+      p.InBackground=false;
+
+    p.Path.pop_back();
+  }
+};
+
+
+/*
+ * Parse an XML file
+ */
+
+bool TiledMap::parseFile(const std::string& filename,Parser& parser,std::string& error) {
+
+  std::string content;
+  XML_Parser xp;
+  bool ok;
+
+  if(!FileUtil::readFile(filename,content)) {
+    error="cannot read "+filename;
+    return false;
+  }
+
+  xp=XML_ParserCreate(nullptr);
+
+  XML_SetUserData(xp,&parser);
+  XML_SetElementHandler(xp,Parser::start,Parser::end);
+
+  if(!(ok=XML_Parse(xp,content.data(),content.size(),1)!=XML_STATUS_ERROR))
+    error=filename+":"+std::to_string(XML_GetCurrentLineNumber(xp))+": "+XML_ErrorString(XML_GetErrorCode(xp));
+
+  XML_ParserFree(xp);
+  return ok;
+}
+
+
+/*
+ * Read the map and its tileset. Relative paths in the files are relative to the file that
+ * names them.
+ */
+
+bool TiledMap::read(const std::string& filename,std::string& error) {
+
+  Parser mapParser,tilesetParser;
+  std::string tsx,dir;
+  uint32_t tileHeight;
+
+  if(!parseFile(filename,mapParser,error))
+    return false;
+
+  Name=FileUtil::baseName(filename);
+  dir=FileUtil::directoryOf(filename);
+
+  Width=strtoul(mapParser.Map["width"].c_str(),nullptr,10);
+  Height=strtoul(mapParser.Map["height"].c_str(),nullptr,10);
+  TileSize=strtoul(mapParser.Map["tilewidth"].c_str(),nullptr,10);
+  tileHeight=strtoul(mapParser.Map["tileheight"].c_str(),nullptr,10);
+  FirstGid=strtoul(mapParser.Tileset["firstgid"].c_str(),nullptr,10);
+  Gids.swap(mapParser.Gids);
+
+  if(!Width || !Height || !TileSize || TileSize!=tileHeight) {
+    error=filename+": the map must have a size and square tiles";
+    return false;
+  }
+
+  if(mapParser.BadEncoding) {
+    error=filename+": the background layer must be saved in XML format";
+    return false;
+  }
+
+  if(Gids.size()!=Width*Height) {
+    error=filename+": the background layer has "+std::to_string(Gids.size())+" tiles, expected "+std::to_string(Width*Height);
+    return false;
+  }
+
+  // the tileset is usually external
+
+  if((tsx=mapParser.Tileset["source"]).empty())
+    tilesetParser=mapParser;
+  else {
+    tsx=tsx[0]=='/' ? tsx : FileUtil::join(dir,tsx);
+
+    if(!parseFile(tsx,tilesetParser,error))
+      return false;
+  }
+
+  if(strtoul(tilesetParser.Tileset["tilewidth"].c_str(),nullptr,10)!=TileSize ||
+     strtoul(tilesetParser.Tileset["tileheight"].c_str(),nullptr,10)!=TileSize) {
+    error=filename+": the tileset's tiles are not the same size as the map's";
+    return false;
+  }
+
+  ImageFile=tilesetParser.Image["source"];
+  ImageWidth=strtoul(tilesetParser.Image["width"].c_str(),nullptr,10);
+
+  if(ImageFile.empty() || ImageWidth<TileSize) {
+    error=filename+": the tileset has no image";
+    return false;
+  }
+
+  if(ImageFile[0]!='/')
+    ImageFile=FileUtil::join(FileUtil::directoryOf(tsx.empty() ? filename : tsx),ImageFile);
+
+  for(uint32_t gid : Gids) {
+    if(gid<FirstGid) {
+      error=filename+": the background layer has an empty tile";
+      return false;
+    }
+  }
+
+  return true;
+}
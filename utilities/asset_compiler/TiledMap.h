@@ -0,0 +1,49 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * The parts of a Tiled map and its external tileset that the level needs: the gids of the
+ * layer called "background" in XML encoding and the tileset image. The map is read with
+ * expat. The tiles must be square and the same size in the map and the tileset. Tiles are
+ * found in the image using the width declared in the tileset. The declared height isn't used
+ * because Tiled doesn't always update it when the image grows.
+ */
+
+class TiledMap {
+
+  public:
+    std::string Name;                   // the map file name without its extension
+    uint32_t Width;                     // in tiles
+    uint32_t Height;
+    uint32_t TileSize;                  // in pixels
+    uint32_t FirstGid;
+    std::vector<uint32_t> Gids;         // row by row from the top left
+
+    std::string ImageFile;              // the tileset image, relative to the working directory
+    uint32_t ImageWidth;                // as declared in the tileset
+
+  protected:
+    struct Parser;
+
+    static bool parseFile(const std::string& filename,Parser& parser,std::string& error);
+
+  public:
+    bool read(const std::string& filename,std::string& error);
+
+    uint32_t getTilesPerRow() const;
+};
+
+
+/*
+ * Get the number of tiles across the tileset image
+ */
+
+inline uint32_t TiledMap::getTilesPerRow() const {
+  return ImageWidth/TileSize;
+}
@@ -0,0 +1,793 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "AssetCompiler.h"
+
+#include <chrono>
+#include <regex>
+#include <unordered_map>
+
+
+/**
+ * The asset compiler converts a game's graphics into the SPI flash image files and the
+ * tables that the firmware is built with. It replaces convert.pl, convert.sh, the C# cropper
+ * and bm2rgbi.exe and its output is byte for byte the same as theirs.
+ *
+ *   1. The background layer of a Tiled map is cut into tiles. Each different tile is turned
+ *      to the panel's orientation and gets a sprite number in the order that it's first seen
+ *      going down the columns from the right. Writes <map>_Tiles.cpp and BackgroundSprites.*.
+ *   2. The character frames are NNN_name.png in name order. A frame that's the same as one
+ *      before it, or that one mirrored, shares its flash. Frames whose names match the indexed
+ *      pattern are stored as one byte per pixel with a shared median cut palette and the rest
+ *      are span encoded if that's smaller. Writes PathSprites.* and PathPalette.*.
+ *   3. Plain images are stored as they are, as in the sprites demo.
+ *
+ * The files go into flash in that order, each on the next 256 byte page boundary, and
+ * <spiflash>/index.txt lists them for the flash programmer and the emulator. Pixels are
+ * converted to R61523 5-6-5. Alpha is ignored so transparent pixels must be magenta.
+ *
+ * Decoding the PNGs is the slow part, so it's done on all the cores and each converted frame
+ * is kept in a cache named by the hash of its source. A run where nothing has changed only
+ * reads the sources to hash them, and a file is only written if its content has changed.
+ *
+ * Usage: asset_compiler [-t tmx-file] [-c characters-dir] [-i images-dir] [-o spiflash-dir]
+ *                       [-s sources-dir] [-x indexed-pattern] [-C cache-dir] [-j threads] [-f]
+ *
+ *   -t  convert the background layer of a Tiled map
+ *   -c  convert the character frames in a directory
+ *   -i  convert the plain images in a directory
+ *   -o  where the .bin files and index.txt go (default spiflash). Other .bin files there
+ *       are deleted.
+ *   -s  where the generated C++ sources go (default .)
+ *   -x  the regular expression for indexed frame names (default ^\d+_(moving_platform|saw_\d+)$)
+ *   -C  the cache directory (default .asset_cache)
+ *   -j  the number of threads (default: all the cores)
+ *   -f  convert everything again without looking in the cache
+ */
+
+class AssetCompilerRun {
+
+  protected:
+
+    enum {
+      PAGE_SIZE = 256,
+      PALETTE_SIZE = 256,
+      FIRST_CHARACTER = 100           // character NNN has the enum value NNN-100
+    };
+
+    struct Options {
+      const char *TmxFile;
+      const char *CharacterDir;
+      const char *ImageDir;
+      const char *OutputDir;
+      const char *SourceDir;
+      const char *IndexedPattern;
+      const char *CacheDir;
+      uint32_t Threads;
+      bool Force;
+    };
+
+    /*
+     * A picture on its way to flash
+     */
+
+    struct Item {
+      std::string Name;
+      std::string SourceFile;
+      uint32_t X;                     // background tiles only: where it is in the sheet
+      uint32_t Y;
+      Frame Converted;
+      std::string Error;
+    };
+
+    /*
+     * A file to write to flash
+     */
+
+    struct Output {
+      std::string Name;
+      std::string Content;
+    };
+
+    Options _options;
+    FrameCache _cache;
+    std::string _index;
+    std::vector<Output> _outputs;
+    uint32_t _offset;
+    uint32_t _written;
+    uint32_t _unchanged;
+
+  protected:
+    void usage() const;
+    bool parseOptions(int argc,char *argv[]);
+
+    bool convert(std::vector<Item>& items,const ContentHash& base,PngReader::Image *sheet,uint32_t tileSize);
+    void addToFlash(const std::string& name,const std::string& content,uint32_t size);
+
+    bool compileTiles();
+    bool compileCharacters();
+    bool compileImages();
+
+    bool writeSource(const std::string& name,const std::string& content);
+    bool writeFlash();
+
+    static std::string header();
+
+  public:
+    AssetCompilerRun();
+    int run(int argc,char *argv[]);
+};
+
+
+/*
+ * Constructor
+ */
+
+AssetCompilerRun::AssetCompilerRun()
+  : _offset(0),
+    _written(0),
+    _unchanged(0) {
+
+  _options.TmxFile=nullptr;
+  _options.CharacterDir=nullptr;
+  _options.ImageDir=nullptr;
+  _options.OutputDir="spiflash";
+  _options.SourceDir=".";
+  _options.IndexedPattern="^\\d+_(moving_platform|saw_\\d+)$";
+  _options.CacheDir=".asset_cache";
+  _options.Threads=std::max(1u,std::thread::hardware_concurrency());
+  _options.Force=false;
+}
+
+
+/*
+ * Show the usage text
+ */
+
+void AssetCompilerRun::usage() const {
+  fputs("usage: asset_compiler [-t tmx-file] [-c characters-dir] [-i images-dir] [-o spiflash-dir]\n"
+        "                      [-s sources-dir] [-x indexed-pattern] [-C cache-dir] [-j threads] [-f]\n",stderr);
+}
+
+
+/*
+ * Parse the command line
+ */
+
+bool AssetCompilerRun::parseOptions(int argc,char *argv[]) {
+
+  int opt;
+
+  while((opt=getopt(argc,argv,"t:c:i:o:s:x:C:j:f"))!=-1) {
+
+    switch(opt) {
+
+      case 't':
+        _options.TmxFile=optarg;
+        break;
+
+      case 'c':
+        _options.CharacterDir=optarg;
+        break;
+
+      case 'i':
+        _options.ImageDir=optarg;
+        break;
+
+      case 'o':
+        _options.OutputDir=optarg;
+        break;
+
+      case 's':
+        _options.SourceDir=optarg;
+        break;
+
+      case 'x':
+        _options.IndexedPattern=optarg;
+        break;
+
+      case 'C':
+        _options.CacheDir=optarg;
+        break;
+
+      case 'j':
+        _options.Threads=std::max(1ul,strtoul(optarg,nullptr,10));
+        break;
+
+      case 'f':
+        _options.Force=true;
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  return optind==argc && (_options.TmxFile || _options.CharacterDir || _options.ImageDir);
+}
+
+
+/*
+ * Convert a set of pictures in parallel, from the cache where possible. If there's a sheet
+ * then each item is a tile cut from it and the sheet is only decoded if a tile isn't cached.
+ */
+
+bool AssetCompilerRun::convert(std::vector<Item>& items,const ContentHash& base,PngReader::Image *sheet,uint32_t tileSize) {
+
+  std::mutex sheetMutex;
+  bool sheetDecoded,sheetOk;
+
+  sheetDecoded=false;
+  sheetOk=false;
+
+  bool ok=ParallelFor::run(items.size(),_options.Threads,[&](uint32_t i) {
+
+    Item& item(items[i]);
+    ContentHash key(base);
+    std::string png;
+
+    if(sheet) {
+
+      key.add(item.X).add(item.Y);
+
+      if(_cache.load(key,item.Converted))
+        return true;
+
+      {
+        std::lock_guard<std::mutex> lock(sheetMutex);
+
+        if(!sheetDecoded) {
+
+          sheetDecoded=true;
+
+          if(!FileUtil::readFile(item.SourceFile,png))
+            item.Error="cannot read "+item.SourceFile;
+          else if(!PngReader::decode(png,*sheet,item.Error))
+            item.Error=item.SourceFile+": "+item.Error;
+          else
+            sheetOk=true;
+        }
+      }
+
+      // only the item that tried to decode the sheet reports it
+
+      if(!sheetOk)
+        return false;
+
+      if(item.X+tileSize>sheet->Width || item.Y+tileSize>sheet->Height) {
+        item.Error=item.SourceFile+" has no tile "+item.Name.substr(item.Name.find("_tile")+5);
+        return false;
+      }
+
+      item.Converted=sheet->crop(item.X,item.Y,tileSize,tileSize).rotatedLeft();
+    }
+    else {
+
+      PngReader::Image image;
+
+      if(!FileUtil::readFile(item.SourceFile,png)) {
+        item.Error="cannot read "+item.SourceFile;
+        return false;
+      }
+
+      key.add(png);
+
+      if(_cache.load(key,item.Converted))
+        return true;
+
+      if(!PngReader::decode(png,image,item.Error)) {
+        item.Error=item.SourceFile+": "+item.Error;
+        return false;
+      }
+
+      if(image.Width>0xffff || image.Height>0xffff) {
+        item.Error=item.SourceFile+" is too big";
+        return false;
+      }
+
+      item.Converted=image.crop(0,0,image.Width,image.Height);
+    }
+
+    if(!_cache.store(key,item.Converted))
+      fprintf(stderr,"Cannot write to the cache in %s\n",_options.CacheDir);
+
+    return true;
+  });
+
+  for(const Item& item : items)
+    if(!item.Error.empty())
+      fprintf(stderr,"%s\n",item.Error.c_str());
+
+  return ok;
+}
+
+
+/*
+ * Give a file the next flash address and add it to the index. The next file starts on the
+ * page after this one ends, which is a whole page on if this one fills its last page.
+ */
+
+void AssetCompilerRun::addToFlash(const std::string& name,const std::string& content,uint32_t size) {
+
+  Output output;
+
+  output.Name=name+".bin";
+  output.Content=content;
+  _outputs.push_back(output);
+
+  _index+=FileUtil::join(_options.OutputDir,output.Name)+"="+std::to_string(_offset)+"\n";
+  _offset=((_offset+size)/PAGE_SIZE+1)*PAGE_SIZE;
+}
+
+
+/*
+ * Cut the background layer of the map into tiles
+ */
+
+bool AssetCompilerRun::compileTiles() {
+
+  TiledMap map;
+  PngReader::Image sheet;
+  std::vector<Item> items;
+  std::map<uint32_t,uint32_t> seen;
+  std::string error,png,level,sprites,arrayName;
+  uint32_t i,x,y,tile,count;
+  char buffer[16];
+
+  if(!map.read(_options.TmxFile,error)) {
+    fprintf(stderr,"%s\n",error.c_str());
+    return false;
+  }
+
+  // the level goes down each column of the map from the right hand side
+
+  arrayName=map.Name;
+  arrayName[0]=toupper(arrayName[0]);
+  arrayName+="_Tiles";
+
+  level="/*\n\n"+header().substr(4)+"#include \"Application.h\"\n\n\n"
+        "/*\n * Level world definition\n */\n\n"
+        "extern const uint16_t "+arrayName+"[] = {\n  ";
+
+  count=map.Width*map.Height;
+  i=0;
+
+  for(x=map.Width;x-->0;) {
+    for(y=0;y<map.Height;y++) {
+
+      tile=map.Gids[y*map.Width+x]-map.FirstGid;
+
+      if(seen.find(tile)==seen.end()) {
+
+        Item item;
+
+        snprintf(buffer,sizeof(buffer),"%03u",static_cast<uint32_t>(items.size()));
+
+        item.Name=std::string(buffer)+"_tile"+std::to_string(tile);
+        item.SourceFile=map.ImageFile;
+        item.X=(tile % map.getTilesPerRow())*map.TileSize;
+        item.Y=(tile/map.getTilesPerRow())*map.TileSize;
+
+        seen[tile]=items.size();
+        items.push_back(item);
+      }
+
+      snprintf(buffer,sizeof(buffer),"%3u",seen[tile]);
+      level+=buffer;
+
+      if(++i!=count)
+        level+=",";
+    }
+
+    level+="\n  ";
+  }
+
+  level+="};\n";
+
+  // convert the tiles
+
+  if(!FileUtil::readFile(map.ImageFile,png)) {
+    fprintf(stderr,"Cannot read %s\n",map.ImageFile.c_str());
+    return false;
+  }
+
+  if(!convert(items,ContentHash().add(FrameCache::VERSION).add("tile").add(png).add(map.TileSize),&sheet,map.TileSize))
+    return false;
+
+  sprites=header()+"#include \"Application.h\"\n\n"
+          "/*\n * All sprites in this world\n */\n\n"
+          "  const BackgroundSpriteDef BackgroundSprites[]={\n";
+
+  for(i=0;i<items.size();i++) {
+    sprites+="  { "+std::to_string(i)+", "+std::to_string(_offset)+" },\n";
+    addToFlash(items[i].Name,items[i].Converted.toBytes(),items[i].Converted.Words.size()*2);
+  }
+
+  sprites+="};\n\n";
+
+  printf("%u tiles in a %ux%u map use %u different tiles\n",count,map.Width,map.Height,static_cast<uint32_t>(items.size()));
+
+  return writeSource(arrayName+".cpp",level) &&
+         writeSource("BackgroundSprites.cpp",sprites) &&
+         writeSource("BackgroundSprites.h",
+                     header()+"#pragma once\n\n\n"
+                     "extern const BackgroundSpriteDef BackgroundSprites[];\n"
+                     "enum { BACKGROUND_SPRITES_COUNT="+std::to_string(items.size())+" };\n\n");
+}
+
+
+/*
+ * Convert the character frames
+ */
+
+bool AssetCompilerRun::compileCharacters() {
+
+  std::vector<std::string> names;
+  std::vector<Item> items;
+  std::unordered_map<std::string,uint32_t> frames;
+  std::map<uint32_t,std::string> flags;
+  std::vector<size_t> indexedFrames;
+  std::vector<uint16_t> colours,palette;
+  std::map<uint16_t,uint16_t> mapping;
+  std::string sprites,ids,text;
+  std::smatch match;
+  uint32_t shared,saved,indexedSaved,spanCount,spanSaved,i,offset;
+  char buffer[16];
+
+  std::regex numbered("^(\\d+)_(.*)$");
+  std::regex indexed;
+
+  try {
+    indexed=std::regex(_options.IndexedPattern);
+  }
+  catch(const std::regex_error&) {
+    fprintf(stderr,"Bad indexed pattern: %s\n",_options.IndexedPattern);
+    return false;
+  }
+
+  if(!FileUtil::listFiles(_options.CharacterDir,".png",names)) {
+    fprintf(stderr,"Cannot read %s\n",_options.CharacterDir);
+    return false;
+  }
+
+  for(const std::string& name : names) {
+
+    Item item;
+
+    if(!std::regex_match(name,numbered)) {
+      fprintf(stderr,"%s.png: character frames must be named NNN_name\n",name.c_str());
+      return false;
+    }
+
+    item.Name=name;
+    item.SourceFile=FileUtil::join(_options.CharacterDir,name+".png");
+    items.push_back(item);
+  }
+
+  if(!convert(items,ContentHash().add(FrameCache::VERSION).add("frame"),nullptr,0))
+    return false;
+
+  sprites=header()+"#include \"Application.h\"\n\n\n"
+          "const PathSpriteDef PathSprites[]={\n";
+
+  shared=saved=indexedSaved=spanCount=spanSaved=0;
+
+  for(i=0;i<items.size();i++) {
+
+    const Item& item(items[i]);
+    const Frame& frame(item.Converted);
+    std::string data,mirrored,prefix;
+
+    std::regex_match(item.Name,match,numbered);
+
+    text=match[2];
+    std::transform(text.begin(),text.end(),text.begin(),::toupper);
+    ids+="  "+text+" = "+std::to_string(strtol(match[1].str().c_str(),nullptr,10)-FIRST_CHARACTER)+",\n";
+
+    // a frame that's the same as one already converted, or that one with its rows in reverse
+    // order, uses its flash. The panel is rotated so reversed rows are a left-right flip to the player.
+
+    prefix=std::to_string(frame.Width)+":";
+    data=prefix+frame.toBytes();
+    mirrored=prefix+frame.mirrored().toBytes();
+
+    auto it=frames.find(data);
+    uint32_t mirror=0;
+
+    if(it==frames.end()) {
+      it=frames.find(mirrored);
+      mirror=1;
+    }
+
+    if(it!=frames.end()) {
+
+      sprites+="  { "+std::to_string(it->second)+", "+std::to_string(frame.Width)+", "+std::to_string(frame.Height)+", "+
+               std::to_string(mirror)+", "+flags[it->second]+" },    // "+item.Name+" \n";
+
+      saved+=frame.Words.size()*2;
+      shared++;
+      continue;
+    }
+
+    frames[data]=offset=_offset;
+
+    if(std::regex_search(item.Name,indexed)) {
+
+      // an indexed frame is half the size. It's written out when the palette is known.
+
+      colours.insert(colours.end(),frame.Words.begin(),frame.Words.end());
+      indexedFrames.push_back(_outputs.size());
+      indexedSaved+=frame.Words.size();
+
+      flags[offset]="1, 0, 0";
+      addToFlash(item.Name,data.substr(prefix.size()),frame.Words.size());
+    }
+    else {
+
+      // the span stream replaces the plain frame if it's shorter
+
+      std::vector<uint16_t> spans(SpanEncoder::encode(frame));
+
+      if(spans.size()<frame.Words.size()) {
+        flags[offset]="0, 1, "+std::to_string(spans.size());
+        spanSaved+=(frame.Words.size()-spans.size())*2;
+        spanCount++;
+        addToFlash(item.Name,Frame::toBytes(spans),spans.size()*2);
+      }
+      else {
+        flags[offset]="0, 0, 0";
+        addToFlash(item.Name,data.substr(prefix.size()),frame.Words.size()*2);
+      }
+    }
+
+    sprites+="  { "+std::to_string(offset)+", "+std::to_string(frame.Width)+", "+std::to_string(frame.Height)+", 0, "+
+             flags[offset]+" },    // "+item.Name+" \n";
+  }
+
+  sprites+="};\n";
+
+  // build the palette for the indexed frames. The transparent colour always has its own
+  // entry so it's never merged.
+
+  std::sort(colours.begin(),colours.end());
+  colours.erase(std::unique(colours.begin(),colours.end()),colours.end());
+  colours.erase(std::remove(colours.begin(),colours.end(),static_cast<uint16_t>(Frame::TRANSPARENT)),colours.end());
+
+  MedianCut::quantise(colours,PALETTE_SIZE-1,palette,mapping);
+  palette.insert(palette.begin(),Frame::TRANSPARENT);
+
+  for(size_t index : indexedFrames) {
+
+    std::string& content(_outputs[index].Content);
+
+    for(i=0;i<content.size()/2;i++) {
+
+      uint16_t word=(static_cast<uint8_t>(content[i*2]) << 8) | static_cast<uint8_t>(content[i*2+1]);
+      content[i]=static_cast<char>(word==Frame::TRANSPARENT ? 0 : mapping[word]+1);
+    }
+
+    content.resize(content.size()/2);
+  }
+
+  text=header()+"#include \"Application.h\"\n\n\n"
+       "const uint16_t PathPalette[]={\n";
+
+  for(i=0;i<palette.size();i+=8) {
+
+    text+="  ";
+
+    for(size_t j=i;j<palette.size() && j<i+8;j++) {
+      snprintf(buffer,sizeof(buffer),j==i ? "0x%04x" : ",0x%04x",palette[j]);
+      text+=buffer;
+    }
+
+    text+=",\n";
+  }
+
+  text+="};\n";
+
+  printf("%u frames share flash with another, %u bytes saved\n",shared,saved);
+  printf("%u frames are indexed, %u bytes saved\n",static_cast<uint32_t>(indexedFrames.size()),indexedSaved);
+  printf("%u palette colours for %u distinct\n",static_cast<uint32_t>(palette.size()),static_cast<uint32_t>(colours.size()+1));
+  printf("%u frames are span encoded, %u bytes saved\n",spanCount,spanSaved);
+
+  return writeSource("PathPalette.cpp",text) &&
+         writeSource("PathPalette.h",
+                     header()+"#pragma once\n\n\n"
+                     "extern const uint16_t PathPalette[];\n"
+                     "enum { PATH_PALETTE_COUNT="+std::to_string(palette.size())+" };\n\n") &&
+         writeSource("PathSprites.cpp",sprites) &&
+         writeSource("PathSprites.h",
+                     header()+"#pragma once\n\n\n"
+                     "extern const PathSpriteDef PathSprites[];\n\n"
+                     "enum {\n"
+                     "  PATH_SPRITES_COUNT="+std::to_string(items.size())+",\n\n"+
+                     ids+"};\n");
+}
+
+
+/*
+ * Convert the plain images
+ */
+
+bool AssetCompilerRun::compileImages() {
+
+  std::vector<std::string> names;
+  std::vector<Item> items;
+
+  if(!FileUtil::listFiles(_options.ImageDir,".png",names)) {
+    fprintf(stderr,"Cannot read %s\n",_options.ImageDir);
+    return false;
+  }
+
+  for(const std::string& name : names) {
+
+    Item item;
+
+    item.Name=name;
+    item.SourceFile=FileUtil::join(_options.ImageDir,name+".png");
+    items.push_back(item);
+  }
+
+  if(!convert(items,ContentHash().add(FrameCache::VERSION).add("frame"),nullptr,0))
+    return false;
+
+  for(const Item& item : items)
+    addToFlash(item.Name,item.Converted.toBytes(),item.Converted.Words.size()*2);
+
+  printf("%u images\n",static_cast<uint32_t>(items.size()));
+  return true;
+}
+
+
+/*
+ * Get the comment that starts each generated source file
+ */
+
+std::string AssetCompilerRun::header() {
+  return "\n"
+         "/*\n"
+         " * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)\n"
+         " * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>\n"
+         " * Please see website for licensing terms.\n"
+         " */\n"
+         "\n";
+}
+
+
+/*
+ * Write a generated source file if it has changed
+ */
+
+bool AssetCompilerRun::writeSource(const std::string& name,const std::string& content) {
+
+  std::string filename(FileUtil::join(_options.SourceDir,name));
+
+  switch(FileUtil::updateFile(filename,content)) {
+
+    case FileUtil::WRITTEN:
+      _written++;
+      return true;
+
+    case FileUtil::UNCHANGED:
+      _unchanged++;
+      return true;
+
+    default:
+      fprintf(stderr,"Cannot write %s\n",filename.c_str());
+      return false;
+  }
+}
+
+
+/*
+ * Write the flash files that have changed and the index, and delete the .bin files that
+ * are no longer used
+ */
+
+bool AssetCompilerRun::writeFlash() {
+
+  std::vector<std::string> existing;
+  std::vector<FileUtil::WriteResult> results(_outputs.size());
+  std::string filename;
+  bool ok;
+
+  if(!FileUtil::makeDirectory(_options.OutputDir)) {
+    fprintf(stderr,"Cannot create %s\n",_options.OutputDir);
+    return false;
+  }
+
+  ParallelFor::run(_outputs.size(),_options.Threads,[&](uint32_t i) {
+    results[i]=FileUtil::updateFile(FileUtil::join(_options.OutputDir,_outputs[i].Name),_outputs[i].Content);
+    return results[i]!=FileUtil::FAILED;
+  });
+
+  ok=true;
+
+  for(size_t i=0;i<_outputs.size();i++) {
+
+    if(results[i]==FileUtil::WRITTEN)
+      _written++;
+    else if(results[i]==FileUtil::UNCHANGED)
+      _unchanged++;
+    else {
+      fprintf(stderr,"Cannot write %s\n",FileUtil::join(_options.OutputDir,_outputs[i].Name).c_str());
+      ok=false;
+    }
+  }
+
+  FileUtil::listFiles(_options.OutputDir,".bin",existing);
+
+  for(const std::string& name : existing) {
+
+    auto used=std::find_if(_outputs.begin(),_outputs.end(),[&name](const Output& output) {
+      return output.Name==name+".bin";
+    });
+
+    if(used==_outputs.end()) {
+      filename=FileUtil::join(_options.OutputDir,name+".bin");
+      printf("deleting %s\n",filename.c_str());
+      unlink(filename.c_str());
+    }
+  }
+
+  filename=FileUtil::join(_options.OutputDir,"index.txt");
+
+  if(FileUtil::updateFile(filename,_index)==FileUtil::FAILED) {
+    fprintf(stderr,"Cannot write %s\n",filename.c_str());
+    return false;
+  }
+
+  return ok;
+}
+
+
+/*
+ * Run the compiler
+ */
+
+int AssetCompilerRun::run(int argc,char *argv[]) {
+
+  auto start=std::chrono::steady_clock::now();
+
+  if(!parseOptions(argc,argv)) {
+    usage();
+    return 1;
+  }
+
+  if(!_cache.open(_options.CacheDir,!_options.Force)) {
+    fprintf(stderr,"Cannot create %s\n",_options.CacheDir);
+    return 1;
+  }
+
+  if((_options.TmxFile && !compileTiles()) ||
+     (_options.CharacterDir && !compileCharacters()) ||
+     (_options.ImageDir && !compileImages()) ||
+     !writeFlash())
+    return 1;
+
+  printf("%u bytes of flash in %u files, %u converted, %u from the cache, %u files written, %u unchanged, %.2fs\n",
+      _offset,
+      static_cast<uint32_t>(_outputs.size()),
+      _cache.getMisses(),
+      _cache.getHits(),
+      _written,
+      _unchanged,
+      std::chrono::duration<double>(std::chrono::steady_clock::now()-start).count());
+
+  return 0;
+}
+
+
+/*
+ * Main entry point
+ */
+
+int main(int argc,char *argv[]) {
+
+  AssetCompilerRun compiler;
+  return compiler.run(argc,argv);
+}
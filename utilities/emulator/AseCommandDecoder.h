@@ -0,0 +1,190 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Decoder for the pre-encoded port E streams built by AseCommandEncoder. Every halfword pair
+ * is checked to be a valid WR low / WR high strobe and the 10-bit words are then split back
+ * into sprite mode commands so that the encoder can be verified on the host.
+ */
+
+class AseCommandDecoder {
+
+  public:
+
+    enum Result {
+      OK,
+      BAD_STROBE,           // second half is not the first half with WR set
+      BAD_BITS,             // bits above WR are set
+      UNKNOWN_COMMAND,      // not a sprite mode command
+      TRUNCATED             // the stream ends part way through a command
+    };
+
+    struct Command {
+      uint16_t Code;
+      uint8_t ParamCount;
+      uint16_t Params[16];
+
+      LoadSpriteDef toLoadSpriteDef() const;
+      MoveSpriteDef toMoveSpriteDef() const;
+    };
+
+  public:
+    static Result decode(const uint16_t *encoded,uint32_t numWords,std::vector<Command>& commands,uint32_t& errorWord);
+    static uint8_t getParamCount(uint16_t command);
+    static const char *getResultText(Result result);
+};
+
+
+/*
+ * Get the number of parameters that follow a command, or 0xff if unknown
+ */
+
+inline uint8_t AseCommandDecoder::getParamCount(uint16_t command) {
+
+  switch(command) {
+
+    case AseCommands::CMD_SHOW:
+    case AseCommands::CMD_SHOW_PERSISTENT:
+    case AseCommands::CMD_HIDE:
+    case AseCommands::CMD_LAST_SPRITE:
+      return 1;
+
+    case AseCommands::CMD_LOAD:
+      return 16;
+
+    case AseCommands::CMD_MOVE:
+      return 3;
+
+    case AseCommands::CMD_MOVE_PARTIAL:
+      return 7;
+
+    case AseCommands::CMD_OFFSET:
+      return 2;
+
+    default:
+      return 0xff;
+  }
+}
+
+
+/*
+ * Decode the stream
+ */
+
+inline AseCommandDecoder::Result AseCommandDecoder::decode(const uint16_t *encoded,uint32_t numWords,std::vector<Command>& commands,uint32_t& errorWord) {
+
+  Command cmd;
+  uint8_t expected;
+  uint32_t i;
+
+  expected=0;
+  cmd.ParamCount=0;
+
+  for(i=0;i<numWords;i++,encoded+=2) {
+
+    errorWord=i;
+
+    if((encoded[0] & ~0x3ff) || (encoded[1] & ~0x7ff))
+      return BAD_BITS;
+
+    if(encoded[1]!=(encoded[0] | 0x400))
+      return BAD_STROBE;
+
+    if(expected==0) {
+
+      // a new command
+
+      cmd.Code=encoded[0];
+      cmd.ParamCount=0;
+
+      if((expected=getParamCount(cmd.Code))==0xff)
+        return UNKNOWN_COMMAND;
+    }
+    else {
+
+      cmd.Params[cmd.ParamCount++]=encoded[0];
+
+      if(--expected==0)
+        commands.push_back(cmd);
+    }
+  }
+
+  errorWord=numWords;
+  return expected ? TRUNCATED : OK;
+}
+
+
+/*
+ * Get a description of a result
+ */
+
+inline const char *AseCommandDecoder::getResultText(Result result) {
+
+  switch(result) {
+    case OK: return "ok";
+    case BAD_STROBE: return "bad WR strobe";
+    case BAD_BITS: return "bits set above WR";
+    case UNKNOWN_COMMAND: return "unknown command";
+    case TRUNCATED: return "truncated command";
+    default: return "?";
+  }
+}
+
+
+/*
+ * Convert CMD_LOAD parameters back to the definition
+ */
+
+inline LoadSpriteDef AseCommandDecoder::Command::toLoadSpriteDef() const {
+
+  LoadSpriteDef sd;
+
+  sd.SpriteNumber=Params[0];
+  sd.SramAddress=Params[1] | (Params[2] << 10);
+  sd.PixelWidth=Params[3];
+  sd.NumPixels=Params[4] | (Params[5] << 10);
+  sd.FlashAddress=Params[6] | (Params[7] << 8) | (Params[8] << 16);
+  sd.RepeatX=Params[9];
+  sd.RepeatY=Params[10];
+  sd.Visible=Params[11] & 1;
+  sd.Persistent=(Params[11] >> 1) & 1;
+  sd.Mirror=(Params[11] >> 2) & 1;
+  sd.Indexed=(Params[11] >> 3) & 1;
+  sd.Spans=(Params[11] >> 4) & 1;
+  sd.FirstX=Params[12];
+  sd.LastX=Params[13];
+  sd.FirstY=Params[14];
+  sd.LastY=Params[15];
+
+  return sd;
+}
+
+
+/*
+ * Convert CMD_MOVE / CMD_MOVE_PARTIAL parameters back to the definition
+ */
+
+inline MoveSpriteDef AseCommandDecoder::Command::toMoveSpriteDef() const {
+
+  MoveSpriteDef md;
+
+  md.SpriteNumber=Params[0];
+  md.SramAddress=Params[1] | (Params[2] << 10);
+
+  if(ParamCount==7) {
+    md.FirstX=Params[3];
+    md.LastX=Params[4];
+    md.FirstY=Params[5];
+    md.LastY=Params[6];
+  }
+  else
+    md.FirstX=md.LastX=md.FirstY=md.LastY=0;
+
+  return md;
+}
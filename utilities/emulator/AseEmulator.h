@@ -0,0 +1,221 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Host model of the main/xc3s50 design. The MCU bus feeds mcu_interface, the sprite
+ * writer runs when the frame index rises to 1 and the frame writer copies SRAM to the
+ * LCD when it falls back to 0. The sprite writer drives the BUSY pin (PC14) in the
+ * host GPIO table and raises EXTI line 14 on each edge so that firmware that polls it or
+ * waits for the interrupt sees the right state. The host millisecond timer follows the
+ * emulated clock.
+ */
+
+class AseEmulator : public AseEmulatorBus {
+
+  public:
+    enum {
+      CLOCK_HZ = 100000000,
+      TE_HZ = 61,                             // set by Panel::enableSpriteMode()
+      TE_CYCLES = CLOCK_HZ/TE_HZ,             // cycles between frame index toggles
+      FRAME_CYCLES = TE_CYCLES*2,             // cycles between sprite writer starts
+      BUS_NS_PER_WORD = 40,                   // writeFpgaCommand: 3 x (str,dsb) low then high
+      BUS_CYCLES_PER_WORD = BUS_NS_PER_WORD/10,
+
+      BUSY_PORT = HOST_PORTC,
+      BUSY_PIN = 14
+    };
+
+  protected:
+    FlashModel _flash;
+    SpriteMemory _bram;
+    PaletteMemory _palette;
+    SramModel _sram;
+    McuInterfaceModel _mcuInterface;
+    SpriteWriterModel _spriteWriter;
+    FrameWriterModel _frameWriter;
+    FrameStatistics _stats;
+    uint32_t _frameNumber;
+    uint32_t _encodedWords;
+    uint32_t _streamErrors;
+    uint64_t _cycles;
+
+  protected:
+    void setBusy(bool busy);
+    void advanceTo(uint64_t cycles);
+
+  public:
+    AseEmulator();
+
+    bool loadFlash(const std::string& indexFile);
+
+    void beginBusyPeriod();
+    const SpriteWriterModel::Statistics& endBusyPeriod();
+    const FrameStatistics& endFrame();
+
+    // AseEmulatorBus implementation
+
+    virtual void writeBus(uint16_t value) override;
+    virtual void writeEncodedBus(const uint16_t *encoded,uint32_t numWords) override;
+
+    const McuInterfaceModel& getMcuInterface() const;
+    const SpriteMemory& getSpriteMemory() const;
+    const FrameWriterModel& getFrameWriter() const;
+    const FlashModel& getFlash() const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline AseEmulator::AseEmulator()
+  : _mcuInterface(_bram,_palette),
+    _spriteWriter(_bram,_palette,_flash,_sram),
+    _frameWriter(_sram),
+    _stats(),
+    _frameNumber(0),
+    _encodedWords(0),
+    _streamErrors(0),
+    _cycles(0) {
+}
+
+
+/*
+ * Program the flash from an index file
+ */
+
+inline bool AseEmulator::loadFlash(const std::string& indexFile) {
+  return _flash.loadIndex(indexFile);
+}
+
+
+/*
+ * Receive a word from the MCU
+ */
+
+inline void AseEmulator::writeBus(uint16_t value) {
+  _mcuInterface.write(value);
+}
+
+
+/*
+ * Receive a pre-encoded burst from the MCU. The stream is validated with the decoder
+ * before the words are passed to the MCU interface.
+ */
+
+inline void AseEmulator::writeEncodedBus(const uint16_t *encoded,uint32_t numWords) {
+
+  std::vector<AseCommandDecoder::Command> commands;
+  AseCommandDecoder::Result result;
+  uint32_t errorWord;
+
+  if((result=AseCommandDecoder::decode(encoded,numWords,commands,errorWord))!=AseCommandDecoder::OK) {
+
+    if(_streamErrors++==0)
+      fprintf(stderr,"Frame %u: encoded stream error at word %u: %s\n",_frameNumber,errorWord,AseCommandDecoder::getResultText(result));
+  }
+
+  _encodedWords+=numWords;
+  AseEmulatorBus::writeEncodedBus(encoded,numWords);
+}
+
+
+/*
+ * Set the BUSY pin and raise the EXTI interrupt for the edge. BRAM port A is disabled
+ * while BUSY is high.
+ */
+
+inline void AseEmulator::setBusy(bool busy) {
+
+  _mcuInterface.setBusy(busy);
+  HostGpio::pin(BUSY_PORT,BUSY_PIN)=busy;
+  HostExti::raise(BUSY_PIN);
+}
+
+
+/*
+ * Move the host millisecond timer up to the given emulated cycle
+ */
+
+inline void AseEmulator::advanceTo(uint64_t cycles) {
+
+  _cycles=cycles;
+  MillisecondTimer::delay(static_cast<uint32_t>(_cycles/(CLOCK_HZ/1000))-MillisecondTimer::millis());
+}
+
+
+/*
+ * Start the frame: BUSY goes high. Anything the MCU does from here on is counted
+ * against this frame.
+ */
+
+inline void AseEmulator::beginBusyPeriod() {
+
+  _mcuInterface.clearCounters();
+  _encodedWords=_streamErrors=0;
+
+  setBusy(true);
+}
+
+
+/*
+ * Run the sprite writer pass and bring BUSY back down
+ */
+
+inline const SpriteWriterModel::Statistics& AseEmulator::endBusyPeriod() {
+
+  _stats.SpriteWriter=_spriteWriter.run(TE_CYCLES,_mcuInterface.getViewportOffset(),_mcuInterface.getLastSprite());
+  advanceTo(_cycles+_stats.SpriteWriter.Cycles);
+
+  setBusy(false);
+  return _stats.SpriteWriter;
+}
+
+
+/*
+ * Finish the frame: display SRAM and collect what the MCU did after BUSY fell
+ */
+
+inline const FrameStatistics& AseEmulator::endFrame() {
+
+  _frameWriter.run();
+
+  _stats.FrameNumber=_frameNumber++;
+  _stats.Mcu=_mcuInterface.getCounters();
+  _stats.McuBusCycles=_stats.Mcu.BusWords*BUS_CYCLES_PER_WORD;
+  _stats.EncodedWords=_encodedWords;
+  _stats.StreamErrors=_streamErrors;
+  _stats.FreeCycles=FRAME_CYCLES-_stats.SpriteWriter.Cycles;
+  _stats.FrameWriterCycles=FrameWriterModel::CYCLES;
+  _stats.Checksum=_frameWriter.getChecksum();
+
+  advanceTo(_cycles+_stats.FreeCycles);
+  return _stats;
+}
+
+
+/*
+ * Accessors
+ */
+
+inline const McuInterfaceModel& AseEmulator::getMcuInterface() const {
+  return _mcuInterface;
+}
+
+inline const SpriteMemory& AseEmulator::getSpriteMemory() const {
+  return _bram;
+}
+
+inline const FrameWriterModel& AseEmulator::getFrameWriter() const {
+  return _frameWriter;
+}
+
+inline const FlashModel& AseEmulator::getFlash() const {
+  return _flash;
+}
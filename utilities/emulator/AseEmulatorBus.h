@@ -0,0 +1,80 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * When the firmware is built for the host with ASE_EMULATOR defined the access mode sends
+ * each 10-bit bus word here instead of to GPIOE. The emulator attaches itself as the target.
+ */
+
+class AseEmulatorBus {
+
+  public:
+    virtual ~AseEmulatorBus() {}
+    virtual void writeBus(uint16_t value)=0;
+    virtual void writeEncodedBus(const uint16_t *encoded,uint32_t numWords);
+
+    static AseEmulatorBus*& target();
+    static void attach(AseEmulatorBus *bus);
+    static void write(uint16_t value);
+    static void writeEncoded(const uint16_t *encoded,uint32_t numWords);
+};
+
+
+/*
+ * Default handling of a pre-encoded burst is to send the WR low half of each pair
+ */
+
+inline void AseEmulatorBus::writeEncodedBus(const uint16_t *encoded,uint32_t numWords) {
+
+  while(numWords--) {
+    writeBus(*encoded & 0x3ff);
+    encoded+=2;
+  }
+}
+
+
+/*
+ * Storage for the attached bus
+ */
+
+inline AseEmulatorBus*& AseEmulatorBus::target() {
+  static AseEmulatorBus *bus=nullptr;
+  return bus;
+}
+
+
+/*
+ * Attach a bus implementation
+ */
+
+inline void AseEmulatorBus::attach(AseEmulatorBus *bus) {
+  target()=bus;
+}
+
+
+/*
+ * Write a word to the attached bus, if there is one
+ */
+
+inline void AseEmulatorBus::write(uint16_t value) {
+
+  if(target())
+    target()->writeBus(value & 0x3ff);
+}
+
+
+/*
+ * Write a pre-encoded burst to the attached bus, if there is one
+ */
+
+inline void AseEmulatorBus::writeEncoded(const uint16_t *encoded,uint32_t numWords) {
+
+  if(target())
+    target()->writeEncodedBus(encoded,numWords);
+}
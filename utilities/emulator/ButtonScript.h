@@ -0,0 +1,110 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Drives the 4-way buttons on PB12..15 from a script so that a run is repeatable.
+ * The script is a comma separated list of <button><frames> steps where the button is
+ * one of l,r,u,d or n for none. e.g. "u120,n30,l60". The script repeats when it ends.
+ */
+
+class ButtonScript {
+
+  protected:
+    enum {
+      LEFT_PIN = 12,
+      RIGHT_PIN = 13,
+      UP_PIN = 14,
+      DOWN_PIN = 15
+    };
+
+    struct Step {
+      char Button;
+      uint32_t Frames;
+    };
+
+    std::vector<Step> _steps;
+    uint32_t _totalFrames;
+
+  public:
+    ButtonScript();
+
+    bool parse(const char *script);
+    void apply(uint32_t frameNumber) const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline ButtonScript::ButtonScript()
+  : _totalFrames(0) {
+}
+
+
+/*
+ * Parse the script
+ */
+
+inline bool ButtonScript::parse(const char *script) {
+
+  Step step;
+  char *end;
+
+  while(*script) {
+
+    step.Button=*script++;
+
+    if(strchr("lrudn",step.Button)==nullptr)
+      return false;
+
+    step.Frames=strtoul(script,&end,10);
+    if(end==script || step.Frames==0)
+      return false;
+
+    _steps.push_back(step);
+    _totalFrames+=step.Frames;
+
+    script=end;
+    if(*script==',')
+      script++;
+  }
+
+  return true;
+}
+
+
+/*
+ * Set the button pins for the given frame
+ */
+
+inline void ButtonScript::apply(uint32_t frameNumber) const {
+
+  char button;
+
+  button='n';
+
+  if(_totalFrames) {
+
+    frameNumber%=_totalFrames;
+
+    for(const Step& step : _steps) {
+      if(frameNumber<step.Frames) {
+        button=step.Button;
+        break;
+      }
+      frameNumber-=step.Frames;
+    }
+  }
+
+  HostGpio::pin(HOST_PORTB,LEFT_PIN)=button=='l';
+  HostGpio::pin(HOST_PORTB,RIGHT_PIN)=button=='r';
+  HostGpio::pin(HOST_PORTB,UP_PIN)=button=='u';
+  HostGpio::pin(HOST_PORTB,DOWN_PIN)=button=='d';
+}
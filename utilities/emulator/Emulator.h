@@ -0,0 +1,45 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+// host includes
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+
+// the stm32plus host stand-in
+
+#include "config/stm32plus.h"
+#include "config/timing.h"
+#include "config/exti.h"
+
+using namespace stm32plus;
+
+// common ASE includes
+
+#include "AseCommands.h"
+#include "LoadSpriteDef.h"
+#include "MoveSpriteDef.h"
+#include "AseEmulatorBus.h"
+
+// emulator includes
+
+#include "SpriteRecord.h"
+#include "FlashModel.h"
+#include "SramModel.h"
+#include "McuInterfaceModel.h"
+#include "SpriteWriterModel.h"
+#include "FrameWriterModel.h"
+#include "FrameStatistics.h"
+#include "AseCommandDecoder.h"
+#include "AseEmulator.h"
+#include "ButtonScript.h"
+#include "PpmWriter.h"
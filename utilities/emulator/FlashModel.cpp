@@ -0,0 +1,87 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Emulator.h"
+
+
+/*
+ * Load all the files referenced by an index file
+ */
+
+bool FlashModel::loadIndex(const std::string& indexFile) {
+
+  std::ifstream index(indexFile.c_str());
+  std::string line,root,name;
+  std::string::size_type pos;
+
+  if(!index) {
+    fprintf(stderr,"Cannot open %s\n",indexFile.c_str());
+    return false;
+  }
+
+  // names are relative to the parent of the folder holding index.txt
+
+  root=indexFile;
+  for(int i=0;i<2;i++) {
+    if((pos=root.find_last_of('/'))==std::string::npos)
+      root=".";
+    else
+      root.erase(pos);
+  }
+
+  while(std::getline(index,line)) {
+
+    if(!line.empty() && line[line.size()-1]=='\r')
+      line.erase(line.size()-1);
+
+    if(line.empty())
+      continue;
+
+    if((pos=line.find('='))==std::string::npos) {
+      fprintf(stderr,"Bad index line: %s\n",line.c_str());
+      return false;
+    }
+
+    name=line.substr(0,pos);
+    if(name[0]=='/')
+      name.erase(0,1);
+
+    if(!loadFile(root+"/"+name,strtoul(line.c_str()+pos+1,nullptr,10)))
+      return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Program a file at the given offset
+ */
+
+bool FlashModel::loadFile(const std::string& filename,uint32_t offset) {
+
+  std::ifstream file(filename.c_str(),std::ios::binary);
+  std::vector<char> content;
+
+  if(!file) {
+    fprintf(stderr,"Cannot open %s\n",filename.c_str());
+    return false;
+  }
+
+  content.assign(std::istreambuf_iterator<char>(file),std::istreambuf_iterator<char>());
+
+  if(offset+content.size()>FLASH_SIZE) {
+    fprintf(stderr,"%s does not fit in the flash at %u\n",filename.c_str(),offset);
+    return false;
+  }
+
+  memcpy(&_data[offset],content.data(),content.size());
+
+  if(offset+content.size()>_highWater)
+    _highWater=offset+content.size();
+
+  return true;
+}
@@ -0,0 +1,78 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Model of the quad-IO SPI flash with its 24-bit address space. It's loaded from the same index.txt that the
+ * flash_programmer utility reads from the SD card. Each line is:
+ *
+ *   spiflash/<filename>=<start-address-in-flash-in-decimal>
+ *
+ * and the filenames are relative to the directory that contains the spiflash folder.
+ */
+
+class FlashModel {
+
+  public:
+    enum {
+      FLASH_SIZE = 16*1024*1024
+    };
+
+  protected:
+    std::vector<uint8_t> _data;
+    uint32_t _highWater;
+
+  public:
+    FlashModel();
+
+    bool loadIndex(const std::string& indexFile);
+    bool loadFile(const std::string& filename,uint32_t offset);
+
+    uint8_t readByte(uint32_t address) const;
+    uint8_t readNibble(uint64_t nibbleAddress) const;
+    uint32_t getHighWater() const;
+};
+
+
+/*
+ * Constructor. Erased flash reads as 0xff.
+ */
+
+inline FlashModel::FlashModel()
+  : _data(FLASH_SIZE,0xff),
+    _highWater(0) {
+}
+
+
+/*
+ * Read a byte. The address wraps at 24 bits like the device does.
+ */
+
+inline uint8_t FlashModel::readByte(uint32_t address) const {
+  return _data[address & (FLASH_SIZE-1)];
+}
+
+
+/*
+ * Read a nibble in quad-IO order: high nibble of each byte first
+ */
+
+inline uint8_t FlashModel::readNibble(uint64_t nibbleAddress) const {
+
+  uint8_t b=readByte(static_cast<uint32_t>(nibbleAddress >> 1));
+  return (nibbleAddress & 1) ? (b & 0xf) : (b >> 4);
+}
+
+
+/*
+ * Get the address one past the last programmed byte
+ */
+
+inline uint32_t FlashModel::getHighWater() const {
+  return _highWater;
+}
@@ -0,0 +1,86 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Everything we know about one emulated frame. Cycle counts are in FPGA (100MHz) clocks.
+ */
+
+struct FrameStatistics {
+
+  uint32_t FrameNumber;
+  SpriteWriterModel::Statistics SpriteWriter;   // the busy period
+  McuInterfaceModel::Counters Mcu;              // what the MCU sent after busy fell
+  uint32_t McuBusCycles;                        // time the MCU spent writing those words
+  uint32_t EncodedWords;                        // words that arrived in pre-encoded bursts
+  uint32_t StreamErrors;                        // malformed pre-encoded bursts
+  uint32_t ShadowSkipped;                       // requests that the sprite shadow found unchanged
+  uint32_t ShadowWordsSaved;                    // bus words that the sprite shadow didn't send
+  uint32_t PredictedCycles;                     // the firmware's AseSpriteCost prediction of the busy period
+  uint32_t BudgetFallbacks;                     // actors that kept their old image to fit the AseSpriteBudget
+  uint32_t BudgetDeferred;                      // actors hidden because they didn't fit
+  uint32_t FreeCycles;                          // time available to the MCU before the next busy period
+  uint32_t FrameWriterCycles;
+  uint32_t Checksum;                            // FNV-1a of the displayed frame
+
+  static void writeCsvHeader(FILE *f);
+  void writeCsv(FILE *f) const;
+};
+
+
+/*
+ * Write the CSV column names
+ */
+
+inline void FrameStatistics::writeCsvHeader(FILE *f) {
+  fputs("frame,busy_cycles,predicted_cycles,overrun,records_read,visible_sprites,persistent_skipped,sprite_copies,pixels_read,pixels_written,flash_bytes,span_headers,span_bytes_saved,"
+        "bus_words,bus_cycles,free_cycles,loads,moves,move_partials,shows,hides,offsets,last_sprites,lost_writes,"
+        "encoded_words,stream_errors,shadow_skipped,shadow_words_saved,budget_fallbacks,budget_deferred,frame_writer_cycles,checksum\n",f);
+}
+
+
+/*
+ * Write this frame as a CSV line
+ */
+
+inline void FrameStatistics::writeCsv(FILE *f) const {
+
+  fprintf(f,"%u,%u,%u,%d,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%08x\n",
+      FrameNumber,
+      SpriteWriter.Cycles,
+      PredictedCycles,
+      SpriteWriter.Overrun ? 1 : 0,
+      SpriteWriter.RecordsRead,
+      SpriteWriter.VisibleSprites,
+      SpriteWriter.PersistentSkipped,
+      SpriteWriter.SpriteCopies,
+      SpriteWriter.PixelsRead,
+      SpriteWriter.PixelsWritten,
+      SpriteWriter.FlashNibbles/2,
+      SpriteWriter.SpanHeaders,
+      SpriteWriter.SpanNibblesSaved/2,
+      Mcu.BusWords,
+      McuBusCycles,
+      FreeCycles,
+      Mcu.Loads,
+      Mcu.Moves,
+      Mcu.MovePartials,
+      Mcu.Shows,
+      Mcu.Hides,
+      Mcu.Offsets,
+      Mcu.LastSprites,
+      Mcu.LostWrites,
+      EncodedWords,
+      StreamErrors,
+      ShadowSkipped,
+      ShadowWordsSaved,
+      BudgetFallbacks,
+      BudgetDeferred,
+      FrameWriterCycles,
+      Checksum);
+}
@@ -0,0 +1,89 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Model of frame_writer.vhdl. The whole of the 360x640 frame is copied from SRAM to the LCD
+ * while the frame index is zero. The bit shuffle in the VHDL only compensates for the PCB
+ * routing of the SRAM data lines so the pixels that arrive at the LCD are the little-endian
+ * RGB565 words that were read out of the flash.
+ */
+
+class FrameWriterModel {
+
+  public:
+    enum {
+      WIDTH = 360,
+      HEIGHT = 640,
+      NUM_PIXELS = WIDTH*HEIGHT,
+      SETUP_CYCLES = 4,                 // setup_0..pre_3
+      CYCLES_PER_PIXEL = 7,             // state_0..state_60
+      CYCLES = SETUP_CYCLES+NUM_PIXELS*CYCLES_PER_PIXEL
+    };
+
+  protected:
+    const SramModel& _sram;
+    std::vector<uint16_t> _frame;
+
+  public:
+    FrameWriterModel(const SramModel& sram);
+
+    void run();
+
+    const std::vector<uint16_t>& getFrame() const;
+    uint32_t getChecksum() const;
+};
+
+
+/*
+ * Constructor
+ */
+
+inline FrameWriterModel::FrameWriterModel(const SramModel& sram)
+  : _sram(sram),
+    _frame(NUM_PIXELS,0) {
+}
+
+
+/*
+ * Copy the SRAM to the display
+ */
+
+inline void FrameWriterModel::run() {
+
+  const uint8_t *ptr=&_sram.Data[0];
+
+  for(uint32_t i=0;i<NUM_PIXELS;i++,ptr+=2)
+    _frame[i]=ptr[0] | (ptr[1] << 8);
+}
+
+
+/*
+ * Get the displayed frame as RGB565 pixels, row-major in portrait orientation
+ */
+
+inline const std::vector<uint16_t>& FrameWriterModel::getFrame() const {
+  return _frame;
+}
+
+
+/*
+ * FNV-1a checksum of the displayed frame, used for regression testing
+ */
+
+inline uint32_t FrameWriterModel::getChecksum() const {
+
+  uint32_t hash=2166136261U;
+
+  for(uint16_t pixel : _frame) {
+    hash=(hash ^ (pixel & 0xff))*16777619U;
+    hash=(hash ^ (pixel >> 8))*16777619U;
+  }
+
+  return hash;
+}
@@ -0,0 +1,295 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Emulator.h"
+
+
+/*
+ * Process a word written to the bus by the MCU
+ */
+
+void McuInterfaceModel::write(uint16_t value) {
+
+  value&=0x3ff;
+  _counters.BusWords++;
+
+  switch(_state) {
+
+    case PASSTHROUGH_0:
+
+      // bit 9 set in the first byte is the escape to sprite mode
+
+      if(value & 0x200) {
+        _spriteMode=true;
+        _state=READING_CMD;
+      }
+      else {
+        _lcdData=value & 0xff;
+        _state=PASSTHROUGH_1;
+      }
+      break;
+
+    case PASSTHROUGH_1:
+      _lcdData|=(value & 0xff) << 8;
+      _counters.PassthroughWords++;
+      _state=PASSTHROUGH_0;
+      break;
+
+    case READING_CMD:
+      command(value);
+      break;
+
+    case READING_SHOWHIDE:
+      {
+        SpriteRecord sr(_bram.Records[value & SpriteRecord::NUMBER_MASK]);
+
+        sr.Visible=_showHideFlag;
+        sr.Persistent=_persistentFlag;
+        sr.Drawn=false;
+        writeRecord(value & SpriteRecord::NUMBER_MASK,sr);
+
+        if(_showHideFlag)
+          _counters.Shows++;
+        else
+          _counters.Hides++;
+
+        _state=READING_CMD;
+      }
+      break;
+
+    case READING_LOAD:
+      _params[_paramIndex++]=value;
+      if(_paramIndex==16) {
+        executeLoad();
+        _state=READING_CMD;
+      }
+      break;
+
+    case READING_LOAD_BLOCK:
+      loadBlock(value);
+      break;
+
+    case READING_MOVE:
+      _params[_paramIndex++]=value;
+      if(_paramIndex==(_movePartial ? 7 : 3)) {
+        executeMove();
+        _state=READING_CMD;
+      }
+      break;
+
+    case READING_OFFSET:
+      _params[_paramIndex++]=value;
+      if(_paramIndex==2) {
+        _viewportOffset=(_params[0] & 0x3ff) | ((_params[1] & 0xff) << 10);
+        _counters.Offsets++;
+        _state=READING_CMD;
+      }
+      break;
+
+    case READING_LAST_SPRITE:
+      _lastSprite=value & SpriteRecord::NUMBER_MASK;
+      _counters.LastSprites++;
+      _state=READING_CMD;
+      break;
+
+    case READING_PALETTE:
+      writePalette(value);
+      break;
+  }
+}
+
+
+/*
+ * Decode a command. Only the lower 8 bits are compared.
+ */
+
+void McuInterfaceModel::command(uint16_t value) {
+
+  _paramIndex=0;
+
+  switch(value & 0xff) {
+
+    case AseCommands::CMD_PASSTHROUGH & 0xff:
+      _spriteMode=false;
+      _state=PASSTHROUGH_0;
+      break;
+
+    case AseCommands::CMD_SHOW & 0xff:
+      _showHideFlag=true;
+      _persistentFlag=(value & 0x200)!=0;
+      _state=READING_SHOWHIDE;
+      break;
+
+    case AseCommands::CMD_HIDE & 0xff:
+      _showHideFlag=false;
+      _persistentFlag=false;
+      _state=READING_SHOWHIDE;
+      break;
+
+    case AseCommands::CMD_LOAD & 0xff:
+      _state=READING_LOAD;
+      break;
+
+    case AseCommands::CMD_LOAD_BLOCK & 0xff:
+      _blockCount=0;
+      _state=READING_LOAD_BLOCK;
+      break;
+
+    case AseCommands::CMD_MOVE & 0xff:
+      _movePartial=(value & 0x200)!=0;
+      _state=READING_MOVE;
+      break;
+
+    case AseCommands::CMD_OFFSET & 0xff:
+      _state=READING_OFFSET;
+      break;
+
+    case AseCommands::CMD_LAST_SPRITE & 0xff:
+      _state=READING_LAST_SPRITE;
+      break;
+
+    case AseCommands::CMD_PALETTE & 0xff:
+      _state=READING_PALETTE;
+      break;
+
+    default:
+      _counters.UnknownCommands++;
+      break;
+  }
+}
+
+
+/*
+ * Execute a CMD_LOAD
+ */
+
+void McuInterfaceModel::executeLoad() {
+
+  SpriteRecord sr;
+
+  sr.SramAddress=(_params[1] & 0x3ff) | ((_params[2] & 0xff) << 10);
+  sr.Width=_params[3] & SpriteRecord::WIDTH_MASK;
+  sr.Size=(_params[4] & 0x3ff) | ((_params[5] & 0xff) << 10);
+  sr.FlashAddress=(_params[6] & 0xff) | ((_params[7] & 0xff) << 8) | ((_params[8] & 0xff) << 16);
+  sr.RepeatX=_params[9] & SpriteRecord::WIDTH_MASK;
+  sr.RepeatY=_params[10] & SpriteRecord::HEIGHT_MASK;
+  sr.Visible=(_params[11] & 1)!=0;
+  sr.Persistent=(_params[11] & 2)!=0;
+  sr.Mirror=(_params[11] & 4)!=0;
+  sr.Indexed=(_params[11] & 8)!=0;
+  sr.Spans=(_params[11] & 16)!=0;
+  sr.FirstX=_params[12] & SpriteRecord::WIDTH_MASK;
+  sr.LastX=_params[13] & SpriteRecord::WIDTH_MASK;
+  sr.FirstY=_params[14] & SpriteRecord::HEIGHT_MASK;
+  sr.LastY=_params[15] & SpriteRecord::HEIGHT_MASK;
+
+  writeRecord(_params[0] & SpriteRecord::NUMBER_MASK,sr);
+  _counters.Loads++;
+}
+
+
+/*
+ * Take a CMD_LOAD_BLOCK parameter: the first sprite, the count less one and then the records.
+ * Each record is collected into _params[1..15] and loaded as a CMD_LOAD for the current sprite,
+ * which then moves on by one and wraps at 511 as the VHDL does.
+ */
+
+void McuInterfaceModel::loadBlock(uint16_t value) {
+
+  _params[_paramIndex++]=value;
+
+  if(_blockCount==0) {
+
+    if(_paramIndex==2) {
+      _blockSprite=_params[0] & SpriteRecord::NUMBER_MASK;
+      _blockCount=(_params[1] & SpriteRecord::NUMBER_MASK)+1;
+      _paramIndex=1;
+    }
+  }
+  else if(_paramIndex==16) {
+
+    _params[0]=_blockSprite;
+    executeLoad();
+
+    _blockSprite=(_blockSprite+1) & SpriteRecord::NUMBER_MASK;
+    _paramIndex=1;
+
+    if(--_blockCount==0)
+      _state=READING_CMD;
+  }
+}
+
+
+/*
+ * Execute a CMD_MOVE or partial move. Both make the sprite visible and leave it to be drawn.
+ */
+
+void McuInterfaceModel::executeMove() {
+
+  uint16_t spriteNumber;
+
+  spriteNumber=_params[0] & SpriteRecord::NUMBER_MASK;
+  SpriteRecord sr(_bram.Records[spriteNumber]);
+
+  sr.SramAddress=(_params[1] & 0x3ff) | ((_params[2] & 0xff) << 10);
+  sr.Visible=true;
+  sr.Drawn=false;
+
+  if(_movePartial) {
+    sr.FirstX=_params[3] & SpriteRecord::WIDTH_MASK;
+    sr.LastX=_params[4] & SpriteRecord::WIDTH_MASK;
+    sr.FirstY=_params[5] & SpriteRecord::HEIGHT_MASK;
+    sr.LastY=_params[6] & SpriteRecord::HEIGHT_MASK;
+    _counters.MovePartials++;
+  }
+  else
+    _counters.Moves++;
+
+  writeRecord(spriteNumber,sr);
+}
+
+
+/*
+ * Write to the BRAM if port A is enabled
+ */
+
+void McuInterfaceModel::writeRecord(uint16_t spriteNumber,const SpriteRecord& record) {
+
+  if(_busy)
+    _counters.LostWrites++;
+  else
+    _bram.Records[spriteNumber]=record;
+}
+
+
+/*
+ * Take a CMD_PALETTE parameter: the first index, the count less one and then the colours as
+ * low, high pairs. The index moves on after each colour and wraps at 256 as the VHDL does.
+ */
+
+void McuInterfaceModel::writePalette(uint16_t value) {
+
+  _params[_paramIndex++]=value;
+
+  if(_paramIndex==2) {
+    _paletteIndex=_params[0] & 0xff;
+    _paletteCount=(_params[1] & 0xff)+1;
+  }
+  else if(_paramIndex==4) {
+
+    if(_busy)
+      _counters.LostWrites++;
+    else
+      _palette.Colours[_paletteIndex]=(_params[2] & 0xff) | ((_params[3] & 0xff) << 8);
+
+    _paletteIndex++;
+    _paramIndex=2;
+    _counters.PaletteColours++;
+
+    if(--_paletteCount==0)
+      _state=READING_CMD;
+  }
+}
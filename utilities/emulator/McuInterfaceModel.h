@@ -0,0 +1,176 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Model of mcu_interface.vhdl. Words arrive from the MCU bus and are decoded exactly as the
+ * FPGA state machine does: commands are matched on the low 8 bits and parameters are truncated
+ * to their field widths. BRAM port A is disabled while the sprite writer is busy so any record
+ * written during that time is lost, and so is any palette colour. We count those writes so that
+ * a firmware bug of that kind shows up in the statistics.
+ */
+
+class McuInterfaceModel {
+
+  public:
+
+    /*
+     * Counters that are reset by the owner at the start of each frame
+     */
+
+    struct Counters {
+      uint32_t BusWords;
+      uint32_t PassthroughWords;
+      uint32_t Loads;
+      uint32_t Moves;
+      uint32_t MovePartials;
+      uint32_t Shows;
+      uint32_t Hides;
+      uint32_t Offsets;
+      uint32_t LastSprites;
+      uint32_t PaletteColours;
+      uint32_t UnknownCommands;
+      uint32_t LostWrites;
+
+      void clear() { *this=Counters(); }
+    };
+
+  protected:
+
+    enum State {
+      PASSTHROUGH_0,
+      PASSTHROUGH_1,
+      READING_CMD,
+      READING_SHOWHIDE,
+      READING_LOAD,
+      READING_LOAD_BLOCK,
+      READING_MOVE,
+      READING_OFFSET,
+      READING_LAST_SPRITE,
+      READING_PALETTE
+    };
+
+    SpriteMemory& _bram;
+    PaletteMemory& _palette;
+    State _state;
+    bool _spriteMode;
+    bool _busy;
+    bool _showHideFlag;
+    bool _persistentFlag;
+    bool _movePartial;
+    uint8_t _paramIndex;
+    uint16_t _params[16];
+    uint16_t _lcdData;
+    uint32_t _viewportOffset;
+    uint16_t _lastSprite;
+    uint8_t _paletteIndex;
+    uint16_t _paletteCount;
+    uint16_t _blockSprite;
+    uint16_t _blockCount;
+    Counters _counters;
+
+  protected:
+    void command(uint16_t value);
+    void executeLoad();
+    void executeMove();
+    void loadBlock(uint16_t value);
+    void writeRecord(uint16_t spriteNumber,const SpriteRecord& record);
+    void writePalette(uint16_t value);
+
+  public:
+    McuInterfaceModel(SpriteMemory& bram,PaletteMemory& palette);
+
+    void write(uint16_t value);
+    void setBusy(bool busy);
+
+    bool isSpriteMode() const;
+    uint32_t getViewportOffset() const;
+    uint16_t getLastSprite() const;
+    const Counters& getCounters() const;
+    void clearCounters();
+};
+
+
+/*
+ * Constructor. The FPGA comes out of reset in passthrough mode.
+ */
+
+inline McuInterfaceModel::McuInterfaceModel(SpriteMemory& bram,PaletteMemory& palette)
+  : _bram(bram),
+    _palette(palette),
+    _state(PASSTHROUGH_0),
+    _spriteMode(false),
+    _busy(false),
+    _showHideFlag(false),
+    _persistentFlag(false),
+    _movePartial(false),
+    _paramIndex(0),
+    _lcdData(0),
+    _viewportOffset(0),
+    _lastSprite(SpriteMemory::LAST_SPRITE),
+    _paletteIndex(0),
+    _paletteCount(0),
+    _blockSprite(0),
+    _blockCount(0),
+    _counters() {
+}
+
+
+/*
+ * Set the state of the sprite writer's busy flag
+ */
+
+inline void McuInterfaceModel::setBusy(bool busy) {
+  _busy=busy;
+}
+
+
+/*
+ * Return true if in sprite mode
+ */
+
+inline bool McuInterfaceModel::isSpriteMode() const {
+  return _spriteMode;
+}
+
+
+/*
+ * Get the viewport offset register. It's not BRAM so CMD_OFFSET works while busy, but the
+ * sprite writer only reads it at the start of a pass.
+ */
+
+inline uint32_t McuInterfaceModel::getViewportOffset() const {
+  return _viewportOffset;
+}
+
+
+/*
+ * Get the last sprite register. Like the viewport offset it's latched at the start of a pass.
+ */
+
+inline uint16_t McuInterfaceModel::getLastSprite() const {
+  return _lastSprite;
+}
+
+
+/*
+ * Get the counters
+ */
+
+inline const McuInterfaceModel::Counters& McuInterfaceModel::getCounters() const {
+  return _counters;
+}
+
+
+/*
+ * Reset the counters
+ */
+
+inline void McuInterfaceModel::clearCounters() {
+  _counters.clear();
+}
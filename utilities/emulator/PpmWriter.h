@@ -0,0 +1,46 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Write an RGB565 frame to a binary PPM file
+ */
+
+class PpmWriter {
+
+  public:
+    static bool write(const std::string& filename,const std::vector<uint16_t>& frame,uint16_t width,uint16_t height);
+};
+
+
+/*
+ * Write the file
+ */
+
+inline bool PpmWriter::write(const std::string& filename,const std::vector<uint16_t>& frame,uint16_t width,uint16_t height) {
+
+  FILE *f;
+
+  if((f=fopen(filename.c_str(),"wb"))==nullptr)
+    return false;
+
+  fprintf(f,"P6\n%u %u\n255\n",width,height);
+
+  for(uint16_t pixel : frame) {
+
+    uint8_t rgb[3];
+
+    rgb[0]=((pixel >> 11) & 0x1f) << 3;
+    rgb[1]=((pixel >> 5) & 0x3f) << 2;
+    rgb[2]=(pixel & 0x1f) << 3;
+
+    fwrite(rgb,sizeof(rgb),1,f);
+  }
+
+  return fclose(f)==0;
+}
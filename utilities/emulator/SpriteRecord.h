@@ -0,0 +1,85 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * A sprite record as held in the 512 entry BRAM (sprite_record_t in constants.vhdl).
+ * Field values are always held masked to their hardware widths.
+ */
+
+struct SpriteRecord {
+
+  enum {
+    FLASH_ADDR_MASK = 0xffffff,     // 24 bits
+    SRAM_ADDR_MASK  = 0x3ffff,      // 18 bits (pixel address)
+    SIZE_MASK       = 0x3ffff,      // 18 bits
+    WIDTH_MASK      = 0x1ff,        // 9 bits
+    HEIGHT_MASK     = 0x3ff,        // 10 bits
+    NUMBER_MASK     = 0x1ff         // 9 bits
+  };
+
+  uint32_t FlashAddress;
+  uint32_t SramAddress;
+  uint32_t Size;
+  uint16_t Width;
+  uint16_t RepeatX;
+  uint16_t RepeatY;
+  bool Visible;
+  bool Persistent;
+  bool Drawn;                       // set by the sprite writer for a persistent sprite
+  bool Mirror;                      // rows drawn bottom up
+  bool Indexed;                     // one palette index byte per pixel in flash
+  bool Spans;                       // span headers and opaque pixels in flash
+  uint16_t FirstX;
+  uint16_t LastX;
+  uint16_t FirstY;
+  uint16_t LastY;
+
+  SpriteRecord()
+    : FlashAddress(0),SramAddress(0),Size(0),Width(0),RepeatX(0),RepeatY(0),
+      Visible(false),Persistent(false),Drawn(false),Mirror(false),Indexed(false),Spans(false),FirstX(0),LastX(0),FirstY(0),LastY(0) {
+  }
+};
+
+
+/*
+ * The BRAM itself. Port A belongs to mcu_interface and is disabled while the sprite writer is busy.
+ * The sprite writer uses port B to mark persistent sprites as drawn.
+ */
+
+struct SpriteMemory {
+
+  enum {
+    NUM_SPRITES = 512,
+    LAST_SPRITE = NUM_SPRITES-1
+  };
+
+  SpriteRecord Records[NUM_SPRITES];
+};
+
+
+/*
+ * The palette of the indexed sprites (palette_memory.vhdl). It's distributed RAM with one port
+ * that belongs to the sprite writer while it's busy so, like BRAM port A, the mcu_interface
+ * can't write it then.
+ */
+
+struct PaletteMemory {
+
+  enum {
+    NUM_COLOURS = 256,
+    INITIAL_COLOUR = 0x1ff8         // the VHDL initialises it to transparent
+  };
+
+  uint16_t Colours[NUM_COLOURS];
+
+  PaletteMemory() {
+    for(uint16_t i=0;i<NUM_COLOURS;i++)
+      Colours[i]=INITIAL_COLOUR;
+  }
+};
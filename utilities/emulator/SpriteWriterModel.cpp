@@ -0,0 +1,494 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Emulator.h"
+
+
+/*
+ * Constructor
+ */
+
+SpriteWriterModel::SpriteWriterModel(SpriteMemory& bram,const PaletteMemory& palette,const FlashModel& flash,SramModel& sram)
+  : _bram(bram),
+    _palette(palette),
+    _flash(flash),
+    _sram(sram),
+    _state(IDLE),
+    _frameIndex(false),
+    _viewportOffset(0),
+    _redraw(false),
+    _lastSprite(SpriteMemory::LAST_SPRITE),
+    _spriteNumber(0),
+    _sramOrg(0),
+    _sramNextX(0),
+    _sramAddr(0),
+    _sramAdderSum(0),
+    _sramRowUp(0),
+    _nextx(0),
+    _nextxAdderSum(0),
+    _spriteWidth(0),
+    _spriteSize(0),
+    _repeatY(0),
+    _lastPixel(0),
+    _pixel(0),
+    _paletteAddr(0),
+    _spanRun(0),
+    _spanLast(false),
+    _spanSlot(false),
+    _firstInColumn(false),
+    _xok(false),
+    _yok(false),
+    _xokReset(false),
+    _x(0),
+    _xorg(0),
+    _y(0),
+    _nibble(0),
+    _stats() {
+}
+
+
+/*
+ * Run one pass, starting at the rising edge of the frame index. The frame index falls back
+ * to zero after the given number of cycles and any sprite still being written is abandoned.
+ * The viewport offset and the last sprite are latched for the whole pass as the VHDL does when
+ * it leaves idle. A new offset means that the drawn persistent sprites are drawn again.
+ */
+
+const SpriteWriterModel::Statistics& SpriteWriterModel::run(uint32_t cyclesUntilFrameFlip,uint32_t viewportOffset,uint16_t lastSprite) {
+
+  memset(&_stats,0,sizeof(_stats));
+
+  _redraw=(viewportOffset & SpriteRecord::SRAM_ADDR_MASK)!=_viewportOffset;
+  _viewportOffset=viewportOffset & SpriteRecord::SRAM_ADDR_MASK;
+  _lastSprite=lastSprite & SpriteRecord::NUMBER_MASK;
+
+  _spriteNumber=0;
+  _state=BRAM_0;
+
+  while(_state!=IDLE) {
+
+    _frameIndex=_stats.Cycles<cyclesUntilFrameFlip;
+    step();
+    _stats.Cycles++;
+  }
+
+  return _stats;
+}
+
+
+/*
+ * Advance the state machine by one clock
+ */
+
+void SpriteWriterModel::step() {
+
+  switch(_state) {
+
+    case IDLE:
+      break;
+
+    // read out the sprite record from bram
+
+    case BRAM_0:
+      _stats.RecordsRead++;
+      _state=BRAM_1;
+      break;
+
+    case BRAM_1:
+      _state=BRAM_2;
+      break;
+
+    case BRAM_2:
+      if(!_bram.Records[_spriteNumber].Visible)
+        _state=NEXT_SPRITE;
+      else if(_bram.Records[_spriteNumber].Persistent && _bram.Records[_spriteNumber].Drawn && !_redraw) {
+        _stats.PersistentSkipped++;
+        _state=NEXT_SPRITE;
+      }
+      else {
+        _record=_bram.Records[_spriteNumber];
+        _stats.VisibleSprites++;
+        _state=OUTER_SETUP_0;
+      }
+      break;
+
+    // calculate the first origin and get the resettable y counter. The viewport offset is
+    // subtracted modulo the 18-bit pixel address.
+
+    case OUTER_SETUP_0:
+      _sramOrg=((_record.SramAddress-_viewportOffset) & SpriteRecord::SRAM_ADDR_MASK) << 1;
+      _repeatY=_record.RepeatY;
+      _firstInColumn=true;
+      _yok=false;
+      _xok=false;
+      _xokReset=false;
+      _y=0;
+      _xorg=0;
+      _state=OUTER_SETUP_1;
+      break;
+
+    // start the next-x additions and select the flash
+
+    case OUTER_SETUP_1:
+      _sramAdderSum=(_sramOrg+((_record.Width << 1) & 0x3ff)) & SramModel::BYTE_ADDR_MASK;
+      _nextxAdderSum=(_xorg+_record.Width) & SpriteRecord::WIDTH_MASK;
+      _nibble=static_cast<uint64_t>(_record.FlashAddress) << 1;
+      _stats.SpriteCopies++;
+      _state=CMD_7;
+      break;
+
+    // flash QUAD IO read command
+
+    case CMD_7:
+      _spriteWidth=_record.Width;
+      _spriteSize=_record.Size;
+      _sramAddr=_sramOrg;
+      _x=_xorg;
+      _state=CMD_6;
+      break;
+
+    case CMD_6:
+      _repeatY=(_repeatY-1) & SpriteRecord::HEIGHT_MASK;
+      _state=CMD_5;
+      break;
+
+    case CMD_5:
+      if(_firstInColumn) {
+        _sramNextX=_sramAdderSum;
+        _nextx=_nextxAdderSum;
+      }
+      _state=CMD_4;
+      break;
+
+    case CMD_4:
+      _firstInColumn=false;
+      _state=CMD_3;
+      break;
+
+    case CMD_3: _state=CMD_2; break;
+    case CMD_2: _state=CMD_1; break;
+    case CMD_1: _state=CMD_0; break;
+    case CMD_0: _state=ADDR_5; break;
+
+    // 24 bit address, mode and dummy clocks
+
+    case ADDR_5: _state=ADDR_4; break;
+    case ADDR_4: _state=ADDR_3; break;
+    case ADDR_3: _state=ADDR_2; break;
+    case ADDR_2: _state=ADDR_1; break;
+    case ADDR_1: _state=ADDR_0; break;
+    case ADDR_0: _state=MODE_1; break;
+    case MODE_1: _state=MODE_0; break;
+    case MODE_0: _state=DUMMY_4; break;
+    case DUMMY_4: _state=DUMMY_3; break;
+    case DUMMY_3: _state=DUMMY_2; break;
+    case DUMMY_2: _state=DUMMY_1; break;
+    case DUMMY_1: _state=DUMMY_0; break;
+
+    case DUMMY_0:
+      _spriteSize=(_spriteSize-1) & SpriteRecord::SIZE_MASK;
+      _state=DATA_OUT_PAUSE0;
+      break;
+
+    case DATA_OUT_PAUSE0: _state=DATA_OUT_PAUSE1; break;
+    case DATA_OUT_PAUSE1: _state=FIRST_PIXEL_READ_0; break;
+
+    // prime last_pixel with the first pixel. The flash clock stops in states 1 and 3 for an
+    // indexed sprite so it takes two nibbles and they're looked up in the palette.
+
+    case FIRST_PIXEL_READ_0:
+      _lastPixel=(_lastPixel & 0x0fff) | (readFlash() << 12);
+      _state=FIRST_PIXEL_READ_1;
+      break;
+
+    case FIRST_PIXEL_READ_1:
+      if(!_record.Indexed)
+        _lastPixel=(_lastPixel & 0xf0ff) | (readFlash() << 8);
+      _state=FIRST_PIXEL_READ_2;
+      break;
+
+    case FIRST_PIXEL_READ_2:
+      {
+        uint8_t nibble=readFlash();
+
+        _lastPixel=(_lastPixel & 0xff0f) | (nibble << 4);
+        _paletteAddr=((_lastPixel >> 8) & 0xf0) | nibble;
+      }
+      _state=FIRST_PIXEL_READ_3;
+      break;
+
+    case FIRST_PIXEL_READ_3:
+      if(_record.Indexed)
+        _lastPixel=_palette.Colours[_paletteAddr];
+      else
+        _lastPixel=(_lastPixel & 0xfff0) | readFlash();
+
+      if(_record.Spans) {
+
+        // the first word is the first header of the first row
+
+        uint16_t skip=(_lastPixel >> 8) & 0x7f;
+
+        _sramAddr=(_sramAddr+(skip << 1)) & SramModel::BYTE_ADDR_MASK;
+        _x=(_x+skip) & SpriteRecord::WIDTH_MASK;
+        spanHeader(_lastPixel);
+      }
+      else {
+
+        _spanSlot=false;
+        _stats.PixelsRead++;
+
+        if(_x==_record.FirstX) {
+          _xok=true;
+          _xokReset=true;
+        }
+      }
+
+      _state=PIXEL_READ_0;
+      break;
+
+    // main read loop
+
+    case PIXEL_READ_0:
+
+      if(!_frameIndex) {
+        _stats.Overrun=true;
+        _state=IDLE;
+      }
+      else {
+
+        _sramAdderSum=(_sramOrg+ROW_BYTES) & SramModel::BYTE_ADDR_MASK;
+        _sramRowUp=(_sramOrg-ROW_BYTES) & SramModel::BYTE_ADDR_MASK;
+        _spriteSize=(_spriteSize-1) & SpriteRecord::SIZE_MASK;
+        _pixel=readFlash() << 12;
+
+        if(_lastPixel!=TRANSPARENT && _xok && (_yok || _y==_record.FirstY) && !_spanSlot) {
+          writeSram(_lastPixel >> 8);
+          _stats.PixelsWritten++;
+        }
+
+        if(_y==_record.FirstY)
+          _yok=true;
+
+        _state=PIXEL_READ_1;
+      }
+      break;
+
+    case PIXEL_READ_1:
+      if(!_record.Indexed)
+        _pixel|=readFlash() << 8;
+      if(!_spanSlot)
+        _sramAddr=(_sramAddr+1) & SramModel::BYTE_ADDR_MASK;
+      _spriteWidth=(_spriteWidth-1) & SpriteRecord::WIDTH_MASK;
+      _state=PIXEL_READ_2;
+      break;
+
+    case PIXEL_READ_2:
+      {
+        uint8_t nibble=readFlash();
+
+        _pixel|=nibble << 4;
+        _paletteAddr=((_pixel >> 8) & 0xf0) | nibble;
+      }
+
+      if(_lastPixel!=TRANSPARENT && _xok && _yok && !_spanSlot)
+        writeSram(_lastPixel & 0xff);
+
+      if(_x==_record.LastX)
+        _xok=false;
+
+      if(!_spanSlot)
+        _x=(_x+1) & SpriteRecord::WIDTH_MASK;
+      _state=PIXEL_READ_3;
+      break;
+
+    case PIXEL_READ_3:
+      _lastPixel=_record.Indexed ? _palette.Colours[_paletteAddr] : _pixel | readFlash();
+
+      if(_record.Spans) {
+
+        if(_spanRun==0) {
+
+          // a header. It starts the next row if the last span ended its row.
+
+          uint16_t skip=(_lastPixel >> 8) & 0x7f;
+
+          if(_spanLast) {
+
+            _sramOrg=_record.Mirror ? _sramRowUp : _sramAdderSum;
+            _sramAddr=(_sramOrg+(skip << 1)) & SramModel::BYTE_ADDR_MASK;
+            _x=(_xorg+skip) & SpriteRecord::WIDTH_MASK;
+
+            if(_y==_record.LastY)
+              _yok=false;
+
+            _y=(_y+1) & SpriteRecord::HEIGHT_MASK;
+          }
+          else {
+            _sramAddr=(_sramAddr+(_spanSlot ? 0 : 1)+(skip << 1)) & SramModel::BYTE_ADDR_MASK;
+            _x=(_x+skip) & SpriteRecord::WIDTH_MASK;
+          }
+
+          spanHeader(_lastPixel);
+        }
+        else {
+
+          // a pixel in the current span
+
+          if(!_spanSlot)
+            _sramAddr=(_sramAddr+1) & SramModel::BYTE_ADDR_MASK;
+
+          _spanRun--;
+          _spanSlot=false;
+          _xok=_x>=_record.FirstX && _x<=_record.LastX;
+          _stats.PixelsRead++;
+          _stats.SpanNibblesSaved-=4;
+        }
+
+        _state=_spriteSize==0 ? LAST_PIXEL_WRITE_0 : PIXEL_READ_0;
+        break;
+      }
+
+      _stats.PixelsRead++;
+
+      if(_spriteSize==0) {
+
+        // loop done, but the cached last pixel needs to be written
+
+        _sramAddr=(_sramAddr+1) & SramModel::BYTE_ADDR_MASK;
+        _state=LAST_PIXEL_WRITE_0;
+      }
+      else if(_spriteWidth==0) {
+
+        // end of just this row
+
+        _sramAddr=_record.Mirror ? _sramRowUp : _sramAdderSum;
+        _sramOrg=_sramAddr;
+        _spriteWidth=_record.Width;
+        _x=_xorg;
+        _xok=_xokReset;
+
+        if(_y==_record.LastY)
+          _yok=false;
+
+        _y=(_y+1) & SpriteRecord::HEIGHT_MASK;
+        _state=PIXEL_READ_0;
+      }
+      else {
+
+        if(_x==_record.FirstX)
+          _xok=true;
+
+        _sramAddr=(_sramAddr+1) & SramModel::BYTE_ADDR_MASK;
+        _state=PIXEL_READ_0;
+      }
+      break;
+
+    // write out the final pixel
+
+    case LAST_PIXEL_WRITE_0:
+      if(_lastPixel!=TRANSPARENT && _xok && _yok && !_spanSlot) {
+        writeSram(_lastPixel >> 8);
+        _stats.PixelsWritten++;
+      }
+      _state=LAST_PIXEL_WRITE_1;
+      break;
+
+    case LAST_PIXEL_WRITE_1:
+      _sramAddr=(_sramAddr+1) & SramModel::BYTE_ADDR_MASK;
+      _state=LAST_PIXEL_WRITE_2;
+      break;
+
+    case LAST_PIXEL_WRITE_2:
+      if(_lastPixel!=TRANSPARENT && _xok && _yok && !_spanSlot)
+        writeSram(_lastPixel & 0xff);
+      _state=DONE_THIS_SPRITE_0;
+      break;
+
+    case DONE_THIS_SPRITE_0:
+      _state=DONE_THIS_SPRITE_1;
+      break;
+
+    // see if we're done with this column of sprites
+
+    case DONE_THIS_SPRITE_1:
+      if(_repeatY==0) {
+        _record.RepeatX=(_record.RepeatX-1) & SpriteRecord::WIDTH_MASK;
+        _state=DONE_THIS_SPRITE_2;
+      }
+      else {
+
+        // move down the column to the next sprite, or up if mirrored
+
+        _sramOrg=_record.Mirror ? _sramRowUp : _sramAdderSum;
+        _x=_xorg;
+        _xok=_xokReset;
+
+        if(_y==_record.LastY)
+          _yok=false;
+
+        _y=(_y+1) & SpriteRecord::HEIGHT_MASK;
+        _state=OUTER_SETUP_1;
+      }
+      break;
+
+    case DONE_THIS_SPRITE_2:
+      if(_record.RepeatX==0)
+        _state=NEXT_SPRITE;
+      else {
+
+        // move to the next column
+
+        _sramOrg=_sramNextX;
+        _repeatY=_record.RepeatY;
+        _firstInColumn=true;
+        _xokReset=_xok;
+        _xorg=_nextx;
+        _y=0;
+        _yok=false;
+        _state=OUTER_SETUP_1;
+      }
+      break;
+
+    case NEXT_SPRITE:
+
+      // a persistent sprite that has just been drawn is marked on port B
+
+      {
+        SpriteRecord& sr(_bram.Records[_spriteNumber]);
+
+        if(sr.Visible && sr.Persistent && !sr.Drawn)
+          sr.Drawn=true;
+      }
+
+      if(_spriteNumber==_lastSprite)
+        _state=IDLE;
+      else {
+        _spriteNumber++;
+        _state=BRAM_0;
+      }
+      break;
+  }
+}
+
+
+/*
+ * Take a span header: [15] last span in the row, [14..8] skip, [7..0] length. The caller has
+ * already moved the position. A row's pixels would all have been read from a plain sprite.
+ */
+
+void SpriteWriterModel::spanHeader(uint16_t header) {
+
+  _spanRun=header & 0xff;
+  _spanLast=(header & 0x8000)!=0;
+  _spanSlot=true;
+
+  _stats.SpanHeaders++;
+  _stats.SpanNibblesSaved-=4;
+
+  if(_spanLast)
+    _stats.SpanNibblesSaved+=_record.Width*4;
+}
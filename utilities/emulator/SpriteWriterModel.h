@@ -0,0 +1,143 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Clock-accurate model of sprite_writer.vhdl. The state machine is stepped once per 100MHz
+ * cycle with the same registers, flags and pipelined adders as the VHDL so that the clipping
+ * and repeat behaviour, including its quirks, and the cycle count both match the hardware.
+ * The pass is abandoned if it's still running when the frame index flips back to zero.
+ * Persistent sprites are marked as drawn in the BRAM and skipped after that unless the viewport
+ * offset has changed. A mirrored sprite's rows go up SRAM from its bottom row. An indexed sprite
+ * reads two nibbles per pixel instead of four and looks them up in the palette. A span sprite's
+ * headers take a pixel's place in the loop and move the position on past the transparent pixels
+ * that aren't in flash.
+ */
+
+class SpriteWriterModel {
+
+  public:
+
+    /*
+     * Statistics for one pass through the BRAM
+     */
+
+    struct Statistics {
+      uint32_t Cycles;
+      uint32_t RecordsRead;
+      uint32_t VisibleSprites;
+      uint32_t PersistentSkipped;
+      uint32_t SpriteCopies;
+      uint32_t PixelsRead;
+      uint32_t PixelsWritten;
+      uint32_t FlashNibbles;
+      uint32_t SpanHeaders;
+      uint32_t SpanNibblesSaved;    // nibbles that span sprites would have read as plain sprites
+      bool Overrun;
+    };
+
+  protected:
+
+    enum State {
+      IDLE,
+      BRAM_0,BRAM_1,BRAM_2,
+      OUTER_SETUP_0,OUTER_SETUP_1,
+      CMD_7,CMD_6,CMD_5,CMD_4,CMD_3,CMD_2,CMD_1,CMD_0,
+      ADDR_5,ADDR_4,ADDR_3,ADDR_2,ADDR_1,ADDR_0,
+      MODE_1,MODE_0,
+      DUMMY_4,DUMMY_3,DUMMY_2,DUMMY_1,DUMMY_0,
+      DATA_OUT_PAUSE0,DATA_OUT_PAUSE1,
+      FIRST_PIXEL_READ_0,FIRST_PIXEL_READ_1,FIRST_PIXEL_READ_2,FIRST_PIXEL_READ_3,
+      PIXEL_READ_0,PIXEL_READ_1,PIXEL_READ_2,PIXEL_READ_3,
+      LAST_PIXEL_WRITE_0,LAST_PIXEL_WRITE_1,LAST_PIXEL_WRITE_2,
+      DONE_THIS_SPRITE_0,DONE_THIS_SPRITE_1,DONE_THIS_SPRITE_2,
+      NEXT_SPRITE
+    };
+
+    enum {
+      TRANSPARENT = 0x1ff8,
+      ROW_BYTES   = 720           // 360*2 = next row in SRAM
+    };
+
+    SpriteMemory& _bram;
+    const PaletteMemory& _palette;
+    const FlashModel& _flash;
+    SramModel& _sram;
+
+    State _state;
+    bool _frameIndex;
+    uint32_t _viewportOffset;
+    bool _redraw;
+    uint16_t _lastSprite;
+    uint16_t _spriteNumber;
+    SpriteRecord _record;
+
+    uint32_t _sramOrg;
+    uint32_t _sramNextX;
+    uint32_t _sramAddr;
+    uint32_t _sramAdderSum;
+    uint32_t _sramRowUp;
+    uint16_t _nextx;
+    uint16_t _nextxAdderSum;
+
+    uint16_t _spriteWidth;
+    uint32_t _spriteSize;
+    uint16_t _repeatY;
+    uint16_t _lastPixel;
+    uint16_t _pixel;
+    uint8_t _paletteAddr;
+    uint8_t _spanRun;
+    bool _spanLast;
+    bool _spanSlot;
+    bool _firstInColumn;
+    bool _xok,_yok,_xokReset;
+    uint16_t _x,_xorg,_y;
+    uint64_t _nibble;
+
+    Statistics _stats;
+
+  protected:
+    void step();
+    void writeSram(uint8_t data);
+    uint8_t readFlash();
+    void spanHeader(uint16_t header);
+
+  public:
+    SpriteWriterModel(SpriteMemory& bram,const PaletteMemory& palette,const FlashModel& flash,SramModel& sram);
+
+    const Statistics& run(uint32_t cyclesUntilFrameFlip,uint32_t viewportOffset,uint16_t lastSprite);
+    const Statistics& getStatistics() const;
+};
+
+
+/*
+ * Get the statistics for the last run
+ */
+
+inline const SpriteWriterModel::Statistics& SpriteWriterModel::getStatistics() const {
+  return _stats;
+}
+
+
+/*
+ * Write the current data byte to SRAM at the current address
+ */
+
+inline void SpriteWriterModel::writeSram(uint8_t data) {
+  _sram.Data[_sramAddr & SramModel::BYTE_ADDR_MASK]=data;
+}
+
+
+/*
+ * Clock the next nibble off the flash IO bus
+ */
+
+inline uint8_t SpriteWriterModel::readFlash() {
+  _stats.FlashNibbles++;
+  return _flash.readNibble(_nibble++);
+}
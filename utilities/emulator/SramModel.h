@@ -0,0 +1,25 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * The 512Kb byte-addressed frame buffer SRAM. The sprite writer fills it and the frame
+ * writer copies it out to the LCD. It is never cleared.
+ */
+
+struct SramModel {
+
+  enum {
+    SIZE = 524288,
+    BYTE_ADDR_MASK = SIZE-1       // 19 bits
+  };
+
+  std::vector<uint8_t> Data;
+
+  SramModel() : Data(SIZE,0) {}
+};
@@ -0,0 +1,535 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#include "Emulator.h"
+#include "Application.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <unistd.h>
+
+
+/**
+ * The emulator runs the unmodified manic_knights World against a host model of the FPGA
+ * so that the game logic can be benchmarked and regression tested on Linux. Each frame
+ * goes through the same sequence as the hardware:
+ *
+ *   1. The sprite writer draws the BRAM sprite list into SRAM (BUSY high). Meanwhile the
+ *      World is updated and the next frame's commands are queued and committed.
+ *   2. The BUSY falling edge interrupt drains the command queue to mcu_interface (BUSY low).
+ *   3. The frame writer copies SRAM to the LCD.
+ *
+ * The firmware's FrameScheduler sees the BUSY edges through the host EXTI stand-in and runs
+ * its phase callbacks when the harness dispatches it.
+ *
+ * Usage: ase_emulator [-f frames] [-s script] [-p ppm-dir] [-c csv-file] [-b fixed|tracked|merged]
+ *                     [-r checksum-file] [-v checksum-file] [-t] [-B cycles] [-o frame]
+ *                     <spiflash/index.txt>
+ *
+ *   -f  number of frames to run (default 300)
+ *   -s  button script, see ButtonScript.h (default: no buttons)
+ *   -p  write each displayed frame as <ppm-dir>/frame_NNNNN.ppm
+ *   -c  write per-frame statistics as CSV
+ *   -b  background slot assignment, see Background::ScrollMode (default tracked)
+ *   -r  record the per-frame checksums
+ *   -v  verify the per-frame checksums against a recording. The exit code is 1 on mismatch.
+ *   -t  print the World's frame profile at the end. Times are host times.
+ *   -B  the sprite writer budget for actor admission, see AseSpriteBudget
+ *   -o  the frame counter of the first frame, e.g. 16776900 to run across the FrameTime wrap
+ */
+
+class AseEmulatorRun {
+
+  protected:
+    struct Options {
+      uint32_t Frames;
+      const char *Script;
+      const char *PpmDir;
+      const char *CsvFile;
+      const char *RecordFile;
+      const char *VerifyFile;
+      const char *IndexFile;
+      Background::ScrollMode ScrollMode;
+      bool Profile;
+      uint32_t Budget;
+      uint32_t FirstFrame;
+    };
+
+    /*
+     * What the phase callbacks need
+     */
+
+    struct Frame {
+      World *TheWorld;
+      Panel *ThePanel;
+      Buttons *TheButtons;
+      uint32_t Number;
+      bool Overflow;
+      bool Prepared;
+      uint32_t LateFrames;
+      std::chrono::steady_clock::duration UpdateTime;
+    };
+
+    Options _options;
+    AseEmulator _emulator;
+    ButtonScript _buttons;
+    std::map<uint32_t,uint32_t> _expected;
+
+  protected:
+    void usage() const;
+    bool parseOptions(int argc,char *argv[]);
+    bool readExpected();
+
+    static void prepareFrame(Frame& frame);
+    static void onBusyStart(void *context);
+    static void onBusyFalling(void *context);
+    static void onBusyEnd(void *context);
+
+  public:
+    int run(int argc,char *argv[]);
+};
+
+
+/*
+ * Show the usage text
+ */
+
+void AseEmulatorRun::usage() const {
+  fputs("usage: ase_emulator [-f frames] [-s script] [-p ppm-dir] [-c csv-file] [-b fixed|tracked|merged]\n"
+        "                    [-r checksum-file] [-v checksum-file] [-t] [-B cycles] [-o frame]\n"
+        "                    <spiflash/index.txt>\n",stderr);
+}
+
+
+/*
+ * Parse the command line
+ */
+
+bool AseEmulatorRun::parseOptions(int argc,char *argv[]) {
+
+  int opt;
+
+  memset(&_options,0,sizeof(_options));
+  _options.Frames=300;
+  _options.ScrollMode=Background::TRACKED_SLOTS;
+  _options.Budget=AseSpriteBudget::DEFAULT_BUDGET_CYCLES;
+
+  while((opt=getopt(argc,argv,"f:s:p:c:b:r:v:tB:o:"))!=-1) {
+
+    switch(opt) {
+
+      case 'f':
+        _options.Frames=strtoul(optarg,nullptr,10);
+        break;
+
+      case 's':
+        _options.Script=optarg;
+        break;
+
+      case 'p':
+        _options.PpmDir=optarg;
+        break;
+
+      case 'c':
+        _options.CsvFile=optarg;
+        break;
+
+      case 'b':
+        if(!strcmp(optarg,"fixed"))
+          _options.ScrollMode=Background::FIXED_SLOTS;
+        else if(!strcmp(optarg,"tracked"))
+          _options.ScrollMode=Background::TRACKED_SLOTS;
+        else if(!strcmp(optarg,"merged"))
+          _options.ScrollMode=Background::MERGED_TILES;
+        else
+          return false;
+        break;
+
+      case 'r':
+        _options.RecordFile=optarg;
+        break;
+
+      case 'v':
+        _options.VerifyFile=optarg;
+        break;
+
+      case 't':
+        _options.Profile=true;
+        break;
+
+      case 'B':
+        _options.Budget=strtoul(optarg,nullptr,10);
+        break;
+
+      case 'o':
+        _options.FirstFrame=strtoul(optarg,nullptr,10);
+        break;
+
+      default:
+        return false;
+    }
+  }
+
+  if(optind!=argc-1)
+    return false;
+
+  _options.IndexFile=argv[optind];
+
+  if(_options.Script && !_buttons.parse(_options.Script)) {
+    fprintf(stderr,"Bad button script: %s\n",_options.Script);
+    return false;
+  }
+
+  return true;
+}
+
+
+/*
+ * Read the checksum recording. Each line is "<frame> <checksum-hex>".
+ */
+
+bool AseEmulatorRun::readExpected() {
+
+  FILE *f;
+  unsigned int frame,checksum;
+
+  if((f=fopen(_options.VerifyFile,"r"))==nullptr) {
+    fprintf(stderr,"Cannot open %s\n",_options.VerifyFile);
+    return false;
+  }
+
+  while(fscanf(f,"%u %x",&frame,&checksum)==2)
+    _expected[frame]=checksum;
+
+  fclose(f);
+  return true;
+}
+
+
+/*
+ * Update the world and queue the commands without touching the bus
+ */
+
+void AseEmulatorRun::prepareFrame(Frame& frame) {
+
+  auto start=std::chrono::steady_clock::now();
+  frame.TheWorld->update(*frame.TheButtons,frame.Number);
+  frame.UpdateTime+=std::chrono::steady_clock::now()-start;
+
+  frame.TheWorld->getProfiler().record(World::Profiler::WORDS,frame.ThePanel->getCommandQueue().getWordCount());
+  frame.Overflow=!frame.ThePanel->commitCommands();
+  frame.Prepared=true;
+}
+
+
+/*
+ * BUSY_START callback: prepare the next frame while the sprite writer runs, as Introduction does
+ */
+
+void AseEmulatorRun::onBusyStart(void *context) {
+
+  Frame& frame(*static_cast<Frame *>(context));
+
+  frame.TheWorld->getProfiler().start(World::Profiler::BUSY);
+  prepareFrame(frame);
+}
+
+
+/*
+ * BUSY falling edge interrupt callback: send the committed commands
+ */
+
+void AseEmulatorRun::onBusyFalling(void *context) {
+  static_cast<Frame *>(context)->ThePanel->drainCommands();
+}
+
+
+/*
+ * BUSY_END callback: catch up on a late frame, as Introduction does
+ */
+
+void AseEmulatorRun::onBusyEnd(void *context) {
+
+  Frame& frame(*static_cast<Frame *>(context));
+  World::Profiler& profiler(frame.TheWorld->getProfiler());
+
+  profiler.stop(World::Profiler::BUSY);
+
+  if(!frame.Prepared) {
+    prepareFrame(frame);
+    frame.LateFrames++;
+  }
+
+  __disable_irq();
+  frame.ThePanel->drainCommands();
+  __enable_irq();
+
+  profiler.record(World::Profiler::FLUSH,frame.ThePanel->getDrainTicks());
+  profiler.endFrame();
+
+  frame.Prepared=false;
+}
+
+
+/*
+ * Run the emulation
+ */
+
+int AseEmulatorRun::run(int argc,char *argv[]) {
+
+  FILE *csv,*record;
+  uint32_t i,overruns,mismatches,maxBusy,maxWords,lostWrites,streamErrors,predicted,maxModelError;
+  uint32_t overBudget,fixedOverBudget,fallbacks,deferred,maxLiveSlots,maxRecords;
+  uint64_t totalBusy,totalWords,totalSaved,totalVisible,totalRecords,totalPersistent,totalFlashBytes,totalSpanSaved;
+  Frame frame;
+
+  if(!parseOptions(argc,argv)) {
+    usage();
+    return 2;
+  }
+
+  if(!_emulator.loadFlash(_options.IndexFile))
+    return 2;
+
+  if(_options.VerifyFile && !readExpected())
+    return 2;
+
+  csv=record=nullptr;
+
+  if(_options.CsvFile) {
+    if((csv=fopen(_options.CsvFile,"w"))==nullptr) {
+      fprintf(stderr,"Cannot create %s\n",_options.CsvFile);
+      return 2;
+    }
+    FrameStatistics::writeCsvHeader(csv);
+  }
+
+  if(_options.RecordFile && (record=fopen(_options.RecordFile,"w"))==nullptr) {
+    fprintf(stderr,"Cannot create %s\n",_options.RecordFile);
+    return 2;
+  }
+
+  // the access mode now talks to the emulator
+
+  AseEmulatorBus::attach(&_emulator);
+
+  // set up the panel and the world exactly as Introduction does
+
+  AseAccessMode accessMode;
+  Panel panel(accessMode);
+  World world(panel,Level1);
+  Buttons buttons;
+
+  world.getBackground().setScrollMode(_options.ScrollMode);
+  world.getBudget().setBudget(_options.Budget);
+
+  panel.setBacklight(90);
+  panel.enableSpriteMode();
+
+  // the emulator isn't busy between frames so the palette can go straight in
+
+  accessMode.loadPalette(PathPalette,0,PATH_PALETTE_COUNT);
+
+  overruns=mismatches=maxBusy=maxWords=lostWrites=streamErrors=maxModelError=0;
+  overBudget=fixedOverBudget=fallbacks=deferred=maxLiveSlots=maxRecords=0;
+  totalBusy=totalWords=totalSaved=totalVisible=totalRecords=totalPersistent=totalFlashBytes=totalSpanSaved=0;
+
+  FrameScheduler scheduler;
+
+  frame.TheWorld=&world;
+  frame.ThePanel=&panel;
+  frame.TheButtons=&buttons;
+  frame.Prepared=false;
+  frame.LateFrames=0;
+  frame.UpdateTime=std::chrono::steady_clock::duration::zero();
+
+  scheduler.setCallback(FrameScheduler::BUSY_START,&AseEmulatorRun::onBusyStart,&frame);
+  scheduler.setInterruptCallback(FrameScheduler::BUSY_END,&AseEmulatorRun::onBusyFalling,&frame);
+  scheduler.setCallback(FrameScheduler::BUSY_END,&AseEmulatorRun::onBusyEnd,&frame);
+
+  for(i=0;i<_options.Frames;i++) {
+
+    // BUSY high, then the world updates when it falls
+
+    _buttons.apply(i);
+
+    frame.Number=_options.FirstFrame+i;
+    frame.Overflow=false;
+
+    // what the firmware expected this busy period to cost when it flushed the commands for it
+
+    predicted=panel.getSpriteShadow().getLastFrameStatistics().PredictedCycles;
+
+    _emulator.beginBusyPeriod();
+    scheduler.dispatch();
+
+    _emulator.endBusyPeriod();
+    scheduler.dispatch();
+
+    if(frame.Overflow)
+      fprintf(stderr,"Frame %u: command queue overflow\n",i);
+
+    // the frame writer shows the result
+
+    FrameStatistics stats(_emulator.endFrame());
+
+    // add what the firmware knows about the frame
+
+    const Panel::SpriteShadow::Statistics& shadow(panel.getSpriteShadow().getLastFrameStatistics());
+
+    stats.ShadowSkipped=shadow.Skipped;
+    stats.ShadowWordsSaved=shadow.getWordsSaved();
+    stats.PredictedCycles=predicted;
+    stats.BudgetFallbacks=world.getBudget().getStatistics().Fallbacks;
+    stats.BudgetDeferred=world.getBudget().getStatistics().Deferred;
+
+    fallbacks+=stats.BudgetFallbacks;
+    deferred+=stats.BudgetDeferred;
+
+    if(stats.SpriteWriter.Cycles>_options.Budget)
+      overBudget++;
+
+    // the next pass can't be brought under budget by the actors alone
+
+    if(world.getBudget().getStatistics().FixedCycles>_options.Budget)
+      fixedOverBudget++;
+
+    if(!stats.SpriteWriter.Overrun) {
+      uint32_t error=predicted>stats.SpriteWriter.Cycles ? predicted-stats.SpriteWriter.Cycles : stats.SpriteWriter.Cycles-predicted;
+      if(error>maxModelError)
+        maxModelError=error;
+    }
+
+    if(stats.SpriteWriter.Overrun)
+      overruns++;
+
+    totalBusy+=stats.SpriteWriter.Cycles;
+    totalVisible+=world.getActors().getVisibleCount();
+    totalRecords+=stats.SpriteWriter.RecordsRead;
+    totalPersistent+=stats.SpriteWriter.PersistentSkipped;
+    totalFlashBytes+=stats.SpriteWriter.FlashNibbles/2;
+    totalSpanSaved+=stats.SpriteWriter.SpanNibblesSaved/2;
+
+    if(stats.SpriteWriter.RecordsRead>maxRecords)
+      maxRecords=stats.SpriteWriter.RecordsRead;
+
+    if(world.getActors().getSlotAllocator().getLiveCount()>maxLiveSlots)
+      maxLiveSlots=world.getActors().getSlotAllocator().getLiveCount();
+    totalWords+=stats.Mcu.BusWords;
+    totalSaved+=stats.ShadowWordsSaved;
+    lostWrites+=stats.Mcu.LostWrites;
+    streamErrors+=stats.StreamErrors;
+
+    if(stats.SpriteWriter.Cycles>maxBusy)
+      maxBusy=stats.SpriteWriter.Cycles;
+
+    if(stats.Mcu.BusWords>maxWords)
+      maxWords=stats.Mcu.BusWords;
+
+    if(csv)
+      stats.writeCsv(csv);
+
+    if(record)
+      fprintf(record,"%u %08x\n",i,stats.Checksum);
+
+    if(_options.VerifyFile) {
+      auto it=_expected.find(i);
+      if(it!=_expected.end() && it->second!=stats.Checksum) {
+        if(mismatches++==0)
+          fprintf(stderr,"Frame %u: checksum %08x, expected %08x\n",i,stats.Checksum,it->second);
+      }
+    }
+
+    if(_options.PpmDir) {
+      char filename[32];
+      sprintf(filename,"/frame_%05u.ppm",i);
+
+      if(!PpmWriter::write(
+          std::string(_options.PpmDir)+filename,
+          _emulator.getFrameWriter().getFrame(),
+          FrameWriterModel::WIDTH,
+          FrameWriterModel::HEIGHT)) {
+        fprintf(stderr,"Cannot write %s%s\n",_options.PpmDir,filename);
+        return 2;
+      }
+    }
+  }
+
+  if(csv)
+    fclose(csv);
+
+  if(record)
+    fclose(record);
+
+  // summary
+
+  if(_options.Frames) {
+
+    printf("frames:            %u\n",_options.Frames);
+    printf("busy cycles:       mean %llu, max %u (budget %u)\n",
+        static_cast<unsigned long long>(totalBusy/_options.Frames),maxBusy,static_cast<uint32_t>(AseEmulator::TE_CYCLES));
+    printf("overruns:          %u\n",overruns);
+    printf("cost model:        max error %u cycles\n",maxModelError);
+    printf("budget:            %u cycles, %u frames over (%u by the background alone), %u fallbacks, %u deferred\n",
+        _options.Budget,overBudget,fixedOverBudget,fallbacks,deferred);
+    printf("bus words:         mean %llu, max %u\n",static_cast<unsigned long long>(totalWords/_options.Frames),maxWords);
+    printf("shadow words saved: mean %llu\n",static_cast<unsigned long long>(totalSaved/_options.Frames));
+    printf("lost BRAM writes:  %u\n",lostWrites);
+    printf("stream errors:     %u\n",streamErrors);
+    FrameScheduler::Statistics schedulerStats(scheduler.getStatistics());
+
+    printf("scheduler:         %u frames, %u busy overruns, %u work overruns, %u missed, %u late\n",
+        schedulerStats.Frames,schedulerStats.BusyOverruns,schedulerStats.WorkOverruns,schedulerStats.MissedFrames,frame.LateFrames);
+    printf("world update:      %.3f us/frame (host)\n",
+        std::chrono::duration<double,std::micro>(frame.UpdateTime).count()/_options.Frames);
+
+    printf("actors:            %u in the level, mean %.1f in range\n",
+        world.getActors().getActorCount(),static_cast<double>(totalVisible)/_options.Frames);
+
+    const SpriteSlotAllocator::Statistics& slots(world.getActors().getSlotAllocator().getStatistics());
+
+    printf("sprite slots:      %u allocations (%u got their old slot back), %u relocations, %u failures, max %u live\n",
+        slots.Allocations,slots.Reused,slots.Relocations,slots.Failures,maxLiveSlots);
+
+    // every record that isn't read is 4 cycles more for copying pixels
+
+    printf("active range:      mean %.1f records read, max %u, %.0f cycles/frame saved on the full scan\n",
+        static_cast<double>(totalRecords)/_options.Frames,maxRecords,
+        static_cast<double>(SpriteMemory::NUM_SPRITES*_options.Frames-totalRecords)*AseSpriteCost::RECORD_CYCLES/_options.Frames);
+
+    printf("persistent:        mean %.1f drawn sprites skipped\n",static_cast<double>(totalPersistent)/_options.Frames);
+    printf("flash:             mean %.0f bytes read per frame, %.0f without span encoding\n",
+        static_cast<double>(totalFlashBytes)/_options.Frames,
+        static_cast<double>(totalFlashBytes+totalSpanSaved)/_options.Frames);
+
+    uint16_t curves;
+    uint32_t easingBytes=world.getActors().getEasingFlashBytes(curves);
+
+    printf("easing tables:     %u curves, %u bytes of flash\n",curves,easingBytes);
+  }
+
+  if(_options.Profile)
+    world.getProfiler().dump(std::cout);
+
+  if(_options.VerifyFile) {
+    printf("checksum mismatches: %u\n",mismatches);
+    return mismatches ? 1 : 0;
+  }
+
+  return 0;
+}
+
+
+/*
+ * Main entry point
+ */
+
+int main(int argc,char *argv[]) {
+
+  AseEmulatorRun run;
+  return run.run(argc,argv);
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+namespace stm32plus {
+  namespace display {
+
+    /*
+     * A point on the display or in the world
+     */
+
+    struct Point {
+
+      int16_t X;
+      int16_t Y;
+
+      Point() {}
+      Point(int16_t x,int16_t y) : X(x),Y(y) {}
+
+      bool operator==(const Point& p) const {
+        return X==p.X && Y==p.Y;
+      }
+
+      bool operator!=(const Point& p) const {
+        return !(*this==p);
+      }
+    };
+
+
+    /*
+     * R61523 command constants referenced by the firmware
+     */
+
+    namespace r61523 {
+      enum {
+        MEMORY_WRITE            = 0x2c,
+        SET_FRAME_AND_INTERFACE = 0xb3,
+        NORMAL_DISPLAY_TIMING   = 0xc1
+      };
+    }
+
+
+    /*
+     * Gamma curve holder
+     */
+
+    class R61523Gamma {
+      public:
+        R61523Gamma(const uint8_t * /* levels */) {}
+    };
+
+
+    /*
+     * The R61523 panel. Only the calls that the ASE firmware makes before switching to sprite
+     * mode are provided and they write the LCD commands through the access mode in passthrough.
+     */
+
+    template<class TAccessMode>
+    class R61523_Portrait_64K_TypeB {
+
+      protected:
+        TAccessMode& _accessMode;
+
+      public:
+        enum TearingEffectMode {
+          TE_VBLANK,
+          TE_VBLANK_HBLANK
+        };
+
+      public:
+        R61523_Portrait_64K_TypeB(TAccessMode& accessMode) : _accessMode(accessMode) {}
+
+        void applyGamma(const R61523Gamma& /* gamma */) {}
+        void enableTearingEffect(TearingEffectMode /* mode */) {}
+        void moveTo(int16_t /* x1 */,int16_t /* y1 */,int16_t /* x2 */,int16_t /* y2 */) {}
+
+        void beginWriting() const {
+          _accessMode.writeCommand(r61523::MEMORY_WRITE);
+        }
+
+        int16_t getWidth() const { return 360; }
+        int16_t getHeight() const { return 640; }
+    };
+
+
+    /*
+     * PWM backlight driven by the panel
+     */
+
+    template<class TAccessMode>
+    class R61523PwmBacklight {
+      public:
+        R61523PwmBacklight(TAccessMode& /* accessMode */) {}
+        void setPercentage(uint8_t /* percentage */) {}
+    };
+  }
+}
@@ -0,0 +1,121 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+#include <functional>
+#include <vector>
+
+
+/*
+ * The ST standard peripheral library EXTI types
+ */
+
+typedef enum {
+  EXTI_Mode_Interrupt = 0x00,
+  EXTI_Mode_Event = 0x04
+} EXTIMode_TypeDef;
+
+typedef enum {
+  EXTI_Trigger_Rising = 0x08,
+  EXTI_Trigger_Falling = 0x0C,
+  EXTI_Trigger_Rising_Falling = 0x10
+} EXTITrigger_TypeDef;
+
+
+namespace stm32plus {
+
+  /*
+   * Subscriber to an EXTI interrupt
+   */
+
+  class ExtiInterruptEventSourceSlot {
+
+    protected:
+      std::function<void(uint8_t)> _function;
+
+    public:
+      template<class T>
+      static ExtiInterruptEventSourceSlot bind(T *object,void (T::*method)(uint8_t)) {
+        ExtiInterruptEventSourceSlot slot;
+        slot._function=[object,method](uint8_t line) { (object->*method)(line); };
+        return slot;
+      }
+
+      void operator()(uint8_t line) const {
+        _function(line);
+      }
+  };
+
+
+  /*
+   * The list of subscribers to an EXTI interrupt
+   */
+
+  class ExtiInterruptEventSource {
+
+    protected:
+      std::vector<ExtiInterruptEventSourceSlot> _slots;
+
+    public:
+      void insertSubscriber(const ExtiInterruptEventSourceSlot& slot) {
+        _slots.push_back(slot);
+      }
+
+      void raiseEvent(uint8_t line) const {
+        for(const auto& slot : _slots)
+          slot(line);
+      }
+  };
+
+
+  /*
+   * Host EXTI lines. The harness calls raise() after it changes a pin that has an EXTI
+   * peripheral attached and the subscribers are called immediately, as if from the IRQ.
+   */
+
+  struct HostExti {
+
+    static ExtiInterruptEventSource *& line(uint8_t number) {
+      static ExtiInterruptEventSource *lines[16];
+      return lines[number];
+    }
+
+    static void raise(uint8_t number) {
+      if(line(number))
+        line(number)->raiseEvent(number);
+    }
+  };
+
+
+  /*
+   * An EXTI line attached to a GPIO pin. The mode, trigger and pin are not modelled, the
+   * harness decides when to raise the interrupt.
+   */
+
+  template<uint8_t TLine>
+  class ExtiPeripheral {
+
+    public:
+      ExtiInterruptEventSource ExtiInterruptEventSender;
+
+    private:
+      ExtiPeripheral(const ExtiPeripheral&);
+      ExtiPeripheral& operator=(const ExtiPeripheral&);
+
+    public:
+      ExtiPeripheral(EXTIMode_TypeDef /* mode */,EXTITrigger_TypeDef /* trigger */,const GpioPinRef& /* pin */) {
+        HostExti::line(TLine)=&ExtiInterruptEventSender;
+      }
+
+      ~ExtiPeripheral() {
+        HostExti::line(TLine)=nullptr;
+      }
+  };
+
+  typedef ExtiPeripheral<14> Exti14;
+}
@@ -0,0 +1,39 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+namespace stm32plus {
+
+  /*
+   * Minimal single-owner pointer
+   */
+
+  template<class T>
+  class scoped_ptr {
+
+    protected:
+      T *_ptr;
+
+    private:
+      scoped_ptr(const scoped_ptr&);
+      scoped_ptr& operator=(const scoped_ptr&);
+
+    public:
+      explicit scoped_ptr(T *ptr=nullptr) : _ptr(ptr) {}
+      ~scoped_ptr() { delete _ptr; }
+
+      void reset(T *ptr=nullptr) {
+        delete _ptr;
+        _ptr=ptr;
+      }
+
+      T& operator*() const { return *_ptr; }
+      T *operator->() const { return _ptr; }
+      T *get() const { return _ptr; }
+  };
+}
@@ -0,0 +1,186 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+/*
+ * Host stand-in for the parts of stm32plus used by the ASE firmware. This is just enough of the
+ * library for the common access mode and the manic_knights world code to compile on Linux.
+ * GPIO pins are backed by a state table that the emulator harness can read and write.
+ */
+
+#include <cstdint>
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+
+
+/*
+ * The subset of the ST standard peripheral library types and constants that we reference
+ */
+
+typedef struct {
+  volatile uint32_t MODER;
+  volatile uint32_t OTYPER;
+  volatile uint32_t OSPEEDR;
+  volatile uint32_t PUPDR;
+  volatile uint32_t IDR;
+  volatile uint32_t ODR;
+  volatile uint16_t BSRRL;
+  volatile uint16_t BSRRH;
+  volatile uint32_t LCKR;
+  volatile uint32_t AFR[2];
+} GPIO_TypeDef;
+
+typedef enum {
+  GPIO_Speed_2MHz,
+  GPIO_Speed_25MHz,
+  GPIO_Speed_50MHz,
+  GPIO_Speed_100MHz
+} GPIOSpeed_TypeDef;
+
+enum {
+  GPIOA_BASE = 0x40020000,
+  GPIOB_BASE = 0x40020400,
+  GPIOC_BASE = 0x40020800,
+  GPIOD_BASE = 0x40020C00,
+  GPIOE_BASE = 0x40021000
+};
+
+#define GPIOE ((GPIO_TypeDef *)static_cast<uintptr_t>(GPIOE_BASE))
+
+enum {
+  GPIO_Pin_0  = 0x0001, GPIO_Pin_1  = 0x0002, GPIO_Pin_2  = 0x0004, GPIO_Pin_3  = 0x0008,
+  GPIO_Pin_4  = 0x0010, GPIO_Pin_5  = 0x0020, GPIO_Pin_6  = 0x0040, GPIO_Pin_7  = 0x0080,
+  GPIO_Pin_8  = 0x0100, GPIO_Pin_9  = 0x0200, GPIO_Pin_10 = 0x0400, GPIO_Pin_11 = 0x0800,
+  GPIO_Pin_12 = 0x1000, GPIO_Pin_13 = 0x2000, GPIO_Pin_14 = 0x4000, GPIO_Pin_15 = 0x8000
+};
+
+inline void GPIO_Write(GPIO_TypeDef * /* port */,uint16_t /* value */) {
+}
+
+
+/*
+ * CMSIS core intrinsics. There's only one thread on the host and interrupts are delivered
+ * synchronously by the harness so these have nothing to do.
+ */
+
+inline void __disable_irq() {
+}
+
+inline void __enable_irq() {
+}
+
+inline void __WFI() {
+}
+
+
+namespace stm32plus {
+
+  /*
+   * Port indices into the host pin table
+   */
+
+  enum {
+    HOST_PORTA = 0,
+    HOST_PORTB = 1,
+    HOST_PORTC = 2,
+    HOST_PORTD = 3,
+    HOST_PORTE = 4
+  };
+
+
+  /*
+   * The host pin table. The harness sets input pins (e.g. the buttons) here
+   * and can observe the state of output pins.
+   */
+
+  struct HostGpio {
+    static bool& pin(uint8_t port,uint8_t pin) {
+      static bool pins[5][16];
+      return pins[port][pin];
+    }
+  };
+
+
+  /*
+   * Gpio modes
+   */
+
+  struct Gpio {
+
+    enum GpioModeType {
+      INPUT,
+      OUTPUT,
+      ALTERNATE_FUNCTION,
+      ANALOG
+    };
+
+    enum GpioPullUpDownType {
+      PUPD_NONE,
+      PUPD_UP,
+      PUPD_DOWN
+    };
+  };
+
+
+  /*
+   * Reference to a single pin
+   */
+
+  class GpioPinRef {
+
+    protected:
+      uint8_t _port;
+      uint8_t _pin;
+
+    public:
+      GpioPinRef() : _port(0),_pin(0) {}
+      GpioPinRef(uint8_t port,uint8_t pin) : _port(port),_pin(pin) {}
+
+      bool read() const { return HostGpio::pin(_port,_pin); }
+      void set() const { HostGpio::pin(_port,_pin)=true; }
+      void reset() const { HostGpio::pin(_port,_pin)=false; }
+      void setState(bool state) const { HostGpio::pin(_port,_pin)=state; }
+  };
+
+
+  /*
+   * Port features carry no state on the host
+   */
+
+  template<uint8_t... TPins> struct DefaultDigitalInputFeature {};
+  template<uint8_t... TPins> struct DefaultDigitalOutputFeature {};
+  template<GPIOSpeed_TypeDef TSpeed,Gpio::GpioPullUpDownType TPupd,uint8_t... TPins> struct DigitalInputFeature {};
+
+
+  /*
+   * A port hands out pin references into the host table
+   */
+
+  template<uint8_t TPort>
+  struct HostGpioPort {
+    GpioPinRef operator[](uint8_t pin) const {
+      return GpioPinRef(TPort,pin);
+    }
+  };
+
+  template<class... Features> struct GpioA : HostGpioPort<HOST_PORTA> {};
+  template<class... Features> struct GpioB : HostGpioPort<HOST_PORTB> {};
+  template<class... Features> struct GpioC : HostGpioPort<HOST_PORTC> {};
+  template<class... Features> struct GpioD : HostGpioPort<HOST_PORTD> {};
+  template<class... Features> struct GpioE : HostGpioPort<HOST_PORTE> {};
+
+
+  /*
+   * Direct pin initialisation is a no-op
+   */
+
+  struct GpioPinInitialiser {
+    static void initialise(GPIO_TypeDef * /* port */,uint32_t /* pins */,Gpio::GpioModeType /* mode */) {}
+  };
+}
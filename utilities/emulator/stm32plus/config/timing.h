@@ -0,0 +1,42 @@
+/*
+ * This file is a part of the firmware supplied with Andy's Workshop Sprite Engine (ASE)
+ * Copyright (c) 2014 Andy Brown <www.andybrown.me.uk>
+ * Please see website for licensing terms.
+ */
+
+#pragma once
+
+
+namespace stm32plus {
+
+  /*
+   * Host millisecond timer. Time only moves forward when the firmware delays
+   * or when the emulator harness advances it by a frame period.
+   */
+
+  class MillisecondTimer {
+
+    protected:
+      static uint32_t& counter() {
+        static uint32_t value;
+        return value;
+      }
+
+    public:
+      static void initialise() {
+        counter()=0;
+      }
+
+      static void delay(uint32_t millis) {
+        counter()+=millis;
+      }
+
+      static uint32_t millis() {
+        return counter();
+      }
+
+      static bool hasTimedOut(uint32_t start,uint32_t timeout) {
+        return millis()-start>timeout;
+      }
+  };
+}